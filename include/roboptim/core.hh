@@ -28,32 +28,52 @@
 
 // Main headers.
 # include <roboptim/core/result-with-warnings.hh>
+# include <roboptim/core/banded-quadratic-function.hh>
+# include <roboptim/core/batch-solver.hh>
+# include <roboptim/core/cancellation-token.hh>
 # include <roboptim/core/constant-function.hh>
+# include <roboptim/core/constraints-evaluator.hh>
 # include <roboptim/core/derivable-function.hh>
 # include <roboptim/core/derivable-parametrized-function.hh>
+# include <roboptim/core/diagonal-quadratic-function.hh>
 # include <roboptim/core/finite-difference-gradient.hh>
 # include <roboptim/core/function.hh>
 # include <roboptim/core/generic-solver.hh>
 # include <roboptim/core/identity-function.hh>
 # include <roboptim/core/indent.hh>
 # include <roboptim/core/linear-function.hh>
+# include <roboptim/core/low-rank-quadratic-function.hh>
+# include <roboptim/core/multi-start.hh>
 # include <roboptim/core/n-times-derivable-function.hh>
 # include <roboptim/core/numeric-linear-function.hh>
 # include <roboptim/core/numeric-quadratic-function.hh>
+# include <roboptim/core/parameter-schema.hh>
 # include <roboptim/core/parametrized-function.hh>
+# include <roboptim/core/plugin-registry.hh>
+# include <roboptim/core/presolve.hh>
 # include <roboptim/core/problem.hh>
 # include <roboptim/core/quadratic-function.hh>
 # include <roboptim/core/result.hh>
+# include <roboptim/core/scaling.hh>
+# include <roboptim/core/serialization.hh>
 # include <roboptim/core/solver-error.hh>
 # include <roboptim/core/solver-factory.hh>
+# include <roboptim/core/solver-state.hh>
 # include <roboptim/core/solver-warning.hh>
 # include <roboptim/core/solver.hh>
+# include <roboptim/core/sparse-numeric-linear-function.hh>
+# include <roboptim/core/sparse-quadratic-function.hh>
+# include <roboptim/core/thread-pool.hh>
 # include <roboptim/core/twice-derivable-function.hh>
 # include <roboptim/core/util.hh>
+# include <roboptim/core/warm-start.hh>
 
 
 // Filters.
+# include <roboptim/core/filter/algebra.hh>
 # include <roboptim/core/filter/cached-function.hh>
+# include <roboptim/core/filter/chain.hh>
+# include <roboptim/core/filter/restriction.hh>
 
 
 // Visualization.
@@ -0,0 +1,94 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_BANDED_QUADRATIC_FUNCTION_HH
+# define ROBOPTIM_CORE_BANDED_QUADRATIC_FUNCTION_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <roboptim/core/quadratic-function.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_function
+  /// @{
+
+  /// \brief Quadratic function with a symmetric banded matrix.
+  ///
+  /// Implement a quadratic function using the formula:
+  /// \f[f(x) = \frac{1}{2} x^t A x + b^t x\f]
+  /// where \f$A\f$ is symmetric and \f$A_{ij} = 0\f$ if
+  /// \f$|i - j| > k\f$ (\f$k\f$: bandwidth).
+  ///
+  /// Only the lower band is stored, one diagonal per column: the
+  /// \f$(n, k + 1)\f$ bands matrix is such that
+  /// \f$bands (i, j) = A_{i + j, i}\f$ for \f$i < n - j\f$ (the last
+  /// \f$j\f$ coefficients of the column \f$j\f$ are ignored).
+  /// Storage and kernels are \f$O(n k)\f$.
+  class ROBOPTIM_DLLAPI BandedQuadraticFunction : public QuadraticFunction
+  {
+  public:
+    /// \brief Build a quadratic function from a band storage and a vector.
+    ///
+    /// See class documentation for the band storage.
+    /// \param bands lower band of the matrix, one diagonal per column
+    /// \param b b vector
+    BandedQuadraticFunction (const matrix_t& bands, const vector_t& b)
+      throw ();
+
+    ~BandedQuadraticFunction () throw ();
+
+    /// \brief Lower band of the matrix, one diagonal per column.
+    const matrix_t& bands () const throw ();
+
+    /// \brief Bandwidth (number of sub-diagonals).
+    size_type bandwidth () const throw ();
+
+    /// \brief b vector.
+    const vector_t& b () const throw ();
+
+    /// \brief Display the function on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    virtual std::ostream& print (std::ostream&) const throw ();
+
+  protected:
+    void impl_compute (result_t& , const argument_t&) const throw ();
+    void impl_gradient (gradient_t&, const argument_t&, size_type = 0)
+      const throw ();
+    void impl_hessian (hessian_t& hessian,
+		       const argument_t& argument,
+		       size_type functionId = 0) const throw ();
+  private:
+    /// \brief Compute y = A x.
+    void multiply (vector_t& y, const argument_t& x) const throw ();
+
+    /// \brief Lower band.
+    matrix_t bands_;
+    /// \brief B vector.
+    vector_t b_;
+    /// \brief buffer to avoid allocating during computation.
+    mutable vector_t buffer_;
+  };
+
+  /// @}
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_BANDED_QUADRATIC_FUNCTION_HH
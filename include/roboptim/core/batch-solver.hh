@@ -0,0 +1,153 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_BATCH_SOLVER_HH
+# define ROBOPTIM_CORE_BATCH_SOLVER_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <stdexcept>
+# include <string>
+# include <vector>
+
+# include <boost/function.hpp>
+# include <boost/shared_ptr.hpp>
+# include <boost/static_assert.hpp>
+# include <boost/type_traits/is_base_of.hpp>
+
+# include <roboptim/core/fwd.hh>
+# include <roboptim/core/generic-solver.hh>
+# include <roboptim/core/solver-factory.hh>
+# include <roboptim/core/thread-pool.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_solver
+  /// @{
+
+  /// \brief Solve many independent problems concurrently.
+  ///
+  /// Each problem is solved by its own solver instance, created by a
+  /// SolverFactory from the plug-in. Problems are split in contiguous
+  /// chunks which are solved by the thread pool workers, results are
+  /// collected in the problems order.
+  ///
+  /// The plug-in is loaded once and kept loaded during the whole
+  /// batch (see PluginRegistry), so creating a solver per problem
+  /// does not touch libltdl.
+  ///
+  /// \warning Problems are solved concurrently: their functions must
+  /// not share unprotected mutable state.
+  ///
+  /// \tparam S solver type
+  template <typename S>
+  class BatchSolver
+  {
+    BOOST_STATIC_ASSERT((boost::is_base_of<GenericSolver, S>::value));
+  public:
+    /// \brief Solver type.
+    typedef S solver_t;
+    /// \brief Problem type.
+    typedef typename solver_t::problem_t problem_t;
+    /// \brief Problems list type.
+    typedef std::vector<problem_t> problems_t;
+    /// \brief Result type.
+    typedef GenericSolver::result_t result_t;
+    /// \brief Results list type.
+    typedef std::vector<result_t> results_t;
+    /// \brief Solver parameters type.
+    typedef typename solver_t::parameters_t parameters_t;
+    /// \brief Solver setup function type.
+    ///
+    /// Called with each solver and the index of its problem before
+    /// the problem is solved (warm start, callback...).
+    typedef boost::function<void (solver_t&, std::size_t)> setup_t;
+
+    /// \brief Build a batch solver.
+    ///
+    /// \param plugin solver plug-in name
+    /// \param pool thread pool solving the problems, problems are
+    /// solved sequentially if the pointer is null. The pool can be
+    /// shared with other clients: only the batch tasks are waited
+    /// for, see TaskGroup.
+    explicit BatchSolver (const std::string& plugin,
+			  boost::shared_ptr<ThreadPool> pool =
+			  boost::shared_ptr<ThreadPool> ()) throw ();
+    ~BatchSolver () throw ();
+
+    /// \brief Solver plug-in name.
+    const std::string& plugin () const throw ();
+
+    /// \brief Retrieve the thread pool (null in sequential mode).
+    const boost::shared_ptr<ThreadPool>& threadPool () const throw ();
+
+    /// \brief Parameters overriding the solvers default values.
+    ///
+    /// Only the values are copied, parameters unknown to the solver
+    /// are ignored.
+    parameters_t& parameters () throw ();
+
+    /// \brief Parameters overriding the solvers default values.
+    const parameters_t& parameters () const throw ();
+
+    /// \brief Set the function called on each solver before solving.
+    ///
+    /// \warning In parallel mode, the function is called concurrently.
+    void setSetup (const setup_t& setup) throw ();
+
+    /// \brief Solve all the problems.
+    ///
+    /// \param problems problems to be solved
+    /// \return results, in the problems order
+    /// \throw std::runtime_error if the plug-in cannot be loaded
+    results_t solve (const problems_t& problems) throw (std::runtime_error);
+
+    /// \brief Solve all the problems.
+    ///
+    /// \param results results, in the problems order (resized)
+    /// \param problems problems to be solved
+    /// \throw std::runtime_error if the plug-in cannot be loaded
+    void solve (results_t& results, const problems_t& problems)
+      throw (std::runtime_error);
+
+  private:
+    /// \brief Solve the problems in [begin, end).
+    ///
+    /// Errors raised while creating a solver are stored as
+    /// SolverError results.
+    void solveRange (results_t* results,
+		     const problems_t* problems,
+		     std::size_t begin,
+		     std::size_t end) const throw ();
+
+    /// \brief Solver plug-in name.
+    std::string plugin_;
+    /// \brief Thread pool (parallel mode only).
+    boost::shared_ptr<ThreadPool> pool_;
+    /// \brief Parameters overrides.
+    parameters_t parameters_;
+    /// \brief Solver setup function (may be empty).
+    setup_t setup_;
+  };
+
+  /// @}
+
+} // end of namespace roboptim
+
+# include <roboptim/core/batch-solver.hxx>
+#endif //! ROBOPTIM_CORE_BATCH_SOLVER_HH
@@ -0,0 +1,163 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_BATCH_SOLVER_HXX
+# define ROBOPTIM_CORE_BATCH_SOLVER_HXX
+# include <algorithm>
+# include <exception>
+
+# include <boost/bind.hpp>
+
+# include <roboptim/core/plugin-registry.hh>
+
+namespace roboptim
+{
+  template <typename S>
+  BatchSolver<S>::BatchSolver (const std::string& plugin,
+			       boost::shared_ptr<ThreadPool> pool) throw ()
+    : plugin_ (plugin),
+      pool_ (pool),
+      parameters_ (),
+      setup_ ()
+  {
+  }
+
+  template <typename S>
+  BatchSolver<S>::~BatchSolver () throw ()
+  {
+  }
+
+  template <typename S>
+  const std::string&
+  BatchSolver<S>::plugin () const throw ()
+  {
+    return plugin_;
+  }
+
+  template <typename S>
+  const boost::shared_ptr<ThreadPool>&
+  BatchSolver<S>::threadPool () const throw ()
+  {
+    return pool_;
+  }
+
+  template <typename S>
+  typename BatchSolver<S>::parameters_t&
+  BatchSolver<S>::parameters () throw ()
+  {
+    return parameters_;
+  }
+
+  template <typename S>
+  const typename BatchSolver<S>::parameters_t&
+  BatchSolver<S>::parameters () const throw ()
+  {
+    return parameters_;
+  }
+
+  template <typename S>
+  void
+  BatchSolver<S>::setSetup (const setup_t& setup) throw ()
+  {
+    setup_ = setup;
+  }
+
+  template <typename S>
+  typename BatchSolver<S>::results_t
+  BatchSolver<S>::solve (const problems_t& problems)
+    throw (std::runtime_error)
+  {
+    results_t results;
+    solve (results, problems);
+    return results;
+  }
+
+  template <typename S>
+  void
+  BatchSolver<S>::solve (results_t& results, const problems_t& problems)
+    throw (std::runtime_error)
+  {
+    results.assign (problems.size (), NoSolution ());
+    if (problems.empty ())
+      return;
+
+    // Keep the plug-in loaded during the whole batch, this also
+    // reports loading errors in the calling thread.
+    PluginRegistry& registry = PluginRegistry::instance ();
+    registry.acquire (plugin_);
+
+    if (!pool_)
+      solveRange (&results, &problems, 0, problems.size ());
+    else
+      {
+	// A few chunks per worker: large enough to amortize the
+	// scheduling cost, small enough to balance the load.
+	std::size_t chunks =
+	  std::min (problems.size (), 4 * pool_->size ());
+	TaskGroup group (*pool_);
+	for (std::size_t i = 0; i < chunks; ++i)
+	  group.submit
+	    (boost::bind (&BatchSolver<S>::solveRange, this,
+			  &results, &problems,
+			  i * problems.size () / chunks,
+			  (i + 1) * problems.size () / chunks));
+	group.wait ();
+      }
+
+    registry.release (plugin_);
+  }
+
+  template <typename S>
+  void
+  BatchSolver<S>::solveRange (results_t* results,
+			      const problems_t* problems,
+			      std::size_t begin,
+			      std::size_t end) const throw ()
+  {
+    typedef typename parameters_t::const_iterator citer_t;
+
+    for (std::size_t i = begin; i < end; ++i)
+      {
+	try
+	  {
+	    SolverFactory<solver_t> factory (plugin_, (*problems)[i]);
+	    solver_t& solver = factory ();
+
+	    for (citer_t it = parameters_.begin ();
+		 it != parameters_.end (); ++it)
+	      {
+		typename parameters_t::iterator param =
+		  solver.parameters ().find (it->first);
+		if (param != solver.parameters ().end ())
+		  param->second.value = it->second.value;
+	      }
+	    if (!setup_.empty ())
+	      setup_ (solver, i);
+
+	    (*results)[i] = solver.minimum ();
+	  }
+	catch (const std::exception& e)
+	  {
+	    (*results)[i] = SolverError (e.what ());
+	  }
+      }
+  }
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_BATCH_SOLVER_HXX
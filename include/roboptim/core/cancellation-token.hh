@@ -0,0 +1,123 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_CANCELLATION_TOKEN_HH
+# define ROBOPTIM_CORE_CANCELLATION_TOKEN_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <string>
+
+# include <boost/chrono/system_clocks.hpp>
+# include <boost/date_time/posix_time/posix_time_types.hpp>
+# include <boost/thread/mutex.hpp>
+# include <boost/utility.hpp>
+
+# include <roboptim/core/portability.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_solver
+  /// @{
+
+  /// \brief Cooperative cancellation of a solve.
+  ///
+  /// A token carries a cancellation flag and an optional deadline.
+  /// It is shared between the solver (see
+  /// GenericSolver::setCancellationToken) and the clients which may
+  /// cancel the solve from any thread. Plug-ins poll it between
+  /// iterations and user functions may poll it between evaluations:
+  /// once a stop is requested, the solve returns a SolverError
+  /// carrying the last iterate.
+  ///
+  /// Deadlines are measured with a monotonic clock so that they are
+  /// not affected by system clock adjustments. Absolute deadlines
+  /// are given in UTC and converted when they are set.
+  ///
+  /// All the methods are thread-safe.
+  class ROBOPTIM_DLLAPI CancellationToken : public boost::noncopyable
+  {
+  public:
+    /// \brief Point in time type.
+    typedef boost::posix_time::ptime deadline_t;
+    /// \brief Duration type.
+    typedef boost::posix_time::time_duration duration_t;
+
+    /// \brief Build a token without deadline.
+    CancellationToken () throw ();
+
+    /// \brief Build a token expiring after a given duration.
+    ///
+    /// \param timeout duration after which a stop is requested
+    explicit CancellationToken (const duration_t& timeout) throw ();
+
+    ~CancellationToken () throw ();
+
+    /// \brief Request the solve to stop as soon as possible.
+    void cancel () throw ();
+
+    /// \brief Has the token been cancelled?
+    bool cancelled () const throw ();
+
+    /// \brief Set the deadline (UTC).
+    ///
+    /// The remaining time is computed from the system clock once, the
+    /// deadline is then tracked by the monotonic clock.
+    void setDeadline (const deadline_t& deadline) throw ();
+
+    /// \brief Set the deadline relatively to the current time.
+    void setTimeout (const duration_t& timeout) throw ();
+
+    /// \brief Retrieve the deadline (UTC, positive infinity if none).
+    deadline_t deadline () const throw ();
+
+    /// \brief Has the deadline been exceeded?
+    bool expired () const throw ();
+
+    /// \brief Should the solve stop (cancelled or expired)?
+    bool stopRequested () const throw ();
+
+    /// \brief Human-readable reason of the stop (empty if none).
+    std::string reason () const throw ();
+
+    /// \brief Clear the cancellation flag and the deadline.
+    void reset () throw ();
+
+  private:
+    /// \brief Monotonic clock type.
+    typedef boost::chrono::steady_clock steadyClock_t;
+
+    /// \brief Monotonic deadline after a given duration.
+    ///
+    /// \param timeout duration from now
+    static steadyClock_t::time_point
+    steadyDeadline (const duration_t& timeout) throw ();
+
+    /// \brief Protect the state below.
+    mutable boost::mutex mutex_;
+    /// \brief Cancellation flag.
+    bool cancelled_;
+    /// \brief Deadline (maximum time point if none).
+    steadyClock_t::time_point deadline_;
+  };
+
+  /// @}
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_CANCELLATION_TOKEN_HH
@@ -40,6 +40,9 @@ namespace roboptim
     ConstantFunction (const vector_t& offset) throw ();
     ~ConstantFunction () throw ();
 
+    /// \brief Constant functions do not depend on any variable.
+    virtual structure_t structure () const throw ();
+
     /// \brief Display the function on the specified output stream.
     ///
     /// \param o output stream used for display
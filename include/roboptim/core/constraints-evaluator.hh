@@ -0,0 +1,340 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_CONSTRAINTS_EVALUATOR_HH
+# define ROBOPTIM_CORE_CONSTRAINTS_EVALUATOR_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <vector>
+
+# include <boost/shared_ptr.hpp>
+
+# include <roboptim/core/fwd.hh>
+# include <roboptim/core/differentiable-function.hh>
+# include <roboptim/core/linear-function.hh>
+# include <roboptim/core/problem.hh>
+# include <roboptim/core/sparse-numeric-linear-function.hh>
+# include <roboptim/core/thread-pool.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_problem
+  /// @{
+
+  /// \brief Constraint dispatch table entry.
+  ///
+  /// Raw pointer to a constraint and typed entry points computing
+  /// its value, gradient and jacobian. The pointers are resolved once
+  /// from the problem constraints variant, calling them does not
+  /// involve any variant visitation nor shared pointer indirection.
+  ///
+  /// \warning The entry does not own the constraint.
+  struct ConstraintDispatch
+  {
+    /// \brief Evaluation entry point.
+    typedef void (*compute_t) (const void*,
+			       Function::vector_t&,
+			       const Function::argument_t&);
+    /// \brief Gradient entry point.
+    typedef void (*gradient_t) (const void*,
+				DifferentiableFunction::gradient_t&,
+				const DifferentiableFunction::argument_t&,
+				DifferentiableFunction::size_type);
+    /// \brief Jacobian entry point.
+    typedef void (*jacobian_t) (const void*,
+				DifferentiableFunction::jacobian_t&,
+				const DifferentiableFunction::argument_t&);
+
+    /// \brief Constraint object.
+    const void* object;
+    /// \brief Evaluate the constraint.
+    compute_t compute;
+    /// \brief Compute one gradient of the constraint.
+    ///
+    /// Asserts if the constraint is not differentiable.
+    gradient_t gradient;
+    /// \brief Compute the jacobian of the constraint.
+    ///
+    /// Asserts if the constraint is not differentiable.
+    jacobian_t jacobian;
+  };
+
+  /// \brief Evaluate all the constraints of a problem at once.
+  ///
+  /// Solvers usually need the constraints values as one vector and
+  /// the constraints jacobian as one matrix. This class stacks the
+  /// constraints of a problem in the order in which they have been
+  /// added: the first rows of the result are the first constraint
+  /// rows and so on.
+  ///
+  /// Row offsets and evaluation buffers are computed once when the
+  /// evaluator is built. As functions can only write into a whole
+  /// vector or matrix, each constraint is evaluated into its own
+  /// (preallocated) buffer whose content is then copied into its rows
+  /// of the output: evaluating the constraints does not allocate.
+  /// Dense jacobian buffers are only allocated for the non-linear
+  /// differentiable constraints.
+  ///
+  /// The constraints variant is resolved once too: a dispatch table
+  /// of typed entry points is built with the evaluator, see
+  /// ConstraintDispatch.
+  ///
+  /// Linear constraints (i.e. constraints reporting the
+  /// Function::LINEAR structure flag, whether they derive from
+  /// LinearFunction or not) are merged into a single block
+  /// \f$A x + b\f$ when the evaluator is built: they are all evaluated by one
+  /// sparse matrix-vector product and their (constant) jacobian is
+  /// computed once and for all. The matrix of a
+  /// SparseNumericLinearFunction is read directly. The linear block
+  /// is the only copy of these jacobians: no dense buffer is kept for
+  /// linear constraints.
+  ///
+  /// \warning The evaluator copies the constraints list: constraints
+  /// added to the problem after the evaluator has been built are
+  /// ignored.
+  ///
+  /// If a thread pool is set, constraints and their jacobians are
+  /// evaluated concurrently, each task writing into its own rows of
+  /// the stacked output. Evaluation times are recorded and used to
+  /// balance the load of the next evaluations: the tasks are dealt
+  /// over the workers by decreasing cost, each worker starts with its
+  /// most expensive constraint and the idle workers steal the
+  /// cheapest remaining ones (see ThreadPool).
+  ///
+  /// \warning In parallel mode, distinct constraints may be evaluated
+  /// at the same time: they must not share unprotected mutable
+  /// state. The contexts of split constraints are made concurrent
+  /// when the thread pool is set (see SplitContext). As Eigen's
+  /// allocation checker is process-wide, it is recommended to define
+  /// ROBOPTIM_DO_NOT_CHECK_ALLOCATION.
+  ///
+  /// \tparam P problem type
+  template <typename P>
+  class ConstraintsEvaluator
+  {
+  public:
+    /// \brief Problem type.
+    typedef P problem_t;
+
+    /// \brief Import constraint type.
+    typedef typename problem_t::constraint_t constraint_t;
+    /// \brief Import constraints type.
+    typedef typename problem_t::constraints_t constraints_t;
+
+    /// \brief Import size type.
+    typedef DifferentiableFunction::size_type size_type;
+    /// \brief Import vector type.
+    typedef DifferentiableFunction::vector_t vector_t;
+    /// \brief Import argument type.
+    typedef DifferentiableFunction::argument_t argument_t;
+    /// \brief Import gradient type.
+    typedef DifferentiableFunction::gradient_t gradient_t;
+    /// \brief Import jacobian type.
+    typedef DifferentiableFunction::jacobian_t jacobian_t;
+    /// \brief Sparse jacobian type.
+    typedef GenericFunctionTraits<EigenMatrixSparse>::matrix_t
+    sparseJacobian_t;
+
+    /// \brief Build an evaluator from a problem.
+    ///
+    /// \param problem problem whose constraints will be evaluated
+    explicit ConstraintsEvaluator (const problem_t& problem) throw ();
+    ~ConstraintsEvaluator () throw ();
+
+    /// \brief Problem input size.
+    size_type inputSize () const throw ();
+
+    /// \brief Total number of constraints rows.
+    size_type outputSize () const throw ();
+
+    /// \brief Row offset of each constraint in the stacked output.
+    const std::vector<size_type>& offsets () const throw ();
+
+    /// \brief Indices of the linear constraints.
+    ///
+    /// These constraints are merged in the linear block, in this
+    /// order.
+    const std::vector<std::size_t>& linearConstraints () const throw ();
+
+    /// \brief Jacobian of the linear block (matrix \f$A\f$).
+    ///
+    /// This matrix is constant, it is computed when the evaluator is
+    /// built and never changes.
+    const sparseJacobian_t& linearJacobian () const throw ();
+
+    /// \brief Constant term of the linear block (vector \f$b\f$).
+    const vector_t& linearConstant () const throw ();
+
+    /// \brief Constraints dispatch table, in the problem order.
+    const std::vector<ConstraintDispatch>& dispatchTable () const throw ();
+
+    /// \brief Compute the gradient of one constraint component.
+    ///
+    /// \pre the constraint has to be differentiable.
+    ///
+    /// \param gradient gradient will be stored in this argument
+    /// \param argument point at which the gradient is computed
+    /// \param constraint constraint index in the problem
+    /// \param functionId component of the constraint
+    void computeGradient (gradient_t& gradient,
+			  const argument_t& argument,
+			  std::size_t constraint,
+			  size_type functionId) const throw ();
+
+    /// \brief Evaluate the constraints concurrently.
+    ///
+    /// \param pool thread pool used to evaluate the constraints, the
+    /// evaluation is sequential if the pointer is null
+    ///
+    /// The pool can be shared with other clients (a batch solver
+    /// whose solvers use this evaluator for instance): only the
+    /// evaluation tasks are waited for, see TaskGroup.
+    ///
+    /// If a pool is given, the evaluation contexts of the split
+    /// constraints are made concurrent: the constraints must not be
+    /// evaluated while this method is called.
+    void setThreadPool (boost::shared_ptr<ThreadPool> pool) throw ();
+
+    /// \brief Retrieve the thread pool (null in sequential mode).
+    const boost::shared_ptr<ThreadPool>& threadPool () const throw ();
+
+    /// \brief Estimated cost of each constraint evaluation.
+    ///
+    /// Costs are only measured in parallel mode, in seconds. Linear
+    /// constraints are not measured as they are evaluated as a block.
+    /// The estimation of a constraint which has not been measured yet
+    /// is one second, see valueSamples.
+    const std::vector<double>& valueCosts () const throw ();
+
+    /// \brief Estimated cost of each constraint jacobian computation.
+    ///
+    /// Costs are only measured in parallel mode, in seconds. The
+    /// estimation of a constraint which has not been measured yet is
+    /// one second, see jacobianSamples.
+    const std::vector<double>& jacobianCosts () const throw ();
+
+    /// \brief Number of measures of each constraint evaluation.
+    const std::vector<std::size_t>& valueSamples () const throw ();
+
+    /// \brief Number of measures of each constraint jacobian
+    /// computation.
+    const std::vector<std::size_t>& jacobianSamples () const throw ();
+
+    /// \brief Evaluate all the constraints.
+    ///
+    /// \param result stacked constraints values, has to be of size
+    /// outputSize ()
+    /// \param argument point at which the constraints are evaluated
+    void computeConstraints (vector_t& result, const argument_t& argument)
+      const throw ();
+
+    /// \brief Compute the stacked constraints jacobian (dense).
+    ///
+    /// \pre all the constraints have to be differentiable.
+    ///
+    /// \param jacobian stacked jacobian, has to be of size
+    /// (outputSize (), inputSize ())
+    /// \param argument point at which the jacobian is computed
+    void computeJacobian (jacobian_t& jacobian, const argument_t& argument)
+      const throw ();
+
+    /// \brief Compute the stacked constraints jacobian (sparse).
+    ///
+    /// Only non-zero coefficients are stored. The memory allocated
+    /// by the matrix is reused from one call to the other.
+    ///
+    /// \pre all the constraints have to be differentiable.
+    ///
+    /// \param jacobian stacked jacobian
+    /// \param argument point at which the jacobian is computed
+    void computeJacobian (sparseJacobian_t& jacobian,
+			  const argument_t& argument)
+      const throw ();
+
+  private:
+    /// \brief Detect the linear constraints and build the linear block.
+    void mergeLinearConstraints () throw ();
+
+    /// \brief Evaluate one constraint and copy its rows.
+    void computeConstraint (std::size_t i,
+			    vector_t* result,
+			    const argument_t* argument) const throw ();
+
+    /// \brief Compute one constraint jacobian and copy its rows.
+    ///
+    /// If the stacked jacobian is null, only the buffer is filled.
+    void computeConstraintJacobian (std::size_t i,
+				    jacobian_t* jacobian,
+				    const argument_t* argument) const throw ();
+
+    /// \brief Run the tasks on the pool, balancing the estimated costs.
+    void schedule (const std::vector<ThreadPool::task_t>& tasks,
+		   const std::vector<double>& costs) const throw ();
+
+    /// \brief Constraints list (copied from the problem).
+    constraints_t constraints_;
+
+    /// \brief Problem input size.
+    size_type inputSize_;
+    /// \brief Total number of rows.
+    size_type outputSize_;
+    /// \brief Row offset of each constraint.
+    std::vector<size_type> offsets_;
+
+    /// \brief Per-constraint values buffers.
+    mutable std::vector<vector_t> values_;
+    /// \brief Per-constraint jacobian buffers (empty for linear or
+    /// non-differentiable constraints).
+    mutable std::vector<jacobian_t> jacobians_;
+
+    /// \brief Constraints dispatch table.
+    std::vector<ConstraintDispatch> dispatch_;
+
+    /// \brief Linear constraints indices.
+    std::vector<std::size_t> linear_;
+    /// \brief Non-linear constraints indices.
+    std::vector<std::size_t> nonLinear_;
+    /// \brief Sparse linear constraints (null for the other constraints).
+    std::vector<const SparseNumericLinearFunction*> sparseLinear_;
+    /// \brief Row offset of each linear constraint in the linear block.
+    std::vector<size_type> linearOffsets_;
+    /// \brief Linear block matrix.
+    sparseJacobian_t linearJacobian_;
+    /// \brief Linear block constant term.
+    vector_t linearConstant_;
+    /// \brief Linear block values buffer.
+    mutable vector_t linearValues_;
+
+    /// \brief Thread pool (parallel mode only).
+    boost::shared_ptr<ThreadPool> pool_;
+    /// \brief Estimated evaluation costs.
+    mutable std::vector<double> valueCosts_;
+    /// \brief Estimated jacobian costs.
+    mutable std::vector<double> jacobianCosts_;
+    /// \brief Number of evaluation costs measures.
+    mutable std::vector<std::size_t> valueSamples_;
+    /// \brief Number of jacobian costs measures.
+    mutable std::vector<std::size_t> jacobianSamples_;
+  };
+
+  /// @}
+
+} // end of namespace roboptim
+
+# include <roboptim/core/constraints-evaluator.hxx>
+#endif //! ROBOPTIM_CORE_CONSTRAINTS_EVALUATOR_HH
@@ -0,0 +1,688 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_CONSTRAINTS_EVALUATOR_HXX
+# define ROBOPTIM_CORE_CONSTRAINTS_EVALUATOR_HXX
+# include <algorithm>
+# include <functional>
+# include <utility>
+
+# include <boost/bind.hpp>
+# include <boost/chrono/system_clocks.hpp>
+# include <boost/type_traits/is_base_of.hpp>
+# include <boost/variant/apply_visitor.hpp>
+# include <boost/variant/static_visitor.hpp>
+
+# include <roboptim/core/filter/split.hh>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    /// \internal
+    /// \brief Compute the jacobian of a constraint.
+    inline void
+    constraintJacobian (const DifferentiableFunction& constraint,
+			DifferentiableFunction::jacobian_t& jacobian,
+			const DifferentiableFunction::argument_t& argument)
+    {
+      constraint.jacobian (jacobian, argument);
+    }
+
+    /// \internal
+    /// \brief Non-differentiable constraints do not have a jacobian.
+    inline void
+    constraintJacobian (const Function&,
+			DifferentiableFunction::jacobian_t&,
+			const DifferentiableFunction::argument_t&)
+    {
+      assert (0 && "constraint is not differentiable");
+    }
+
+    /// \internal
+    /// \brief Compute the gradient of a constraint component.
+    inline void
+    constraintGradient (const DifferentiableFunction& constraint,
+			DifferentiableFunction::gradient_t& gradient,
+			const DifferentiableFunction::argument_t& argument,
+			DifferentiableFunction::size_type functionId)
+    {
+      constraint.gradient (gradient, argument, functionId);
+    }
+
+    /// \internal
+    /// \brief Non-differentiable constraints do not have a gradient.
+    inline void
+    constraintGradient (const Function&,
+			DifferentiableFunction::gradient_t&,
+			const DifferentiableFunction::argument_t&,
+			DifferentiableFunction::size_type)
+    {
+      assert (0 && "constraint is not differentiable");
+    }
+
+    /// \internal
+    /// \brief Typed entry points of a constraint type.
+    ///
+    /// The object pointer is cast back to its static type, no variant
+    /// visitation is done at evaluation time.
+    template <typename U>
+    struct ConstraintThunks
+    {
+      static void
+      compute (const void* constraint,
+	       Function::vector_t& result,
+	       const Function::argument_t& argument)
+      {
+	(*static_cast<const U*> (constraint)) (result, argument);
+      }
+
+      static void
+      gradient (const void* constraint,
+		DifferentiableFunction::gradient_t& gradient,
+		const DifferentiableFunction::argument_t& argument,
+		DifferentiableFunction::size_type functionId)
+      {
+	constraintGradient (*static_cast<const U*> (constraint),
+			    gradient, argument, functionId);
+      }
+
+      static void
+      jacobian (const void* constraint,
+		DifferentiableFunction::jacobian_t& jacobian,
+		const DifferentiableFunction::argument_t& argument)
+      {
+	constraintJacobian (*static_cast<const U*> (constraint),
+			    jacobian, argument);
+      }
+    };
+
+    /// \internal
+    /// \brief Fill a dispatch table entry from a constraint.
+    struct makeConstraintDispatchVisitor
+      : public boost::static_visitor<ConstraintDispatch>
+    {
+      template <typename U>
+      ConstraintDispatch operator () (const boost::shared_ptr<U>& constraint)
+	const
+      {
+	assert (constraint);
+	ConstraintDispatch entry;
+	entry.object = constraint.get ();
+	entry.compute = &ConstraintThunks<U>::compute;
+	entry.gradient = &ConstraintThunks<U>::gradient;
+	entry.jacobian = &ConstraintThunks<U>::jacobian;
+	return entry;
+      }
+    };
+
+    /// \internal
+    /// \brief Is a constraint linear?
+    ///
+    /// A constraint is linear if it reports the LINEAR structure flag
+    /// and if its jacobian can be computed through its static type.
+    struct isLinearConstraintVisitor
+      : public boost::static_visitor<bool>
+    {
+      template <typename U>
+      bool operator () (const boost::shared_ptr<U>& constraint) const
+      {
+	return boost::is_base_of<DifferentiableFunction, U>::value
+	  && constraint->hasStructure (Function::LINEAR);
+      }
+    };
+
+    /// \internal
+    /// \brief Is a constraint differentiable?
+    struct isDifferentiableConstraintVisitor
+      : public boost::static_visitor<bool>
+    {
+      template <typename U>
+      bool operator () (const boost::shared_ptr<U>&) const
+      {
+	return boost::is_base_of<DifferentiableFunction, U>::value;
+      }
+    };
+
+    /// \internal
+    /// \brief Retrieve a constraint as a sparse linear function (null
+    /// if the constraint is not a SparseNumericLinearFunction).
+    struct sparseLinearConstraintVisitor
+      : public boost::static_visitor<const SparseNumericLinearFunction*>
+    {
+      template <typename U>
+      const SparseNumericLinearFunction*
+      operator () (const boost::shared_ptr<U>& constraint) const
+      {
+	return dynamic_cast<const SparseNumericLinearFunction*>
+	  (constraint.get ());
+      }
+    };
+
+    /// \internal
+    /// \brief Serialize the accesses to the context of a split
+    /// constraint, if the constraint is a split.
+    struct setConcurrentSplitVisitor
+      : public boost::static_visitor<>
+    {
+      template <typename U>
+      void operator () (const boost::shared_ptr<U>& constraint) const
+      {
+	if (const SplitBase* split =
+	    dynamic_cast<const SplitBase*> (constraint.get ()))
+	  split->setConcurrent ();
+      }
+    };
+  } // end of namespace detail.
+
+  template <typename P>
+  ConstraintsEvaluator<P>::ConstraintsEvaluator (const problem_t& pb)
+    throw ()
+    : constraints_ (pb.constraints ()),
+      inputSize_ (pb.function ().inputSize ()),
+      outputSize_ (0),
+      offsets_ (),
+      values_ (),
+      jacobians_ (),
+      dispatch_ (),
+      linear_ (),
+      nonLinear_ (),
+      sparseLinear_ (),
+      linearOffsets_ (),
+      linearJacobian_ (),
+      linearConstant_ (),
+      linearValues_ (),
+      pool_ (),
+      valueCosts_ (pb.constraints ().size (), 1.),
+      jacobianCosts_ (pb.constraints ().size (), 1.),
+      valueSamples_ (pb.constraints ().size (), 0),
+      jacobianSamples_ (pb.constraints ().size (), 0)
+  {
+    const typename problem_t::intervalsVect_t& bounds = pb.boundsVector ();
+    assert (bounds.size () == constraints_.size ());
+
+    offsets_.reserve (bounds.size ());
+    values_.reserve (bounds.size ());
+    jacobians_.reserve (bounds.size ());
+    dispatch_.reserve (bounds.size ());
+    sparseLinear_.reserve (bounds.size ());
+
+    for (std::size_t i = 0; i < bounds.size (); ++i)
+      {
+	const size_type size = static_cast<size_type> (bounds[i].size ());
+	offsets_.push_back (outputSize_);
+	outputSize_ += size;
+
+	values_.push_back (vector_t (size));
+	values_.back ().setZero ();
+
+	// Jacobian buffers are only allocated for the non-linear
+	// differentiable constraints, see mergeLinearConstraints.
+	jacobians_.push_back (jacobian_t ());
+
+	sparseLinear_.push_back
+	  (boost::apply_visitor (detail::sparseLinearConstraintVisitor (),
+				 constraints_[i]));
+
+	dispatch_.push_back
+	  (boost::apply_visitor (detail::makeConstraintDispatchVisitor (),
+				 constraints_[i]));
+      }
+
+    mergeLinearConstraints ();
+  }
+
+  template <typename P>
+  void
+  ConstraintsEvaluator<P>::mergeLinearConstraints () throw ()
+  {
+    // Linear constraints are evaluated once at zero: the constant
+    // term is f(0) and the (constant) jacobian is only stored in the
+    // linear block, it is never recomputed. Sparse linear constraints
+    // already expose their jacobian.
+    vector_t zero (inputSize_);
+    zero.setZero ();
+
+    size_type linearSize = 0;
+    for (std::size_t i = 0; i < constraints_.size (); ++i)
+      {
+	if (boost::apply_visitor (detail::isLinearConstraintVisitor (),
+				  constraints_[i]))
+	  {
+	    linear_.push_back (i);
+	    linearOffsets_.push_back (linearSize);
+	    linearSize += values_[i].size ();
+	    continue;
+	  }
+
+	nonLinear_.push_back (i);
+	if (boost::apply_visitor (detail::isDifferentiableConstraintVisitor (),
+				  constraints_[i]))
+	  {
+	    jacobians_[i].resize (values_[i].size (), inputSize_);
+	    jacobians_[i].setZero ();
+	  }
+      }
+
+    linearConstant_.resize (linearSize);
+    linearValues_.resize (linearSize);
+    for (std::size_t k = 0; k < linear_.size (); ++k)
+      {
+	const std::size_t i = linear_[k];
+	const ConstraintDispatch& entry = dispatch_[i];
+	entry.compute (entry.object, values_[i], zero);
+	linearConstant_.segment (linearOffsets_[k], values_[i].size ()) =
+	  values_[i];
+      }
+    linearValues_ = linearConstant_;
+
+    // Stack the linear jacobians into one sparse matrix.
+    typedef Eigen::Triplet<Function::value_type> triplet_t;
+    typedef SparseNumericLinearFunction::sparseMatrix_t sparseMatrix_t;
+    std::vector<triplet_t> triplets;
+    for (std::size_t k = 0; k < linear_.size (); ++k)
+      {
+	const std::size_t i = linear_[k];
+	if (const SparseNumericLinearFunction* sparse = sparseLinear_[i])
+	  {
+	    const sparseMatrix_t& a = sparse->A ();
+	    for (typename sparseMatrix_t::Index r = 0; r < a.outerSize (); ++r)
+	      for (typename sparseMatrix_t::InnerIterator it (a, r); it; ++it)
+		triplets.push_back (triplet_t (linearOffsets_[k] + it.row (),
+					       it.col (), it.value ()));
+	    continue;
+	  }
+
+	// Dense linear constraints jacobian, computed once.
+	jacobian_t jacobian (values_[i].size (), inputSize_);
+	jacobian.setZero ();
+	dispatch_[i].jacobian (dispatch_[i].object, jacobian, zero);
+	for (size_type j = 0; j < inputSize_; ++j)
+	  for (size_type r = 0; r < jacobian.rows (); ++r)
+	    if (jacobian (r, j) != 0.)
+	      triplets.push_back (triplet_t (linearOffsets_[k] + r, j,
+					     jacobian (r, j)));
+      }
+    linearJacobian_.resize (linearSize, inputSize_);
+    linearJacobian_.setFromTriplets (triplets.begin (), triplets.end ());
+  }
+
+  template <typename P>
+  ConstraintsEvaluator<P>::~ConstraintsEvaluator () throw ()
+  {
+  }
+
+  template <typename P>
+  typename ConstraintsEvaluator<P>::size_type
+  ConstraintsEvaluator<P>::inputSize () const throw ()
+  {
+    return inputSize_;
+  }
+
+  template <typename P>
+  typename ConstraintsEvaluator<P>::size_type
+  ConstraintsEvaluator<P>::outputSize () const throw ()
+  {
+    return outputSize_;
+  }
+
+  template <typename P>
+  const std::vector<typename ConstraintsEvaluator<P>::size_type>&
+  ConstraintsEvaluator<P>::offsets () const throw ()
+  {
+    return offsets_;
+  }
+
+  template <typename P>
+  void
+  ConstraintsEvaluator<P>::setThreadPool (boost::shared_ptr<ThreadPool> pool)
+    throw ()
+  {
+    pool_ = pool;
+
+    // Splits of a same function share their context, which is
+    // evaluated from several threads from now on.
+    if (pool_)
+      for (std::size_t i = 0; i < constraints_.size (); ++i)
+	boost::apply_visitor (detail::setConcurrentSplitVisitor (),
+			      constraints_[i]);
+  }
+
+  template <typename P>
+  const std::vector<std::size_t>&
+  ConstraintsEvaluator<P>::linearConstraints () const throw ()
+  {
+    return linear_;
+  }
+
+  template <typename P>
+  const typename ConstraintsEvaluator<P>::sparseJacobian_t&
+  ConstraintsEvaluator<P>::linearJacobian () const throw ()
+  {
+    return linearJacobian_;
+  }
+
+  template <typename P>
+  const typename ConstraintsEvaluator<P>::vector_t&
+  ConstraintsEvaluator<P>::linearConstant () const throw ()
+  {
+    return linearConstant_;
+  }
+
+  template <typename P>
+  const std::vector<ConstraintDispatch>&
+  ConstraintsEvaluator<P>::dispatchTable () const throw ()
+  {
+    return dispatch_;
+  }
+
+  template <typename P>
+  void
+  ConstraintsEvaluator<P>::computeGradient (gradient_t& gradient,
+					    const argument_t& argument,
+					    std::size_t constraint,
+					    size_type functionId)
+    const throw ()
+  {
+    assert (constraint < dispatch_.size ());
+    assert (functionId < values_[constraint].size ());
+    const ConstraintDispatch& entry = dispatch_[constraint];
+    entry.gradient (entry.object, gradient, argument, functionId);
+  }
+
+  template <typename P>
+  const boost::shared_ptr<ThreadPool>&
+  ConstraintsEvaluator<P>::threadPool () const throw ()
+  {
+    return pool_;
+  }
+
+  template <typename P>
+  const std::vector<double>&
+  ConstraintsEvaluator<P>::valueCosts () const throw ()
+  {
+    return valueCosts_;
+  }
+
+  template <typename P>
+  const std::vector<double>&
+  ConstraintsEvaluator<P>::jacobianCosts () const throw ()
+  {
+    return jacobianCosts_;
+  }
+
+  template <typename P>
+  const std::vector<std::size_t>&
+  ConstraintsEvaluator<P>::valueSamples () const throw ()
+  {
+    return valueSamples_;
+  }
+
+  template <typename P>
+  const std::vector<std::size_t>&
+  ConstraintsEvaluator<P>::jacobianSamples () const throw ()
+  {
+    return jacobianSamples_;
+  }
+
+  namespace detail
+  {
+    /// \internal
+    /// \brief Update a cost estimation from a new measure.
+    ///
+    /// \param cost cost estimation
+    /// \param samples number of measures the estimation is based on
+    /// \param start measure start time
+    ///
+    /// Measures use a monotonic clock: wall clock adjustments must
+    /// not corrupt the estimations.
+    inline void
+    updateCost (double& cost,
+		std::size_t& samples,
+		const boost::chrono::steady_clock::time_point& start)
+    {
+      const double measure = boost::chrono::duration<double>
+	(boost::chrono::steady_clock::now () - start).count ();
+      // Exponential moving average, the first measure replaces the
+      // default estimation.
+      cost = samples ? .8 * cost + .2 * measure : measure;
+      ++samples;
+    }
+  } // end of namespace detail.
+
+  template <typename P>
+  void
+  ConstraintsEvaluator<P>::computeConstraint (std::size_t i,
+					      vector_t* result,
+					      const argument_t* argument)
+    const throw ()
+  {
+    boost::chrono::steady_clock::time_point start;
+    if (pool_)
+      start = boost::chrono::steady_clock::now ();
+
+    const ConstraintDispatch& entry = dispatch_[i];
+    entry.compute (entry.object, values_[i], *argument);
+    result->segment (offsets_[i], values_[i].size ()) = values_[i];
+
+    if (pool_)
+      detail::updateCost (valueCosts_[i], valueSamples_[i], start);
+  }
+
+  template <typename P>
+  void
+  ConstraintsEvaluator<P>::computeConstraintJacobian
+  (std::size_t i, jacobian_t* jacobian, const argument_t* argument)
+    const throw ()
+  {
+    boost::chrono::steady_clock::time_point start;
+    if (pool_)
+      start = boost::chrono::steady_clock::now ();
+
+    const ConstraintDispatch& entry = dispatch_[i];
+    entry.jacobian (entry.object, jacobians_[i], *argument);
+    if (jacobian)
+      jacobian->middleRows (offsets_[i], jacobians_[i].rows ()) =
+	jacobians_[i];
+
+    if (pool_)
+      detail::updateCost (jacobianCosts_[i], jacobianSamples_[i], start);
+  }
+
+  template <typename P>
+  void
+  ConstraintsEvaluator<P>::schedule
+  (const std::vector<ThreadPool::task_t>& tasks,
+   const std::vector<double>& costs) const throw ()
+  {
+    assert (pool_);
+    assert (tasks.size () == costs.size ());
+
+    // Longest processing time first: the batch is dealt over the
+    // workers by decreasing cost, each worker starts with its most
+    // expensive task and the idle ones steal the cheapest remaining
+    // tasks.
+    typedef std::pair<double, std::size_t> entry_t;
+    std::vector<entry_t> order (tasks.size ());
+    for (std::size_t i = 0; i < tasks.size (); ++i)
+      order[i] = std::make_pair (costs[i], i);
+    std::sort (order.begin (), order.end (), std::greater<entry_t> ());
+
+    std::vector<ThreadPool::task_t> sorted (order.size ());
+    for (std::size_t i = 0; i < order.size (); ++i)
+      sorted[i] = tasks[order[i].second];
+
+    TaskGroup group (*pool_);
+    group.submit (sorted);
+    group.wait ();
+  }
+
+  template <typename P>
+  void
+  ConstraintsEvaluator<P>::computeConstraints (vector_t& result,
+					       const argument_t& argument)
+    const throw ()
+  {
+    assert (result.size () == outputSize_);
+    assert (argument.size () == inputSize_);
+
+    // All the linear constraints at once.
+    if (!linear_.empty ())
+      {
+	linearValues_.noalias () = linearJacobian_ * argument;
+	linearValues_ += linearConstant_;
+	for (std::size_t k = 0; k < linear_.size (); ++k)
+	  result.segment (offsets_[linear_[k]], values_[linear_[k]].size ())
+	    = linearValues_.segment (linearOffsets_[k],
+				     values_[linear_[k]].size ());
+      }
+
+    if (!pool_)
+      {
+	for (std::size_t k = 0; k < nonLinear_.size (); ++k)
+	  computeConstraint (nonLinear_[k], &result, &argument);
+	return;
+      }
+
+    std::vector<ThreadPool::task_t> tasks (nonLinear_.size ());
+    std::vector<double> costs (nonLinear_.size ());
+    for (std::size_t k = 0; k < nonLinear_.size (); ++k)
+      {
+	tasks[k] = boost::bind (&ConstraintsEvaluator<P>::computeConstraint,
+				this, nonLinear_[k], &result, &argument);
+	costs[k] = valueCosts_[nonLinear_[k]];
+      }
+    schedule (tasks, costs);
+  }
+
+  template <typename P>
+  void
+  ConstraintsEvaluator<P>::computeJacobian (jacobian_t& jacobian,
+					    const argument_t& argument)
+    const throw ()
+  {
+    assert (jacobian.rows () == outputSize_);
+    assert (jacobian.cols () == inputSize_);
+    assert (argument.size () == inputSize_);
+
+    // Linear constraints jacobians are constant: scatter the linear
+    // block rows, in which they appear in the same order.
+    for (std::size_t k = 0; k < linear_.size (); ++k)
+      jacobian.middleRows (offsets_[linear_[k]],
+			   values_[linear_[k]].size ()).setZero ();
+    for (size_type j = 0; j < inputSize_; ++j)
+      {
+	std::size_t k = 0;
+	for (typename sparseJacobian_t::InnerIterator it (linearJacobian_, j);
+	     it; ++it)
+	  {
+	    while (it.row () >= linearOffsets_[k]
+		   + values_[linear_[k]].size ())
+	      ++k;
+	    jacobian (offsets_[linear_[k]] + it.row () - linearOffsets_[k],
+		      j) = it.value ();
+	  }
+      }
+
+    if (!pool_)
+      {
+	for (std::size_t k = 0; k < nonLinear_.size (); ++k)
+	  computeConstraintJacobian (nonLinear_[k], &jacobian, &argument);
+	return;
+      }
+
+    std::vector<ThreadPool::task_t> tasks (nonLinear_.size ());
+    std::vector<double> costs (nonLinear_.size ());
+    for (std::size_t k = 0; k < nonLinear_.size (); ++k)
+      {
+	tasks[k] = boost::bind
+	  (&ConstraintsEvaluator<P>::computeConstraintJacobian,
+	   this, nonLinear_[k], &jacobian, &argument);
+	costs[k] = jacobianCosts_[nonLinear_[k]];
+      }
+    schedule (tasks, costs);
+  }
+
+  template <typename P>
+  void
+  ConstraintsEvaluator<P>::computeJacobian (sparseJacobian_t& jacobian,
+					    const argument_t& argument)
+    const throw ()
+  {
+    assert (argument.size () == inputSize_);
+
+    // Fill the per-constraint buffers only, the sparse matrix is
+    // assembled sequentially. Linear constraints are read from the
+    // linear block.
+    jacobian_t* noJacobian = 0;
+    if (!pool_)
+      for (std::size_t k = 0; k < nonLinear_.size (); ++k)
+	computeConstraintJacobian (nonLinear_[k], noJacobian, &argument);
+    else
+      {
+	std::vector<ThreadPool::task_t> tasks (nonLinear_.size ());
+	std::vector<double> costs (nonLinear_.size ());
+	for (std::size_t k = 0; k < nonLinear_.size (); ++k)
+	  {
+	    tasks[k] = boost::bind
+	      (&ConstraintsEvaluator<P>::computeConstraintJacobian,
+	       this, nonLinear_[k], noJacobian, &argument);
+	    costs[k] = jacobianCosts_[nonLinear_[k]];
+	  }
+	schedule (tasks, costs);
+      }
+
+    // Keep the previously allocated memory when possible.
+    const typename sparseJacobian_t::Index nonZeros = jacobian.nonZeros ();
+    if (jacobian.rows () != outputSize_ || jacobian.cols () != inputSize_)
+      jacobian.resize (outputSize_, inputSize_);
+    jacobian.setZero ();
+    jacobian.reserve (nonZeros);
+
+    // Column-major storage: fill the matrix column by column. Linear
+    // constraints rows are read from the linear block, in which they
+    // appear in the same order.
+    for (size_type j = 0; j < inputSize_; ++j)
+      {
+	jacobian.startVec (j);
+	typename sparseJacobian_t::InnerIterator it (linearJacobian_, j);
+	std::size_t k = 0;
+	for (std::size_t i = 0; i < constraints_.size (); ++i)
+	  {
+	    if (k < linear_.size () && linear_[k] == i)
+	      {
+		const size_type end = linearOffsets_[k] + values_[i].size ();
+		for (; it && it.row () < end; ++it)
+		  jacobian.insertBack
+		    (offsets_[i] + it.row () - linearOffsets_[k], j) =
+		    it.value ();
+		++k;
+		continue;
+	      }
+
+	    for (size_type r = 0; r < jacobians_[i].rows (); ++r)
+	      if (jacobians_[i] (r, j) != 0.)
+		jacobian.insertBack (offsets_[i] + r, j) =
+		  jacobians_[i] (r, j);
+	  }
+      }
+    jacobian.finalize ();
+  }
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_CONSTRAINTS_EVALUATOR_HXX
@@ -0,0 +1,83 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_DIAGONAL_QUADRATIC_FUNCTION_HH
+# define ROBOPTIM_CORE_DIAGONAL_QUADRATIC_FUNCTION_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <roboptim/core/quadratic-function.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_function
+  /// @{
+
+  /// \brief Quadratic function with a diagonal matrix.
+  ///
+  /// Implement a quadratic function using the formula:
+  /// \f[f(x) = \frac{1}{2} x^t D x + b^t x\f]
+  /// where \f$D = diag (d)\f$ and \f$b\f$ are set when the class is
+  /// instantiated. Only the diagonal is stored and the kernels are
+  /// element-wise (\f$O(n)\f$).
+  class ROBOPTIM_DLLAPI DiagonalQuadraticFunction : public QuadraticFunction
+  {
+  public:
+    /// \brief Build a quadratic function from a diagonal and a vector.
+    ///
+    /// \param d diagonal of the matrix
+    /// \param b b vector
+    DiagonalQuadraticFunction (const vector_t& d, const vector_t& b)
+      throw ();
+
+    ~DiagonalQuadraticFunction () throw ();
+
+    /// \brief Matrix diagonal.
+    const vector_t& diagonal () const throw ();
+
+    /// \brief b vector.
+    const vector_t& b () const throw ();
+
+    /// \brief Diagonal quadratic functions are separable.
+    virtual structure_t structure () const throw ();
+
+    /// \brief Display the function on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    virtual std::ostream& print (std::ostream&) const throw ();
+
+  protected:
+    void impl_compute (result_t& , const argument_t&) const throw ();
+    void impl_gradient (gradient_t&, const argument_t&, size_type = 0)
+      const throw ();
+    void impl_hessian (hessian_t& hessian,
+		       const argument_t& argument,
+		       size_type functionId = 0) const throw ();
+  private:
+    /// \brief Matrix diagonal.
+    vector_t d_;
+    /// \brief B vector.
+    vector_t b_;
+  };
+
+  /// @}
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_DIAGONAL_QUADRATIC_FUNCTION_HH
@@ -0,0 +1,536 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_FILTER_ALGEBRA_HH
+# define ROBOPTIM_CORE_FILTER_ALGEBRA_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <boost/mpl/if.hpp>
+# include <boost/shared_ptr.hpp>
+# include <boost/type_traits/is_base_of.hpp>
+# include <boost/utility/enable_if.hpp>
+
+# include <roboptim/core/differentiable-function.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_filter
+  /// @{
+
+  namespace detail
+  {
+    /// \internal
+    /// \brief Function type of an algebraic expression.
+    ///
+    /// The expression is differentiable if all its operands are,
+    /// otherwise it is a plain function.
+    template <typename U, typename V = U>
+    struct AlgebraBase
+    {
+      typedef typename boost::mpl::if_c
+      <boost::is_base_of<DifferentiableFunction, U>::value
+       && boost::is_base_of<DifferentiableFunction, V>::value,
+       DifferentiableFunction,
+       Function>::type type;
+    };
+
+    /// \internal
+    /// \brief Structure of a sum or of a concatenation.
+    ///
+    /// Only the properties shared by both operands and preserved by
+    /// the operation are kept.
+    inline Function::structure_t
+    intersectStructure (Function::structure_t u, Function::structure_t v)
+    {
+      return u & v & (Function::CONSTANT_JACOBIAN
+		      | Function::CONSTANT_HESSIAN
+		      | Function::LINEAR
+		      | Function::QUADRATIC
+		      | Function::SEPARABLE);
+    }
+
+    /// \internal
+    /// \brief Structure of a composition: outer (inner (x)).
+    inline Function::structure_t
+    composeStructure (Function::structure_t outer, Function::structure_t inner)
+    {
+      const Function::structure_t linear = Function::CONSTANT_JACOBIAN
+	| Function::CONSTANT_HESSIAN | Function::LINEAR | Function::QUADRATIC
+	| Function::SEPARABLE;
+      const Function::structure_t quadratic =
+	Function::CONSTANT_HESSIAN | Function::QUADRATIC;
+
+      if ((outer & Function::LINEAR) && (inner & Function::LINEAR))
+	return linear;
+      if (((outer & Function::LINEAR) && (inner & Function::QUADRATIC))
+	  || ((outer & Function::QUADRATIC) && (inner & Function::LINEAR)))
+	return quadratic;
+      return 0;
+    }
+
+    /// \internal
+    /// \brief Enable an operator on functions only.
+    template <typename U, typename V, typename R>
+    struct EnableIfFunctions
+      : public boost::enable_if_c<boost::is_base_of<Function, U>::value
+				  && boost::is_base_of<Function, V>::value,
+				  R>
+    {};
+  } // end of namespace detail.
+
+  /// \brief Sum of two functions: \f$f(x) = u(x) + v(x)\f$.
+  ///
+  /// Sums and scaled functions form linear combinations which are
+  /// evaluated by their root node: the expression tree is traversed
+  /// through the operands static types, the first term is computed
+  /// directly into the result and each other term into a single
+  /// preallocated buffer which is then added with its coefficient.
+  /// The intermediate Plus and Scalar nodes are neither called nor
+  /// use their own buffers, and no temporary is allocated.
+  ///
+  /// Other expressions (Product, Composition, Concatenate) are terms
+  /// of the combination: they are evaluated through their virtual
+  /// interface, into their own buffers.
+  ///
+  /// The difference \f$u - v\f$ is represented by
+  /// Plus<U, Scalar<V> >: operator- builds an extra Scalar node of
+  /// factor -1, which is folded into the coefficient of \f$v\f$ when
+  /// the sum is evaluated and therefore costs no additional pass.
+  ///
+  /// \warning Evaluation buffers are shared, an expression must not
+  /// be evaluated concurrently.
+  ///
+  /// \tparam U left operand type
+  /// \tparam V right operand type
+  template <typename U, typename V>
+  class Plus : public detail::AlgebraBase<U, V>::type
+  {
+  public:
+    /// \brief Import value type.
+    typedef DifferentiableFunction::value_type value_type;
+    /// \brief Import size type.
+    typedef DifferentiableFunction::size_type size_type;
+    /// \brief Import vector type.
+    typedef DifferentiableFunction::vector_t vector_t;
+    /// \brief Import result type.
+    typedef DifferentiableFunction::result_t result_t;
+    /// \brief Import argument type.
+    typedef DifferentiableFunction::argument_t argument_t;
+    /// \brief Import gradient type.
+    typedef DifferentiableFunction::gradient_t gradient_t;
+    /// \brief Import jacobian type.
+    typedef DifferentiableFunction::jacobian_t jacobian_t;
+
+    /// \brief Build the sum of two functions.
+    ///
+    /// \param left left operand
+    /// \param right right operand, has to be of the same input and
+    /// output sizes as the left operand
+    Plus (boost::shared_ptr<const U> left,
+	  boost::shared_ptr<const V> right) throw ();
+    ~Plus () throw ();
+
+    /// \brief Left operand.
+    const boost::shared_ptr<const U>& left () const throw ();
+    /// \brief Right operand.
+    const boost::shared_ptr<const V>& right () const throw ();
+
+    /// \brief Structural properties shared by both operands.
+    virtual Function::structure_t structure () const throw ();
+
+  protected:
+    virtual void impl_compute (result_t& result, const argument_t& argument)
+      const throw ();
+    virtual void impl_gradient (gradient_t& gradient,
+				const argument_t& argument,
+				size_type functionId = 0)
+      const throw ();
+    virtual void impl_jacobian (jacobian_t& jacobian,
+				const argument_t& argument)
+      const throw ();
+
+  private:
+    /// \brief Left operand.
+    boost::shared_ptr<const U> left_;
+    /// \brief Right operand.
+    boost::shared_ptr<const V> right_;
+
+    /// \brief Terms value buffer.
+    mutable vector_t value_;
+    /// \brief Terms gradient buffer.
+    mutable gradient_t gradient_;
+    /// \brief Terms jacobian buffer.
+    mutable jacobian_t jacobian_;
+  };
+
+  /// \brief Function multiplied by a scalar: \f$f(x) = s u(x)\f$.
+  ///
+  /// The scale factor is a coefficient of the enclosing linear
+  /// combination, see Plus. A generic operand is evaluated directly
+  /// into the result which is then scaled in place.
+  ///
+  /// \warning Evaluation buffers are shared, an expression must not
+  /// be evaluated concurrently.
+  ///
+  /// \tparam U operand type
+  template <typename U>
+  class Scalar : public detail::AlgebraBase<U>::type
+  {
+  public:
+    /// \brief Import value type.
+    typedef DifferentiableFunction::value_type value_type;
+    /// \brief Import size type.
+    typedef DifferentiableFunction::size_type size_type;
+    /// \brief Import vector type.
+    typedef DifferentiableFunction::vector_t vector_t;
+    /// \brief Import result type.
+    typedef DifferentiableFunction::result_t result_t;
+    /// \brief Import argument type.
+    typedef DifferentiableFunction::argument_t argument_t;
+    /// \brief Import gradient type.
+    typedef DifferentiableFunction::gradient_t gradient_t;
+    /// \brief Import jacobian type.
+    typedef DifferentiableFunction::jacobian_t jacobian_t;
+
+    /// \brief Scale a function.
+    ///
+    /// \param function operand
+    /// \param scalar scale factor
+    Scalar (boost::shared_ptr<const U> function, value_type scalar)
+      throw ();
+    ~Scalar () throw ();
+
+    /// \brief Operand.
+    const boost::shared_ptr<const U>& function () const throw ();
+    /// \brief Scale factor.
+    value_type scalar () const throw ();
+
+    /// \brief Structural properties of the operand.
+    virtual Function::structure_t structure () const throw ();
+
+  protected:
+    virtual void impl_compute (result_t& result, const argument_t& argument)
+      const throw ();
+    virtual void impl_gradient (gradient_t& gradient,
+				const argument_t& argument,
+				size_type functionId = 0)
+      const throw ();
+    virtual void impl_jacobian (jacobian_t& jacobian,
+				const argument_t& argument)
+      const throw ();
+
+  private:
+    /// \brief Operand.
+    boost::shared_ptr<const U> function_;
+    /// \brief Scale factor.
+    value_type scalar_;
+
+    /// \brief Linear combination operand value buffer.
+    mutable vector_t value_;
+    /// \brief Linear combination operand gradient buffer.
+    mutable gradient_t gradient_;
+    /// \brief Linear combination operand jacobian buffer.
+    mutable jacobian_t jacobian_;
+  };
+
+  /// \brief Element-wise product of two functions:
+  /// \f$f_i(x) = u_i(x) v_i(x)\f$.
+  ///
+  /// The jacobian is \f$diag(v(x)) J_u(x) + diag(u(x)) J_v(x)\f$, the
+  /// left operand jacobian is computed directly into the result.
+  ///
+  /// The operands values are cached for gradient computations:
+  /// requesting all the gradients at a same point evaluates the
+  /// operands once. Operands therefore have to be pure functions.
+  ///
+  /// \warning Evaluation buffers are shared, an expression must not
+  /// be evaluated concurrently.
+  ///
+  /// \tparam U left operand type
+  /// \tparam V right operand type
+  template <typename U, typename V>
+  class Product : public detail::AlgebraBase<U, V>::type
+  {
+  public:
+    /// \brief Import value type.
+    typedef DifferentiableFunction::value_type value_type;
+    /// \brief Import size type.
+    typedef DifferentiableFunction::size_type size_type;
+    /// \brief Import vector type.
+    typedef DifferentiableFunction::vector_t vector_t;
+    /// \brief Import result type.
+    typedef DifferentiableFunction::result_t result_t;
+    /// \brief Import argument type.
+    typedef DifferentiableFunction::argument_t argument_t;
+    /// \brief Import gradient type.
+    typedef DifferentiableFunction::gradient_t gradient_t;
+    /// \brief Import jacobian type.
+    typedef DifferentiableFunction::jacobian_t jacobian_t;
+
+    /// \brief Build the element-wise product of two functions.
+    ///
+    /// \param left left operand
+    /// \param right right operand, has to be of the same input and
+    /// output sizes as the left operand
+    Product (boost::shared_ptr<const U> left,
+	     boost::shared_ptr<const V> right) throw ();
+    ~Product () throw ();
+
+    /// \brief Left operand.
+    const boost::shared_ptr<const U>& left () const throw ();
+    /// \brief Right operand.
+    const boost::shared_ptr<const V>& right () const throw ();
+
+    /// \brief The product of two linear functions is quadratic.
+    virtual Function::structure_t structure () const throw ();
+
+  protected:
+    virtual void impl_compute (result_t& result, const argument_t& argument)
+      const throw ();
+    virtual void impl_gradient (gradient_t& gradient,
+				const argument_t& argument,
+				size_type functionId = 0)
+      const throw ();
+    virtual void impl_jacobian (jacobian_t& jacobian,
+				const argument_t& argument)
+      const throw ();
+
+  private:
+    /// \brief Left operand.
+    boost::shared_ptr<const U> left_;
+    /// \brief Right operand.
+    boost::shared_ptr<const V> right_;
+
+    /// \brief Left operand value.
+    mutable vector_t leftValue_;
+    /// \brief Right operand value.
+    mutable vector_t rightValue_;
+    /// \brief Argument at which the operands values are cached.
+    mutable argument_t valuesX_;
+    /// \brief Are the cached operands values valid?
+    mutable bool valuesValid_;
+    /// \brief Right operand gradient.
+    mutable gradient_t gradient_;
+    /// \brief Right operand jacobian.
+    mutable jacobian_t jacobian_;
+  };
+
+  /// \brief Composition of two functions: \f$f(x) = u(v(x))\f$.
+  ///
+  /// The inner function is evaluated once into a buffer, the chain
+  /// rule product \f$J_u(v(x)) J_v(x)\f$ is written directly into
+  /// the result.
+  ///
+  /// The inner function value and jacobian are cached for gradient
+  /// computations: requesting all the gradients at a same point
+  /// computes the inner jacobian once. The inner function therefore
+  /// has to be a pure function.
+  ///
+  /// \warning Evaluation buffers are shared, an expression must not
+  /// be evaluated concurrently.
+  ///
+  /// \tparam U outer function type
+  /// \tparam V inner function type
+  template <typename U, typename V>
+  class Composition : public detail::AlgebraBase<U, V>::type
+  {
+  public:
+    /// \brief Import value type.
+    typedef DifferentiableFunction::value_type value_type;
+    /// \brief Import size type.
+    typedef DifferentiableFunction::size_type size_type;
+    /// \brief Import vector type.
+    typedef DifferentiableFunction::vector_t vector_t;
+    /// \brief Import result type.
+    typedef DifferentiableFunction::result_t result_t;
+    /// \brief Import argument type.
+    typedef DifferentiableFunction::argument_t argument_t;
+    /// \brief Import gradient type.
+    typedef DifferentiableFunction::gradient_t gradient_t;
+    /// \brief Import jacobian type.
+    typedef DifferentiableFunction::jacobian_t jacobian_t;
+
+    /// \brief Compose two functions.
+    ///
+    /// \param outer outer function
+    /// \param inner inner function, its output size has to be the
+    /// outer function input size
+    Composition (boost::shared_ptr<const U> outer,
+		 boost::shared_ptr<const V> inner) throw ();
+    ~Composition () throw ();
+
+    /// \brief Outer function.
+    const boost::shared_ptr<const U>& outer () const throw ();
+    /// \brief Inner function.
+    const boost::shared_ptr<const V>& inner () const throw ();
+
+    /// \brief Linear and quadratic properties of the composition.
+    virtual Function::structure_t structure () const throw ();
+
+  protected:
+    virtual void impl_compute (result_t& result, const argument_t& argument)
+      const throw ();
+    virtual void impl_gradient (gradient_t& gradient,
+				const argument_t& argument,
+				size_type functionId = 0)
+      const throw ();
+    virtual void impl_jacobian (jacobian_t& jacobian,
+				const argument_t& argument)
+      const throw ();
+
+  private:
+    /// \brief Outer function.
+    boost::shared_ptr<const U> outer_;
+    /// \brief Inner function.
+    boost::shared_ptr<const V> inner_;
+
+    /// \brief Inner function value.
+    mutable vector_t value_;
+    /// \brief Outer function gradient.
+    mutable gradient_t gradient_;
+    /// \brief Outer function jacobian.
+    mutable jacobian_t outerJacobian_;
+    /// \brief Inner function jacobian.
+    mutable jacobian_t innerJacobian_;
+    /// \brief Argument at which the inner value and jacobian are cached.
+    mutable argument_t jacobianX_;
+    /// \brief Are the cached inner value and jacobian valid?
+    mutable bool jacobianValid_;
+  };
+
+  /// \brief Concatenation of two functions: \f$f(x) = (u(x), v(x))\f$.
+  ///
+  /// Gradients are forwarded to the relevant operand without any
+  /// copy.
+  ///
+  /// \warning Evaluation buffers are shared, an expression must not
+  /// be evaluated concurrently.
+  ///
+  /// \tparam U top function type
+  /// \tparam V bottom function type
+  template <typename U, typename V>
+  class Concatenate : public detail::AlgebraBase<U, V>::type
+  {
+  public:
+    /// \brief Import value type.
+    typedef DifferentiableFunction::value_type value_type;
+    /// \brief Import size type.
+    typedef DifferentiableFunction::size_type size_type;
+    /// \brief Import vector type.
+    typedef DifferentiableFunction::vector_t vector_t;
+    /// \brief Import result type.
+    typedef DifferentiableFunction::result_t result_t;
+    /// \brief Import argument type.
+    typedef DifferentiableFunction::argument_t argument_t;
+    /// \brief Import gradient type.
+    typedef DifferentiableFunction::gradient_t gradient_t;
+    /// \brief Import jacobian type.
+    typedef DifferentiableFunction::jacobian_t jacobian_t;
+
+    /// \brief Concatenate two functions.
+    ///
+    /// \param top top function
+    /// \param bottom bottom function, has to be of the same input
+    /// size as the top function
+    Concatenate (boost::shared_ptr<const U> top,
+		 boost::shared_ptr<const V> bottom) throw ();
+    ~Concatenate () throw ();
+
+    /// \brief Top function.
+    const boost::shared_ptr<const U>& top () const throw ();
+    /// \brief Bottom function.
+    const boost::shared_ptr<const V>& bottom () const throw ();
+
+    /// \brief Structural properties shared by both functions.
+    virtual Function::structure_t structure () const throw ();
+
+  protected:
+    virtual void impl_compute (result_t& result, const argument_t& argument)
+      const throw ();
+    virtual void impl_gradient (gradient_t& gradient,
+				const argument_t& argument,
+				size_type functionId = 0)
+      const throw ();
+    virtual void impl_jacobian (jacobian_t& jacobian,
+				const argument_t& argument)
+      const throw ();
+
+  private:
+    /// \brief Top function.
+    boost::shared_ptr<const U> top_;
+    /// \brief Bottom function.
+    boost::shared_ptr<const V> bottom_;
+
+    /// \brief Top function value.
+    mutable vector_t topValue_;
+    /// \brief Bottom function value.
+    mutable vector_t bottomValue_;
+    /// \brief Top function jacobian.
+    mutable jacobian_t topJacobian_;
+    /// \brief Bottom function jacobian.
+    mutable jacobian_t bottomJacobian_;
+  };
+
+  /// \brief Sum of two functions.
+  template <typename U, typename V>
+  typename detail::EnableIfFunctions
+  <U, V, boost::shared_ptr<Plus<U, V> > >::type
+  operator+ (boost::shared_ptr<U> left, boost::shared_ptr<V> right);
+
+  /// \brief Difference of two functions.
+  ///
+  /// The right operand is wrapped into a Scalar node of factor -1.
+  template <typename U, typename V>
+  typename detail::EnableIfFunctions
+  <U, V, boost::shared_ptr<Plus<U, Scalar<V> > > >::type
+  operator- (boost::shared_ptr<U> left, boost::shared_ptr<V> right);
+
+  /// \brief Function multiplied by a scalar.
+  template <typename U>
+  typename detail::EnableIfFunctions
+  <U, U, boost::shared_ptr<Scalar<U> > >::type
+  operator* (Function::value_type scalar, boost::shared_ptr<U> function);
+
+  /// \brief Function multiplied by a scalar.
+  template <typename U>
+  typename detail::EnableIfFunctions
+  <U, U, boost::shared_ptr<Scalar<U> > >::type
+  operator* (boost::shared_ptr<U> function, Function::value_type scalar);
+
+  /// \brief Element-wise product of two functions.
+  template <typename U, typename V>
+  typename detail::EnableIfFunctions
+  <U, V, boost::shared_ptr<Product<U, V> > >::type
+  operator* (boost::shared_ptr<U> left, boost::shared_ptr<V> right);
+
+  /// \brief Composition of two functions: outer (inner (x)).
+  template <typename U, typename V>
+  boost::shared_ptr<Composition<U, V> >
+  compose (boost::shared_ptr<U> outer, boost::shared_ptr<V> inner);
+
+  /// \brief Concatenation of two functions.
+  template <typename U, typename V>
+  boost::shared_ptr<Concatenate<U, V> >
+  concatenate (boost::shared_ptr<U> top, boost::shared_ptr<V> bottom);
+
+  /// @}
+
+} // end of namespace roboptim
+
+# include <roboptim/core/filter/algebra.hxx>
+#endif //! ROBOPTIM_CORE_FILTER_ALGEBRA_HH
@@ -0,0 +1,819 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_FILTER_ALGEBRA_HXX
+# define ROBOPTIM_CORE_FILTER_ALGEBRA_HXX
+# include <boost/format.hpp>
+# include <boost/make_shared.hpp>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    /// \internal
+    /// \brief Build the name of a binary expression.
+    template <typename U, typename V>
+    std::string algebraName (const char* format, const U& u, const V& v)
+    {
+      boost::format fmt (format);
+      fmt % u % v;
+      return fmt.str ();
+    }
+
+    /// \internal
+    /// \brief Compute the gradient of an operand.
+    inline void
+    algebraGradient (const DifferentiableFunction& fct,
+		     DifferentiableFunction::gradient_t& gradient,
+		     const DifferentiableFunction::argument_t& argument,
+		     DifferentiableFunction::size_type functionId)
+    {
+      fct.gradient (gradient, argument, functionId);
+    }
+
+    /// \internal
+    /// \brief Non-differentiable operands do not have a gradient.
+    inline void
+    algebraGradient (const Function&,
+		     DifferentiableFunction::gradient_t&,
+		     const DifferentiableFunction::argument_t&,
+		     DifferentiableFunction::size_type)
+    {
+      assert (0 && "operand is not differentiable");
+    }
+
+    /// \internal
+    /// \brief Compute the jacobian of an operand.
+    inline void
+    algebraJacobian (const DifferentiableFunction& fct,
+		     DifferentiableFunction::jacobian_t& jacobian,
+		     const DifferentiableFunction::argument_t& argument)
+    {
+      fct.jacobian (jacobian, argument);
+    }
+
+    /// \internal
+    /// \brief Non-differentiable operands do not have a jacobian.
+    inline void
+    algebraJacobian (const Function&,
+		     DifferentiableFunction::jacobian_t&,
+		     const DifferentiableFunction::argument_t&)
+    {
+      assert (0 && "operand is not differentiable");
+    }
+
+    /// \internal
+    /// \brief Evaluation of a term of a linear combination.
+    ///
+    /// Compute \f$c u(x)\f$ into the result or add it to the
+    /// result. Generic operands are evaluated through their virtual
+    /// interface, the buffer is used to hold their value before it is
+    /// added. Sums and scaled functions are traversed through their
+    /// static type instead (see the specializations below): a whole
+    /// linear combination is therefore evaluated by its root node, in
+    /// one pass, with a single buffer and no virtual call to the
+    /// intermediate nodes.
+    template <typename T>
+    struct LinearCombination
+    {
+      typedef DifferentiableFunction::value_type value_type;
+      typedef DifferentiableFunction::size_type size_type;
+      typedef DifferentiableFunction::vector_t vector_t;
+      typedef DifferentiableFunction::argument_t argument_t;
+      typedef DifferentiableFunction::jacobian_t jacobian_t;
+
+      /// \brief Is the operand traversed statically?
+      static const bool fused = false;
+
+      static void
+      assign (const T& u, vector_t& result, const argument_t& argument,
+	      value_type c, vector_t&)
+      {
+	u (result, argument);
+	if (c != 1.)
+	  result *= c;
+      }
+
+      static void
+      add (const T& u, vector_t& result, const argument_t& argument,
+	   value_type c, vector_t& buffer)
+      {
+	u (buffer, argument);
+	result += c * buffer;
+      }
+
+      static void
+      assignGradient (const T& u, vector_t& gradient,
+		      const argument_t& argument, size_type functionId,
+		      value_type c, vector_t&)
+      {
+	algebraGradient (u, gradient, argument, functionId);
+	if (c != 1.)
+	  gradient *= c;
+      }
+
+      static void
+      addGradient (const T& u, vector_t& gradient,
+		   const argument_t& argument, size_type functionId,
+		   value_type c, vector_t& buffer)
+      {
+	algebraGradient (u, buffer, argument, functionId);
+	gradient += c * buffer;
+      }
+
+      static void
+      assignJacobian (const T& u, jacobian_t& jacobian,
+		      const argument_t& argument,
+		      value_type c, jacobian_t&)
+      {
+	algebraJacobian (u, jacobian, argument);
+	if (c != 1.)
+	  jacobian *= c;
+      }
+
+      static void
+      addJacobian (const T& u, jacobian_t& jacobian,
+		   const argument_t& argument,
+		   value_type c, jacobian_t& buffer)
+      {
+	algebraJacobian (u, buffer, argument);
+	jacobian += c * buffer;
+      }
+    };
+
+    /// \internal
+    /// \brief A sum contributes both of its operands.
+    template <typename U, typename V>
+    struct LinearCombination<Plus<U, V> >
+    {
+      typedef DifferentiableFunction::value_type value_type;
+      typedef DifferentiableFunction::size_type size_type;
+      typedef DifferentiableFunction::vector_t vector_t;
+      typedef DifferentiableFunction::argument_t argument_t;
+      typedef DifferentiableFunction::jacobian_t jacobian_t;
+
+      static const bool fused = true;
+
+      static void
+      assign (const Plus<U, V>& u, vector_t& result,
+	      const argument_t& argument, value_type c, vector_t& buffer)
+      {
+	LinearCombination<U>::assign (*u.left (), result, argument, c, buffer);
+	LinearCombination<V>::add (*u.right (), result, argument, c, buffer);
+      }
+
+      static void
+      add (const Plus<U, V>& u, vector_t& result,
+	   const argument_t& argument, value_type c, vector_t& buffer)
+      {
+	LinearCombination<U>::add (*u.left (), result, argument, c, buffer);
+	LinearCombination<V>::add (*u.right (), result, argument, c, buffer);
+      }
+
+      static void
+      assignGradient (const Plus<U, V>& u, vector_t& gradient,
+		      const argument_t& argument, size_type functionId,
+		      value_type c, vector_t& buffer)
+      {
+	LinearCombination<U>::assignGradient
+	  (*u.left (), gradient, argument, functionId, c, buffer);
+	LinearCombination<V>::addGradient
+	  (*u.right (), gradient, argument, functionId, c, buffer);
+      }
+
+      static void
+      addGradient (const Plus<U, V>& u, vector_t& gradient,
+		   const argument_t& argument, size_type functionId,
+		   value_type c, vector_t& buffer)
+      {
+	LinearCombination<U>::addGradient
+	  (*u.left (), gradient, argument, functionId, c, buffer);
+	LinearCombination<V>::addGradient
+	  (*u.right (), gradient, argument, functionId, c, buffer);
+      }
+
+      static void
+      assignJacobian (const Plus<U, V>& u, jacobian_t& jacobian,
+		      const argument_t& argument,
+		      value_type c, jacobian_t& buffer)
+      {
+	LinearCombination<U>::assignJacobian
+	  (*u.left (), jacobian, argument, c, buffer);
+	LinearCombination<V>::addJacobian
+	  (*u.right (), jacobian, argument, c, buffer);
+      }
+
+      static void
+      addJacobian (const Plus<U, V>& u, jacobian_t& jacobian,
+		   const argument_t& argument,
+		   value_type c, jacobian_t& buffer)
+      {
+	LinearCombination<U>::addJacobian
+	  (*u.left (), jacobian, argument, c, buffer);
+	LinearCombination<V>::addJacobian
+	  (*u.right (), jacobian, argument, c, buffer);
+      }
+    };
+
+    /// \internal
+    /// \brief A scaled function only contributes its coefficient.
+    template <typename U>
+    struct LinearCombination<Scalar<U> >
+    {
+      typedef DifferentiableFunction::value_type value_type;
+      typedef DifferentiableFunction::size_type size_type;
+      typedef DifferentiableFunction::vector_t vector_t;
+      typedef DifferentiableFunction::argument_t argument_t;
+      typedef DifferentiableFunction::jacobian_t jacobian_t;
+
+      static const bool fused = LinearCombination<U>::fused;
+
+      static void
+      assign (const Scalar<U>& u, vector_t& result,
+	      const argument_t& argument, value_type c, vector_t& buffer)
+      {
+	LinearCombination<U>::assign
+	  (*u.function (), result, argument, c * u.scalar (), buffer);
+      }
+
+      static void
+      add (const Scalar<U>& u, vector_t& result,
+	   const argument_t& argument, value_type c, vector_t& buffer)
+      {
+	LinearCombination<U>::add
+	  (*u.function (), result, argument, c * u.scalar (), buffer);
+      }
+
+      static void
+      assignGradient (const Scalar<U>& u, vector_t& gradient,
+		      const argument_t& argument, size_type functionId,
+		      value_type c, vector_t& buffer)
+      {
+	LinearCombination<U>::assignGradient
+	  (*u.function (), gradient, argument, functionId,
+	   c * u.scalar (), buffer);
+      }
+
+      static void
+      addGradient (const Scalar<U>& u, vector_t& gradient,
+		   const argument_t& argument, size_type functionId,
+		   value_type c, vector_t& buffer)
+      {
+	LinearCombination<U>::addGradient
+	  (*u.function (), gradient, argument, functionId,
+	   c * u.scalar (), buffer);
+      }
+
+      static void
+      assignJacobian (const Scalar<U>& u, jacobian_t& jacobian,
+		      const argument_t& argument,
+		      value_type c, jacobian_t& buffer)
+      {
+	LinearCombination<U>::assignJacobian
+	  (*u.function (), jacobian, argument, c * u.scalar (), buffer);
+      }
+
+      static void
+      addJacobian (const Scalar<U>& u, jacobian_t& jacobian,
+		   const argument_t& argument,
+		   value_type c, jacobian_t& buffer)
+      {
+	LinearCombination<U>::addJacobian
+	  (*u.function (), jacobian, argument, c * u.scalar (), buffer);
+      }
+    };
+  } // end of namespace detail.
+
+  // Plus.
+
+  template <typename U, typename V>
+  Plus<U, V>::Plus (boost::shared_ptr<const U> left,
+		    boost::shared_ptr<const V> right) throw ()
+    : detail::AlgebraBase<U, V>::type
+      (left->inputSize (), left->outputSize (),
+       detail::algebraName ("(%1% + %2%)",
+			    left->getName (), right->getName ())),
+      left_ (left),
+      right_ (right),
+      value_ (left->outputSize ()),
+      gradient_ (left->inputSize ()),
+      jacobian_ ()
+  {
+    assert (left->inputSize () == right->inputSize ());
+    assert (left->outputSize () == right->outputSize ());
+
+    // Only differentiable expressions require a jacobian buffer.
+    if (boost::is_base_of<DifferentiableFunction, Plus<U, V> >::value)
+      jacobian_.resize (left->outputSize (), left->inputSize ());
+  }
+
+  template <typename U, typename V>
+  Plus<U, V>::~Plus () throw ()
+  {
+  }
+
+  template <typename U, typename V>
+  const boost::shared_ptr<const U>&
+  Plus<U, V>::left () const throw ()
+  {
+    return left_;
+  }
+
+  template <typename U, typename V>
+  const boost::shared_ptr<const V>&
+  Plus<U, V>::right () const throw ()
+  {
+    return right_;
+  }
+
+  template <typename U, typename V>
+  Function::structure_t
+  Plus<U, V>::structure () const throw ()
+  {
+    return detail::intersectStructure (left_->structure (),
+				       right_->structure ());
+  }
+
+  template <typename U, typename V>
+  void
+  Plus<U, V>::impl_compute (result_t& result, const argument_t& argument)
+    const throw ()
+  {
+    detail::LinearCombination<Plus<U, V> >::assign
+      (*this, result, argument, 1., value_);
+  }
+
+  template <typename U, typename V>
+  void
+  Plus<U, V>::impl_gradient (gradient_t& gradient,
+			     const argument_t& argument,
+			     size_type functionId)
+    const throw ()
+  {
+    detail::LinearCombination<Plus<U, V> >::assignGradient
+      (*this, gradient, argument, functionId, 1., gradient_);
+  }
+
+  template <typename U, typename V>
+  void
+  Plus<U, V>::impl_jacobian (jacobian_t& jacobian,
+			     const argument_t& argument)
+    const throw ()
+  {
+    detail::LinearCombination<Plus<U, V> >::assignJacobian
+      (*this, jacobian, argument, 1., jacobian_);
+  }
+
+  // Scalar.
+
+  template <typename U>
+  Scalar<U>::Scalar (boost::shared_ptr<const U> function,
+		     value_type scalar) throw ()
+    : detail::AlgebraBase<U>::type
+      (function->inputSize (), function->outputSize (),
+       detail::algebraName ("(%1% * %2%)", scalar, function->getName ())),
+      function_ (function),
+      scalar_ (scalar),
+      value_ (),
+      gradient_ (),
+      jacobian_ ()
+  {
+    // Buffers are only used when the operand is itself a linear
+    // combination.
+    if (!detail::LinearCombination<U>::fused)
+      return;
+
+    value_.resize (function->outputSize ());
+    gradient_.resize (function->inputSize ());
+    if (boost::is_base_of<DifferentiableFunction, Scalar<U> >::value)
+      jacobian_.resize (function->outputSize (), function->inputSize ());
+  }
+
+  template <typename U>
+  Scalar<U>::~Scalar () throw ()
+  {
+  }
+
+  template <typename U>
+  const boost::shared_ptr<const U>&
+  Scalar<U>::function () const throw ()
+  {
+    return function_;
+  }
+
+  template <typename U>
+  typename Scalar<U>::value_type
+  Scalar<U>::scalar () const throw ()
+  {
+    return scalar_;
+  }
+
+  template <typename U>
+  Function::structure_t
+  Scalar<U>::structure () const throw ()
+  {
+    return function_->structure ();
+  }
+
+  template <typename U>
+  void
+  Scalar<U>::impl_compute (result_t& result, const argument_t& argument)
+    const throw ()
+  {
+    detail::LinearCombination<Scalar<U> >::assign
+      (*this, result, argument, 1., value_);
+  }
+
+  template <typename U>
+  void
+  Scalar<U>::impl_gradient (gradient_t& gradient,
+			    const argument_t& argument,
+			    size_type functionId)
+    const throw ()
+  {
+    detail::LinearCombination<Scalar<U> >::assignGradient
+      (*this, gradient, argument, functionId, 1., gradient_);
+  }
+
+  template <typename U>
+  void
+  Scalar<U>::impl_jacobian (jacobian_t& jacobian,
+			    const argument_t& argument)
+    const throw ()
+  {
+    detail::LinearCombination<Scalar<U> >::assignJacobian
+      (*this, jacobian, argument, 1., jacobian_);
+  }
+
+  // Product.
+
+  template <typename U, typename V>
+  Product<U, V>::Product (boost::shared_ptr<const U> left,
+			  boost::shared_ptr<const V> right) throw ()
+    : detail::AlgebraBase<U, V>::type
+      (left->inputSize (), left->outputSize (),
+       detail::algebraName ("(%1% * %2%)",
+			    left->getName (), right->getName ())),
+      left_ (left),
+      right_ (right),
+      leftValue_ (left->outputSize ()),
+      rightValue_ (left->outputSize ()),
+      valuesX_ (left->inputSize ()),
+      valuesValid_ (false),
+      gradient_ (left->inputSize ()),
+      jacobian_ ()
+  {
+    assert (left->inputSize () == right->inputSize ());
+    assert (left->outputSize () == right->outputSize ());
+
+    if (boost::is_base_of<DifferentiableFunction, Product<U, V> >::value)
+      jacobian_.resize (left->outputSize (), left->inputSize ());
+  }
+
+  template <typename U, typename V>
+  Product<U, V>::~Product () throw ()
+  {
+  }
+
+  template <typename U, typename V>
+  const boost::shared_ptr<const U>&
+  Product<U, V>::left () const throw ()
+  {
+    return left_;
+  }
+
+  template <typename U, typename V>
+  const boost::shared_ptr<const V>&
+  Product<U, V>::right () const throw ()
+  {
+    return right_;
+  }
+
+  template <typename U, typename V>
+  Function::structure_t
+  Product<U, V>::structure () const throw ()
+  {
+    if (left_->hasStructure (Function::LINEAR)
+	&& right_->hasStructure (Function::LINEAR))
+      return Function::QUADRATIC | Function::CONSTANT_HESSIAN;
+    return 0;
+  }
+
+  template <typename U, typename V>
+  void
+  Product<U, V>::impl_compute (result_t& result, const argument_t& argument)
+    const throw ()
+  {
+    // The right operand buffer is overwritten: the cache is lost.
+    valuesValid_ = false;
+    (*left_) (result, argument);
+    (*right_) (rightValue_, argument);
+    result.array () *= rightValue_.array ();
+  }
+
+  template <typename U, typename V>
+  void
+  Product<U, V>::impl_gradient (gradient_t& gradient,
+				const argument_t& argument,
+				size_type functionId)
+    const throw ()
+  {
+    if (!valuesValid_ || valuesX_ != argument)
+      {
+	(*left_) (leftValue_, argument);
+	(*right_) (rightValue_, argument);
+	valuesX_ = argument;
+	valuesValid_ = true;
+      }
+
+    // v_i grad u_i + u_i grad v_i
+    detail::algebraGradient (*left_, gradient, argument, functionId);
+    gradient *= rightValue_[functionId];
+    detail::algebraGradient (*right_, gradient_, argument, functionId);
+    gradient += leftValue_[functionId] * gradient_;
+  }
+
+  template <typename U, typename V>
+  void
+  Product<U, V>::impl_jacobian (jacobian_t& jacobian,
+				const argument_t& argument)
+    const throw ()
+  {
+    (*left_) (leftValue_, argument);
+    (*right_) (rightValue_, argument);
+    valuesX_ = argument;
+    valuesValid_ = true;
+
+    // diag (v) J_u + diag (u) J_v
+    detail::algebraJacobian (*left_, jacobian, argument);
+    jacobian.array ().colwise () *= rightValue_.array ();
+    detail::algebraJacobian (*right_, jacobian_, argument);
+    jacobian_.array ().colwise () *= leftValue_.array ();
+    jacobian += jacobian_;
+  }
+
+  // Composition.
+
+  template <typename U, typename V>
+  Composition<U, V>::Composition (boost::shared_ptr<const U> outer,
+				  boost::shared_ptr<const V> inner) throw ()
+    : detail::AlgebraBase<U, V>::type
+      (inner->inputSize (), outer->outputSize (),
+       detail::algebraName ("%1% (%2%)",
+			    outer->getName (), inner->getName ())),
+      outer_ (outer),
+      inner_ (inner),
+      value_ (inner->outputSize ()),
+      gradient_ (outer->inputSize ()),
+      outerJacobian_ (),
+      innerJacobian_ (),
+      jacobianX_ (inner->inputSize ()),
+      jacobianValid_ (false)
+  {
+    assert (outer->inputSize () == inner->outputSize ());
+
+    if (boost::is_base_of<DifferentiableFunction, Composition<U, V> >::value)
+      {
+	outerJacobian_.resize (outer->outputSize (), outer->inputSize ());
+	innerJacobian_.resize (inner->outputSize (), inner->inputSize ());
+      }
+  }
+
+  template <typename U, typename V>
+  Composition<U, V>::~Composition () throw ()
+  {
+  }
+
+  template <typename U, typename V>
+  const boost::shared_ptr<const U>&
+  Composition<U, V>::outer () const throw ()
+  {
+    return outer_;
+  }
+
+  template <typename U, typename V>
+  const boost::shared_ptr<const V>&
+  Composition<U, V>::inner () const throw ()
+  {
+    return inner_;
+  }
+
+  template <typename U, typename V>
+  Function::structure_t
+  Composition<U, V>::structure () const throw ()
+  {
+    return detail::composeStructure (outer_->structure (),
+				     inner_->structure ());
+  }
+
+  template <typename U, typename V>
+  void
+  Composition<U, V>::impl_compute (result_t& result,
+				   const argument_t& argument)
+    const throw ()
+  {
+    // The inner value buffer is overwritten: the cache is lost.
+    jacobianValid_ = false;
+    (*inner_) (value_, argument);
+    (*outer_) (result, value_);
+  }
+
+  template <typename U, typename V>
+  void
+  Composition<U, V>::impl_gradient (gradient_t& gradient,
+				    const argument_t& argument,
+				    size_type functionId)
+    const throw ()
+  {
+    // J_v (x)^T grad u_i (v (x))
+    if (!jacobianValid_ || jacobianX_ != argument)
+      {
+	(*inner_) (value_, argument);
+	detail::algebraJacobian (*inner_, innerJacobian_, argument);
+	jacobianX_ = argument;
+	jacobianValid_ = true;
+      }
+    detail::algebraGradient (*outer_, gradient_, value_, functionId);
+    gradient.noalias () = innerJacobian_.transpose () * gradient_;
+  }
+
+  template <typename U, typename V>
+  void
+  Composition<U, V>::impl_jacobian (jacobian_t& jacobian,
+				    const argument_t& argument)
+    const throw ()
+  {
+    // J_u (v (x)) J_v (x)
+    (*inner_) (value_, argument);
+    detail::algebraJacobian (*outer_, outerJacobian_, value_);
+    detail::algebraJacobian (*inner_, innerJacobian_, argument);
+    jacobianX_ = argument;
+    jacobianValid_ = true;
+    jacobian.noalias () = outerJacobian_ * innerJacobian_;
+  }
+
+  // Concatenate.
+
+  template <typename U, typename V>
+  Concatenate<U, V>::Concatenate (boost::shared_ptr<const U> top,
+				  boost::shared_ptr<const V> bottom) throw ()
+    : detail::AlgebraBase<U, V>::type
+      (top->inputSize (), top->outputSize () + bottom->outputSize (),
+       detail::algebraName ("(%1%; %2%)",
+			    top->getName (), bottom->getName ())),
+      top_ (top),
+      bottom_ (bottom),
+      topValue_ (top->outputSize ()),
+      bottomValue_ (bottom->outputSize ()),
+      topJacobian_ (),
+      bottomJacobian_ ()
+  {
+    assert (top->inputSize () == bottom->inputSize ());
+
+    if (boost::is_base_of<DifferentiableFunction, Concatenate<U, V> >::value)
+      {
+	topJacobian_.resize (top->outputSize (), top->inputSize ());
+	bottomJacobian_.resize (bottom->outputSize (), bottom->inputSize ());
+      }
+  }
+
+  template <typename U, typename V>
+  Concatenate<U, V>::~Concatenate () throw ()
+  {
+  }
+
+  template <typename U, typename V>
+  const boost::shared_ptr<const U>&
+  Concatenate<U, V>::top () const throw ()
+  {
+    return top_;
+  }
+
+  template <typename U, typename V>
+  const boost::shared_ptr<const V>&
+  Concatenate<U, V>::bottom () const throw ()
+  {
+    return bottom_;
+  }
+
+  template <typename U, typename V>
+  Function::structure_t
+  Concatenate<U, V>::structure () const throw ()
+  {
+    return detail::intersectStructure (top_->structure (),
+				       bottom_->structure ());
+  }
+
+  template <typename U, typename V>
+  void
+  Concatenate<U, V>::impl_compute (result_t& result,
+				   const argument_t& argument)
+    const throw ()
+  {
+    (*top_) (topValue_, argument);
+    (*bottom_) (bottomValue_, argument);
+    result.head (topValue_.size ()) = topValue_;
+    result.tail (bottomValue_.size ()) = bottomValue_;
+  }
+
+  template <typename U, typename V>
+  void
+  Concatenate<U, V>::impl_gradient (gradient_t& gradient,
+				    const argument_t& argument,
+				    size_type functionId)
+    const throw ()
+  {
+    if (functionId < top_->outputSize ())
+      detail::algebraGradient (*top_, gradient, argument, functionId);
+    else
+      detail::algebraGradient (*bottom_, gradient, argument,
+			       functionId - top_->outputSize ());
+  }
+
+  template <typename U, typename V>
+  void
+  Concatenate<U, V>::impl_jacobian (jacobian_t& jacobian,
+				    const argument_t& argument)
+    const throw ()
+  {
+    detail::algebraJacobian (*top_, topJacobian_, argument);
+    detail::algebraJacobian (*bottom_, bottomJacobian_, argument);
+    jacobian.topRows (topJacobian_.rows ()) = topJacobian_;
+    jacobian.bottomRows (bottomJacobian_.rows ()) = bottomJacobian_;
+  }
+
+  // Operators.
+
+  template <typename U, typename V>
+  typename detail::EnableIfFunctions
+  <U, V, boost::shared_ptr<Plus<U, V> > >::type
+  operator+ (boost::shared_ptr<U> left, boost::shared_ptr<V> right)
+  {
+    return boost::make_shared<Plus<U, V> > (left, right);
+  }
+
+  template <typename U, typename V>
+  typename detail::EnableIfFunctions
+  <U, V, boost::shared_ptr<Plus<U, Scalar<V> > > >::type
+  operator- (boost::shared_ptr<U> left, boost::shared_ptr<V> right)
+  {
+    boost::shared_ptr<Scalar<V> > opposite =
+      boost::make_shared<Scalar<V> > (right, -1.);
+    return boost::make_shared<Plus<U, Scalar<V> > > (left, opposite);
+  }
+
+  template <typename U>
+  typename detail::EnableIfFunctions
+  <U, U, boost::shared_ptr<Scalar<U> > >::type
+  operator* (Function::value_type scalar, boost::shared_ptr<U> function)
+  {
+    return boost::make_shared<Scalar<U> > (function, scalar);
+  }
+
+  template <typename U>
+  typename detail::EnableIfFunctions
+  <U, U, boost::shared_ptr<Scalar<U> > >::type
+  operator* (boost::shared_ptr<U> function, Function::value_type scalar)
+  {
+    return boost::make_shared<Scalar<U> > (function, scalar);
+  }
+
+  template <typename U, typename V>
+  typename detail::EnableIfFunctions
+  <U, V, boost::shared_ptr<Product<U, V> > >::type
+  operator* (boost::shared_ptr<U> left, boost::shared_ptr<V> right)
+  {
+    return boost::make_shared<Product<U, V> > (left, right);
+  }
+
+  template <typename U, typename V>
+  boost::shared_ptr<Composition<U, V> >
+  compose (boost::shared_ptr<U> outer, boost::shared_ptr<V> inner)
+  {
+    return boost::make_shared<Composition<U, V> > (outer, inner);
+  }
+
+  template <typename U, typename V>
+  boost::shared_ptr<Concatenate<U, V> >
+  concatenate (boost::shared_ptr<U> top, boost::shared_ptr<V> bottom)
+  {
+    return boost::make_shared<Concatenate<U, V> > (top, bottom);
+  }
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_FILTER_ALGEBRA_HXX
@@ -0,0 +1,170 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_FILTER_CHAIN_HH
+# define ROBOPTIM_CORE_FILTER_CHAIN_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <vector>
+
+# include <boost/shared_ptr.hpp>
+
+# include <roboptim/core/differentiable-function.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_filter
+  /// @{
+
+  /// \brief Composition of a sequence of differentiable functions.
+  ///
+  /// The functions are applied in the sequence order:
+  /// \f[f(x) = f_{n-1} (\cdots f_1 (f_0 (x)))\f]
+  /// and the jacobian is the product
+  /// \f$J_{n-1} \cdots J_1 J_0\f$ of the stages jacobians, each of
+  /// them being evaluated at the stage input.
+  ///
+  /// The cost of this product depends on the multiplication order:
+  /// multiplying from the left (reverse accumulation) is cheap when
+  /// the chain narrows, multiplying from the right (forward
+  /// accumulation) when it widens. As the stages dimensions are
+  /// known when the chain is built, the optimal parenthesization is
+  /// computed once by the classical matrix-chain ordering dynamic
+  /// program and reused for each jacobian evaluation.
+  ///
+  /// Intermediate values are computed once per evaluation, all the
+  /// buffers (values, stages jacobians and partial products) are
+  /// allocated when the chain is built. Gradients are computed by
+  /// reverse accumulation (vector-jacobian products), the stages
+  /// values and jacobians being cached per argument: requesting all
+  /// the gradients at a same point evaluates the stages once. Stages
+  /// therefore have to be pure functions.
+  ///
+  /// \warning Evaluation buffers are shared, the chain must not be
+  /// evaluated concurrently.
+  class ROBOPTIM_DLLAPI Chain : public DifferentiableFunction
+  {
+  public:
+    /// \brief Stage type.
+    typedef boost::shared_ptr<const DifferentiableFunction> stage_t;
+    /// \brief Stages list type.
+    typedef std::vector<stage_t> stages_t;
+
+    /// \brief Build a chain.
+    ///
+    /// \param stages functions applied in this order, each stage
+    /// input size has to be the previous stage output size
+    /// \throw std::runtime_error if there is no stage or if the
+    /// stages sizes do not match
+    explicit Chain (const stages_t& stages);
+    ~Chain () throw ();
+
+    /// \brief Stages, in the application order.
+    const stages_t& stages () const throw ();
+
+    /// \brief Number of scalar multiplications of the jacobian product.
+    ///
+    /// This is the cost of the optimal ordering used by the chain.
+    size_type productCost () const throw ();
+
+    /// \brief Linear and quadratic properties of the composition.
+    virtual structure_t structure () const throw ();
+
+    /// \brief Display the function on the specified output stream.
+    ///
+    /// The jacobian product ordering is displayed, \f$J_k\f$ being
+    /// the k-th stage jacobian.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    virtual std::ostream& print (std::ostream& o) const throw ();
+
+  protected:
+    void impl_compute (result_t& result, const argument_t& argument)
+      const throw ();
+    void impl_gradient (gradient_t& gradient,
+			const argument_t& argument,
+			size_type functionId = 0)
+      const throw ();
+    void impl_jacobian (jacobian_t& jacobian, const argument_t& argument)
+      const throw ();
+
+  private:
+    /// \brief Partial product of the stages jacobians.
+    ///
+    /// Leaves are the stages jacobians, an internal node is the
+    /// product of its left and right children.
+    struct Product
+    {
+      /// \brief Left operand node (-1 for leaves).
+      int left;
+      /// \brief Right operand node (-1 for leaves).
+      int right;
+      /// \brief Stage index (leaves only).
+      std::size_t stage;
+    };
+
+    /// \brief Build the optimal product tree from the split table.
+    ///
+    /// Jacobians are indexed by their position in the product:
+    /// \f$J_{n-1}\f$ is at position 0.
+    ///
+    /// \return index of the built node
+    int buildProduct (const std::vector<std::vector<std::size_t> >& split,
+		      std::size_t i, std::size_t j) throw ();
+
+    /// \brief Print a product tree node.
+    void printProduct (std::ostream& o, int node) const throw ();
+
+    /// \brief Evaluate the first stages and, optionally, their jacobians.
+    void computeStages (const argument_t& argument, std::size_t count,
+			bool jacobians) const throw ();
+
+    /// \brief Product operand (stage jacobian or partial product).
+    const jacobian_t& operand (int node) const throw ();
+
+    /// \brief Stages.
+    stages_t stages_;
+    /// \brief Stages values.
+    mutable std::vector<vector_t> values_;
+    /// \brief Stages jacobians.
+    mutable std::vector<jacobian_t> jacobians_;
+    /// \brief Reverse accumulation buffers (one per stage input).
+    mutable std::vector<gradient_t> adjoints_;
+    /// \brief Argument at which the stages values and jacobians are cached.
+    mutable argument_t jacobianX_;
+    /// \brief Are the cached stages values and jacobians valid?
+    mutable bool jacobianValid_;
+
+    /// \brief Product tree nodes.
+    std::vector<Product> products_;
+    /// \brief Internal nodes, children first.
+    std::vector<int> schedule_;
+    /// \brief Partial products buffers (internal nodes only).
+    mutable std::vector<jacobian_t> partials_;
+    /// \brief Product tree root.
+    int root_;
+    /// \brief Optimal product cost.
+    size_type cost_;
+  };
+
+  /// @}
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_FILTER_CHAIN_HH
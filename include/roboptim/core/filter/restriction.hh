@@ -0,0 +1,140 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_FILTER_RESTRICTION_HH
+# define ROBOPTIM_CORE_FILTER_RESTRICTION_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <vector>
+
+# include <boost/shared_ptr.hpp>
+
+# include <roboptim/core/n-times-derivable-function.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_filter
+  /// @{
+
+  /// \brief Restrict a function to a subset of its variables.
+  ///
+  /// The other variables are fixed to given values: the restriction
+  /// of \f$f\f$ to the free variables \f$x_{i_0}, \cdots, x_{i_k}\f$
+  /// is \f$g(y) = f(x)\f$ where \f$x_{i_j} = y_j\f$ and where the
+  /// other components of \f$x\f$ are fixed.
+  ///
+  /// Derivatives are computed on the whole function and the
+  /// relevant entries are extracted: the jacobian is evaluated once,
+  /// into a preallocated buffer, and its free columns are gathered.
+  ///
+  /// Fixing variables preserves the structure of the function, which
+  /// is forwarded.
+  ///
+  /// \warning Evaluation buffers are shared, the restriction must not
+  /// be evaluated concurrently.
+  ///
+  /// \tparam T function type, has to be constructible from
+  /// (inputSize, outputSize, name) as the Split filter.
+  template <typename T>
+  class ROBOPTIM_DLLAPI Restriction : public T
+  {
+  public:
+    /// \brief Import value type.
+    typedef typename DifferentiableFunction::value_type value_type;
+    /// \brief Import size type.
+    typedef typename DifferentiableFunction::size_type size_type;
+    /// \brief Import vector type.
+    typedef typename DifferentiableFunction::vector_t vector_t;
+    /// \brief Import result type.
+    typedef typename DifferentiableFunction::result_t result_t;
+    /// \brief Import argument type.
+    typedef typename DifferentiableFunction::argument_t argument_t;
+    /// \brief Import gradient type.
+    typedef typename DifferentiableFunction::gradient_t gradient_t;
+    /// \brief Import hessian type.
+    typedef typename TwiceDifferentiableFunction::hessian_t hessian_t;
+    /// \brief Import jacobian type.
+    typedef typename DifferentiableFunction::jacobian_t jacobian_t;
+
+    /// \brief Restrict a function.
+    ///
+    /// \param fct function which will be restricted
+    /// \param point full argument, free variables values are ignored
+    /// \param freeVariables indices of the free variables
+    explicit Restriction (boost::shared_ptr<const T> fct,
+			  const argument_t& point,
+			  const std::vector<size_type>& freeVariables)
+      throw ();
+    ~Restriction () throw ();
+
+    /// \brief Retrieve the underlying function.
+    const boost::shared_ptr<const T>& function () const throw ();
+
+    /// \brief Indices of the free variables.
+    const std::vector<size_type>& freeVariables () const throw ();
+
+    /// \brief Build the full argument from the free variables values.
+    ///
+    /// \param full full argument, has to be of the underlying
+    /// function input size
+    /// \param argument free variables values
+    void expand (argument_t& full, const argument_t& argument)
+      const throw ();
+
+    /// \brief Structural properties of the underlying function.
+    virtual Function::structure_t structure () const throw ();
+
+  protected:
+    virtual void impl_compute (result_t& result, const argument_t& argument)
+      const throw ();
+
+    virtual void impl_gradient (gradient_t& gradient,
+				const argument_t& argument,
+				size_type functionId = 0)
+      const throw ();
+
+    virtual void impl_jacobian (jacobian_t& jacobian,
+				const argument_t& argument)
+      const throw ();
+
+    virtual void impl_hessian (hessian_t& hessian,
+			       const argument_t& argument,
+			       size_type functionId = 0) const throw ();
+
+  private:
+    /// \brief Restricted function.
+    boost::shared_ptr<const T> function_;
+    /// \brief Free variables.
+    std::vector<size_type> free_;
+
+    /// \brief Full argument (fixed variables are set once).
+    mutable argument_t x_;
+    /// \brief Full gradient buffer.
+    mutable gradient_t gradient_;
+    /// \brief Full jacobian buffer.
+    mutable jacobian_t jacobian_;
+    /// \brief Full hessian buffer.
+    mutable hessian_t hessian_;
+  };
+
+  /// @}
+
+} // end of namespace roboptim
+
+# include <roboptim/core/filter/restriction.hxx>
+#endif //! ROBOPTIM_CORE_FILTER_RESTRICTION_HH
@@ -0,0 +1,182 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_FILTER_RESTRICTION_HXX
+# define ROBOPTIM_CORE_FILTER_RESTRICTION_HXX
+# include <boost/format.hpp>
+# include <boost/type_traits/is_base_of.hpp>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    template <typename T>
+    std::string restrictionName (const T& fct)
+    {
+      boost::format fmt ("%1% (restriction)");
+      fmt % fct.getName ();
+      return fmt.str ();
+    }
+  } // end of namespace detail.
+
+  template <typename T>
+  Restriction<T>::Restriction (boost::shared_ptr<const T> fct,
+			       const argument_t& point,
+			       const std::vector<size_type>& freeVariables)
+    throw ()
+    : T (static_cast<size_type> (freeVariables.size ()),
+	 fct->outputSize (), detail::restrictionName (*fct)),
+      function_ (fct),
+      free_ (freeVariables),
+      x_ (point),
+      gradient_ (fct->inputSize ()),
+      jacobian_ (),
+      hessian_ ()
+  {
+    assert (point.size () == fct->inputSize ());
+    for (std::size_t i = 0; i < free_.size (); ++i)
+      assert (free_[i] < fct->inputSize ());
+
+    // Only differentiable functions require a jacobian buffer.
+    if (boost::is_base_of<DifferentiableFunction, T>::value)
+      jacobian_.resize (fct->outputSize (), fct->inputSize ());
+
+    // Only twice differentiable functions require a hessian buffer.
+    if (boost::is_base_of<TwiceDifferentiableFunction, T>::value)
+      hessian_.resize (fct->inputSize (), fct->inputSize ());
+  }
+
+  template <typename T>
+  Restriction<T>::~Restriction () throw ()
+  {
+  }
+
+  template <typename T>
+  const boost::shared_ptr<const T>&
+  Restriction<T>::function () const throw ()
+  {
+    return function_;
+  }
+
+  template <typename T>
+  const std::vector<typename Restriction<T>::size_type>&
+  Restriction<T>::freeVariables () const throw ()
+  {
+    return free_;
+  }
+
+  template <typename T>
+  void
+  Restriction<T>::expand (argument_t& full, const argument_t& argument)
+    const throw ()
+  {
+    assert (argument.size () == this->inputSize ());
+    for (std::size_t i = 0; i < free_.size (); ++i)
+      full[free_[i]] = argument[i];
+  }
+
+  template <typename T>
+  Function::structure_t
+  Restriction<T>::structure () const throw ()
+  {
+    return function_->structure ();
+  }
+
+  template <typename T>
+  void
+  Restriction<T>::impl_compute (result_t& result,
+				const argument_t& argument)
+    const throw ()
+  {
+    expand (x_, argument);
+    (*function_) (result, x_);
+  }
+
+  template <>
+  inline void
+  Restriction<Function>::impl_gradient (gradient_t&, const argument_t&,
+					size_type) const throw ()
+  {
+    assert (0);
+  }
+
+  template <typename T>
+  void
+  Restriction<T>::impl_gradient (gradient_t& gradient,
+				 const argument_t& argument,
+				 size_type functionId)
+    const throw ()
+  {
+    expand (x_, argument);
+    function_->gradient (gradient_, x_, functionId);
+    for (std::size_t i = 0; i < free_.size (); ++i)
+      gradient[i] = gradient_[free_[i]];
+  }
+
+  template <>
+  inline void
+  Restriction<Function>::impl_jacobian (jacobian_t&, const argument_t&)
+    const throw ()
+  {
+    assert (0);
+  }
+
+  template <typename T>
+  void
+  Restriction<T>::impl_jacobian (jacobian_t& jacobian,
+				 const argument_t& argument)
+    const throw ()
+  {
+    expand (x_, argument);
+    function_->jacobian (jacobian_, x_);
+    for (std::size_t i = 0; i < free_.size (); ++i)
+      jacobian.col (static_cast<size_type> (i)) = jacobian_.col (free_[i]);
+  }
+
+  template <>
+  inline void
+  Restriction<Function>::impl_hessian
+  (hessian_t&, const argument_t&, size_type) const throw ()
+  {
+    assert (0);
+  }
+
+  template <>
+  inline void
+  Restriction<DifferentiableFunction>::impl_hessian
+  (hessian_t&, const argument_t&, size_type) const throw ()
+  {
+    assert (0);
+  }
+
+  template <typename T>
+  void
+  Restriction<T>::impl_hessian (hessian_t& hessian,
+				const argument_t& argument,
+				size_type functionId)
+    const throw ()
+  {
+    expand (x_, argument);
+    function_->hessian (hessian_, x_, functionId);
+    for (std::size_t j = 0; j < free_.size (); ++j)
+      for (std::size_t i = 0; i < free_.size (); ++i)
+	hessian (i, j) = hessian_ (free_[i], free_[j]);
+  }
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_FILTER_RESTRICTION_HXX
@@ -20,7 +20,9 @@
 # include <roboptim/core/sys.hh>
 # include <roboptim/core/debug.hh>
 
+# include <boost/scoped_ptr.hpp>
 # include <boost/shared_ptr.hpp>
+# include <boost/thread/mutex.hpp>
 
 # include <roboptim/core/n-times-derivable-function.hh>
 
@@ -29,9 +31,136 @@ namespace roboptim
   /// \addtogroup roboptim_filter
   /// @{
 
+  /// \brief Evaluation context shared by the splits of a same function.
+  ///
+  /// All the Split filters built on top of a given context evaluate
+  /// the underlying function only once per distinct argument: the
+  /// first split which is evaluated at a new point computes the whole
+  /// function and the other ones read their own component from the
+  /// stored result.
+  ///
+  /// The same mechanism is used for derivatives: the first gradient
+  /// request at a new point computes the whole jacobian and the
+  /// following ones only extract the relevant row. The jacobian
+  /// buffer is allocated by the first gradient request.
+  ///
+  /// By default, the context is not thread-safe. A concurrent context
+  /// serializes the accesses to the stored values so that splits of
+  /// a same function can be evaluated from different threads (e.g.
+  /// by a ConstraintsEvaluator using a thread pool, which makes the
+  /// contexts of its split constraints concurrent).
+  ///
+  /// \tparam T function type
+  template <typename T>
+  class SplitContext
+  {
+  public:
+    /// \brief Import size type.
+    typedef typename DifferentiableFunction::size_type size_type;
+    /// \brief Import value type.
+    typedef typename DifferentiableFunction::value_type value_type;
+    /// \brief Import result type.
+    typedef typename DifferentiableFunction::result_t result_t;
+    /// \brief Import argument type.
+    typedef typename DifferentiableFunction::argument_t argument_t;
+    /// \brief Import gradient type.
+    typedef typename DifferentiableFunction::gradient_t gradient_t;
+    /// \brief Import jacobian type.
+    typedef typename DifferentiableFunction::jacobian_t jacobian_t;
+
+    /// \brief Build a context from the function which will be split.
+    ///
+    /// \param fct function which will be shared by the splits
+    /// \param concurrent should the accesses be serialized?
+    explicit SplitContext (boost::shared_ptr<const T> fct,
+			   bool concurrent = false) throw ();
+    ~SplitContext () throw ();
+
+    /// \brief Retrieve the underlying function.
+    const boost::shared_ptr<const T>& function () const throw ();
+
+    /// \brief Evaluate one of the function components.
+    ///
+    /// The function is only evaluated if the argument differs from
+    /// the one used during the previous call.
+    ///
+    /// \param argument point at which the function will be evaluated
+    /// \param functionId component id
+    /// \return component value
+    value_type value (const argument_t& argument,
+		      size_type functionId) const throw ();
+
+    /// \brief Retrieve the gradient of one of the function components.
+    ///
+    /// The jacobian is only computed if the argument differs from
+    /// the one used during the previous call.
+    ///
+    /// \param gradient gradient will be stored in this argument
+    /// \param argument point at which the gradient will be computed
+    /// \param functionId component id
+    void gradient (gradient_t& gradient,
+		   const argument_t& argument,
+		   size_type functionId) const throw ();
+
+    /// \brief Invalidate the stored values.
+    ///
+    /// This has to be called if the underlying function is modified
+    /// (i.e. if it is not a pure function).
+    void reset () throw ();
+
+    /// \brief Are the accesses serialized?
+    bool concurrent () const throw ();
+
+    /// \brief Serialize the accesses from now on.
+    ///
+    /// \warning The context must not be in use while this method is
+    /// called.
+    void setConcurrent () throw ();
+
+  private:
+    /// \brief Shared function.
+    boost::shared_ptr<const T> function_;
+
+    /// \brief Protect the stored values (concurrent contexts only).
+    boost::scoped_ptr<boost::mutex> mutex_;
+
+    /// \brief Argument used for the last evaluation.
+    mutable argument_t x_;
+    /// \brief Result of the last evaluation.
+    mutable result_t res_;
+    /// \brief Is the last evaluation valid?
+    mutable bool valid_;
+
+    /// \brief Argument used for the last jacobian computation.
+    mutable argument_t jacobianX_;
+    /// \brief Result of the last jacobian computation (empty until
+    /// the first gradient request).
+    mutable jacobian_t jacobian_;
+    /// \brief Is the last jacobian valid?
+    mutable bool jacobianValid_;
+  };
+
+
+  /// \brief Split filters interface which does not depend on the
+  /// function type.
+  ///
+  /// Lets the users of a constraint reach the evaluation context of
+  /// a split whatever the constraint static type.
+  class ROBOPTIM_DLLAPI SplitBase
+  {
+  public:
+    virtual ~SplitBase () throw ()
+    {}
+
+    /// \brief Serialize the accesses to the evaluation context.
+    ///
+    /// \warning The context must not be in use while this method is
+    /// called.
+    virtual void setConcurrent () const throw () = 0;
+  };
 
   template <typename T>
-  class ROBOPTIM_DLLAPI Split : public T
+  class ROBOPTIM_DLLAPI Split : public T, public SplitBase
   {
   public:
     /// \brief Import value type.
@@ -53,10 +182,36 @@ namespace roboptim
     /// \brief Import interval type.
     typedef typename DifferentiableFunction::interval_t interval_t;
 
+    /// \brief Split context type.
+    typedef SplitContext<T> context_t;
+
+    /// \brief Split a function using a private evaluation context.
+    ///
+    /// As the context is not shared, gradients are directly computed
+    /// by the underlying function instead of extracted from its
+    /// jacobian.
+    ///
+    /// \param fct function which will be split
+    /// \param functionId component which will be kept
     explicit Split (boost::shared_ptr<const T> fct,
 		    size_type functionId) throw ();
+
+    /// \brief Split a function using a shared evaluation context.
+    ///
+    /// Splits sharing the same context evaluate the underlying
+    /// function only once per point.
+    ///
+    /// \param context context shared with the other splits
+    /// \param functionId component which will be kept
+    explicit Split (boost::shared_ptr<context_t> context,
+		    size_type functionId) throw ();
     ~Split () throw ();
 
+    /// \brief Retrieve the evaluation context.
+    const boost::shared_ptr<context_t>& context () const throw ();
+
+    virtual void setConcurrent () const throw ();
+
   protected:
     virtual void impl_compute (result_t& result, const argument_t& argument)
       const throw ();
@@ -76,18 +231,30 @@ namespace roboptim
     				  size_type order = 1) const throw ();
 
   private:
+    boost::shared_ptr<context_t> context_;
     boost::shared_ptr<const T> function_;
     size_type functionId_;
-    mutable result_t res_;
+    /// \brief Has the context been built by another split?
+    bool sharedContext_;
   };
 
+  /// \brief Add a multidimensional constraint to a problem.
+  ///
+  /// The constraint is split into scalar constraints which share
+  /// the same evaluation context, i.e. the constraint is evaluated
+  /// only once per point whatever its output size.
+  ///
+  /// \param concurrent must be true if the splits may be evaluated
+  /// from different threads. A ConstraintsEvaluator using a thread
+  /// pool makes the context concurrent itself.
   template <typename P, typename C>
   void addNonScalarConstraint
   (P& problem,
    boost::shared_ptr<C> constraint,
    std::vector<Function::interval_t> interval,
    std::vector<Function::value_type> scale
-   = std::vector<Function::value_type> ())
+   = std::vector<Function::value_type> (),
+   bool concurrent = false)
     throw (std::runtime_error);
 
 
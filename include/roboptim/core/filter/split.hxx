@@ -18,6 +18,8 @@
 #ifndef ROBOPTIM_CORE_FILTER_SPLIT_HXX
 # define ROBOPTIM_CORE_FILTER_SPLIT_HXX
 # include <boost/format.hpp>
+# include <boost/utility.hpp>
+# include <boost/type_traits/is_base_of.hpp>
 
 # include <roboptim/core/derivative-size.hh>
 
@@ -38,30 +40,197 @@ namespace roboptim
     }
   } // end of anonymous namespace.
 
+  namespace detail
+  {
+    /// \internal
+    /// \brief Compute the jacobian of a split function.
+    inline void
+    splitJacobian (const DifferentiableFunction& fct,
+		   DifferentiableFunction::jacobian_t& jacobian,
+		   const DifferentiableFunction::argument_t& argument)
+    {
+      fct.jacobian (jacobian, argument);
+    }
+
+    /// \internal
+    /// \brief Non-differentiable functions do not have a jacobian.
+    inline void
+    splitJacobian (const Function&,
+		   DifferentiableFunction::jacobian_t&,
+		   const DifferentiableFunction::argument_t&)
+    {
+      assert (0);
+    }
+
+    /// \internal
+    /// \brief Lock a mutex, if any, for the current scope.
+    class OptionalLock : public boost::noncopyable
+    {
+    public:
+      explicit OptionalLock (boost::mutex* mutex) throw ()
+	: mutex_ (mutex)
+      {
+	if (mutex_)
+	  mutex_->lock ();
+      }
+
+      ~OptionalLock () throw ()
+      {
+	if (mutex_)
+	  mutex_->unlock ();
+      }
+
+    private:
+      boost::mutex* mutex_;
+    };
+  } // end of namespace detail.
+
+  template <typename T>
+  SplitContext<T>::SplitContext (boost::shared_ptr<const T> fct,
+				 bool concurrent) throw ()
+    : function_ (fct),
+      mutex_ (concurrent ? new boost::mutex () : 0),
+      x_ (fct->inputSize ()),
+      res_ (fct->outputSize ()),
+      valid_ (false),
+      jacobianX_ (fct->inputSize ()),
+      jacobian_ (),
+      jacobianValid_ (false)
+  {
+  }
+
+  template <typename T>
+  SplitContext<T>::~SplitContext () throw ()
+  {
+  }
+
+  template <typename T>
+  const boost::shared_ptr<const T>&
+  SplitContext<T>::function () const throw ()
+  {
+    return function_;
+  }
+
+  template <typename T>
+  typename SplitContext<T>::value_type
+  SplitContext<T>::value (const argument_t& argument,
+			  size_type functionId) const throw ()
+  {
+    detail::OptionalLock lock (mutex_.get ());
+    if (!valid_ || x_ != argument)
+      {
+	(*function_) (res_, argument);
+	x_ = argument;
+	valid_ = true;
+      }
+    return res_[functionId];
+  }
+
+  template <typename T>
+  void
+  SplitContext<T>::gradient (gradient_t& gradient,
+			     const argument_t& argument,
+			     size_type functionId) const throw ()
+  {
+    detail::OptionalLock lock (mutex_.get ());
+    if (!jacobianValid_ || jacobianX_ != argument)
+      {
+	// The jacobian buffer is allocated by the first request: the
+	// context of a standalone split never computes the jacobian.
+	if (jacobian_.rows () != function_->outputSize ())
+	  {
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+	    const bool mallocAllowed = Eigen::internal::is_malloc_allowed ();
+	    Eigen::internal::set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+	    jacobian_.resize (function_->outputSize (),
+			      function_->inputSize ());
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+	    Eigen::internal::set_is_malloc_allowed (mallocAllowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+	  }
+	detail::splitJacobian (*function_, jacobian_, argument);
+	jacobianX_ = argument;
+	jacobianValid_ = true;
+      }
+    gradient = jacobian_.row (functionId);
+  }
+
+  template <typename T>
+  void
+  SplitContext<T>::reset () throw ()
+  {
+    detail::OptionalLock lock (mutex_.get ());
+    valid_ = false;
+    jacobianValid_ = false;
+  }
+
+  template <typename T>
+  bool
+  SplitContext<T>::concurrent () const throw ()
+  {
+    return mutex_.get () != 0;
+  }
+
+  template <typename T>
+  void
+  SplitContext<T>::setConcurrent () throw ()
+  {
+    if (!mutex_)
+      mutex_.reset (new boost::mutex ());
+  }
+
   template <typename T>
   Split<T>::Split (boost::shared_ptr<const T> fct,
 		   size_type functionId) throw ()
     : T (fct->inputSize (), 1, splitName (*fct, functionId)),
+      context_ (new context_t (fct)),
       function_ (fct),
       functionId_ (functionId),
-      res_ (function_->outputSize ())
+      sharedContext_ (false)
   {
     assert (functionId < fct->outputSize ());
   }
 
+  template <typename T>
+  Split<T>::Split (boost::shared_ptr<context_t> context,
+		   size_type functionId) throw ()
+    : T (context->function ()->inputSize (), 1,
+	 splitName (*context->function (), functionId)),
+      context_ (context),
+      function_ (context->function ()),
+      functionId_ (functionId),
+      sharedContext_ (true)
+  {
+    assert (functionId < function_->outputSize ());
+  }
+
   template <typename T>
   Split<T>::~Split () throw ()
   {
   }
 
+  template <typename T>
+  const boost::shared_ptr<typename Split<T>::context_t>&
+  Split<T>::context () const throw ()
+  {
+    return context_;
+  }
+
+  template <typename T>
+  void
+  Split<T>::setConcurrent () const throw ()
+  {
+    context_->setConcurrent ();
+  }
+
   template <typename T>
   void
   Split<T>::impl_compute (result_t& result,
 			  const argument_t& argument)
     const throw ()
   {
-    (*function_) (this->res_, argument);
-    result[0] = this->res_[functionId_];
+    result[0] = context_->value (argument, functionId_);
   }
 
 
@@ -81,12 +250,14 @@ namespace roboptim
     const throw ()
   {
     assert (functionId == 0);
-    function_->gradient (gradient, argument, functionId_);
+    // Computing the whole jacobian is only worth it if the other
+    // splits can reuse it.
+    if (sharedContext_)
+      context_->gradient (gradient, argument, functionId_);
+    else
+      function_->gradient (gradient, argument, functionId_);
   }
 
-
-
-
   template <>
   void
   Split<Function>::impl_hessian
@@ -156,7 +327,8 @@ namespace roboptim
   (P& problem,
    boost::shared_ptr<C> constraint,
    std::vector<Function::interval_t> interval,
-   std::vector<Function::value_type> scale)
+   std::vector<Function::value_type> scale,
+   bool concurrent)
     throw (std::runtime_error)
   {
     assert (constraint);
@@ -171,9 +343,14 @@ namespace roboptim
 	problem.addConstraint (constraint, interval[0], scale[0]);
       return;
     }
+    // All the splits share the same context so that the constraint
+    // is evaluated only once per point.
+    boost::shared_ptr<SplitContext<C> > context
+      (new SplitContext<C> (constraint, concurrent));
+
     for (unsigned i = 0; i < constraint->outputSize (); ++i)
       {
-	boost::shared_ptr<Split<C> > split (new Split<C> (constraint, i));
+	boost::shared_ptr<Split<C> > split (new Split<C> (context, i));
 	if (scale.empty ())
 	  problem.addConstraint (split, interval[i]);
 	else
@@ -394,6 +394,61 @@ namespace roboptim
       return name_;
     }
 
+    /// \name Structure
+    /// \{
+
+    /// \brief Structural properties of a function.
+    ///
+    /// Flags describing properties which hold on the whole domain,
+    /// solvers may rely on them to evaluate derivatives once or to
+    /// skip some computations (e.g. the hessian of a linear
+    /// constraint).
+    ///
+    /// Implied properties are always reported too: a linear function
+    /// is also quadratic and has a constant jacobian and hessian.
+    enum StructureFlag
+      {
+	/// \brief The jacobian does not depend on the argument.
+	CONSTANT_JACOBIAN = 1 << 0,
+	/// \brief The hessians do not depend on the argument.
+	CONSTANT_HESSIAN = 1 << 1,
+	/// \brief Each component is affine: \f$f(x) = A x + b\f$.
+	LINEAR = 1 << 2,
+	/// \brief Each component is a polynomial of degree at most two.
+	QUADRATIC = 1 << 3,
+	/// \brief Each component is a sum of functions of one variable
+	/// (its hessian is diagonal).
+	SEPARABLE = 1 << 4,
+	/// \brief Distinct components depend on disjoint sets of
+	/// variables (each jacobian column has at most one non-zero).
+	INDEPENDENT_ROWS = 1 << 5
+      };
+
+    /// \brief Combination of StructureFlag values.
+    typedef unsigned int structure_t;
+
+    /// \brief Structural properties of the function.
+    ///
+    /// Concrete classes override this method to report their
+    /// properties, the default implementation reports none of them.
+    ///
+    /// \return combination of StructureFlag values
+    virtual structure_t structure () const throw ()
+    {
+      return 0;
+    }
+
+    /// \brief Check whether the function has all the given properties.
+    ///
+    /// \param flags combination of StructureFlag values
+    /// \return true if all the properties hold
+    bool hasStructure (structure_t flags) const throw ()
+    {
+      return (structure () & flags) == flags;
+    }
+
+    /// \}
+
     /// \brief Display the function on the specified output stream.
     ///
     /// \param o output stream used for display
@@ -22,18 +22,24 @@
 
 # include <stdexcept>
 
+# include <boost/function.hpp>
+# include <boost/optional.hpp>
+# include <boost/shared_ptr.hpp>
 # include <boost/variant/get.hpp>
 # include <boost/variant/variant.hpp>
 # include <boost/utility.hpp>
 
 # include <log4cxx/logger.h>
 
+# include <roboptim/core/cancellation-token.hh>
 # include <roboptim/core/fwd.hh>
 # include <roboptim/core/problem.hh>
 # include <roboptim/core/result.hh>
 # include <roboptim/core/result-with-warnings.hh>
 # include <roboptim/core/solver-error.hh>
+# include <roboptim/core/solver-state.hh>
 # include <roboptim/core/solver-warning.hh>
+# include <roboptim/core/warm-start.hh>
 
 namespace roboptim
 {
@@ -71,6 +77,12 @@ namespace roboptim
                            ResultWithWarnings,
                            SolverError> result_t;
 
+    /// \brief Iteration callback type.
+    ///
+    /// The callback receives the current solver state and returns
+    /// false to stop the optimization, true to continue.
+    typedef boost::function<bool (const SolverState&)> callback_t;
+
     /// \name Constructors and destructors.
     /// \{
     explicit GenericSolver () throw ();
@@ -81,8 +93,57 @@ namespace roboptim
     /// \brief Force to restart the optimization.
     /// Reset the internal mechanism to force the solution to be
     /// re-computed next time getMinimum is called.
+    /// The warm start, if any, is kept.
     void reset () throw ();
 
+    /// \brief Set the state the next solve starts from.
+    ///
+    /// Plug-ins which support warm starts use it instead of the
+    /// problem starting point, other plug-ins ignore it.
+    ///
+    /// \param warmStart primal and dual initial state
+    void setWarmStart (const WarmStart& warmStart) throw ();
+
+    /// \brief Warm start from the result of a previous solve.
+    ///
+    /// Results with warnings are used as is. For solver errors, the
+    /// last state is used if it is available.
+    ///
+    /// \param result result of a previous solve
+    /// \return true if the result provided a warm start
+    bool setWarmStart (const result_t& result) throw ();
+
+    /// \brief Remove the warm start, the next solve is a cold start.
+    void resetWarmStart () throw ();
+
+    /// \brief Retrieve the warm start (if any).
+    const boost::optional<WarmStart>& warmStart () const throw ();
+
+    /// \brief Set the callback invoked at each iteration.
+    ///
+    /// Plug-ins supporting callbacks invoke it once per iteration,
+    /// see SolverState. An empty function removes the callback.
+    ///
+    /// \param callback function called at each iteration
+    void setIterationCallback (const callback_t& callback) throw ();
+
+    /// \brief Retrieve the iteration callback (may be empty).
+    const callback_t& iterationCallback () const throw ();
+
+    /// \brief Set the token used to interrupt the solve.
+    ///
+    /// Plug-ins poll the token between iterations, once a stop is
+    /// requested they return a SolverError carrying the last
+    /// iterate. A null pointer removes the token.
+    ///
+    /// \param token cancellation token (shared with the clients)
+    void setCancellationToken (boost::shared_ptr<CancellationToken> token)
+      throw ();
+
+    /// \brief Retrieve the cancellation token (may be null).
+    const boost::shared_ptr<CancellationToken>& cancellationToken ()
+      const throw ();
+
     /// \brief Solve the problem.
     /// Called automatically by getMinimum if required.
     virtual void solve () throw () = 0;
@@ -135,9 +196,56 @@ namespace roboptim
     }
 
   protected:
+    /// \brief Is there an iteration callback?
+    ///
+    /// Plug-ins should check it before building the solver state so
+    /// that solving without callback has no overhead.
+    bool hasIterationCallback () const throw ()
+    {
+      return !callback_.empty ();
+    }
+
+    /// \brief Should the solve be interrupted?
+    ///
+    /// Plug-ins poll it between iterations, see CancellationToken.
+    bool stopRequested () const throw ()
+    {
+      return token_ && token_->stopRequested ();
+    }
+
+    /// \brief Invoke the iteration callback.
+    ///
+    /// The cancellation token is polled first.
+    ///
+    /// \param state current solver state
+    /// \return false if the optimization has to be stopped
+    bool iterate (const SolverState& state) const throw ()
+    {
+      if (stopRequested ())
+	return false;
+      return callback_.empty () || callback_ (state);
+    }
+
+    /// \brief Interrupt the solve, keeping the last iterate.
+    ///
+    /// Set the result to a SolverError explaining why the solve
+    /// stopped.
+    ///
+    /// \param lastState last solver state
+    void interrupt (const Result& lastState) throw ();
+
     /// /brief Optimization result.
     result_t result_;
 
+    /// \brief Optional initial state of the next solve.
+    boost::optional<WarmStart> warmStart_;
+
+    /// \brief Iteration callback (may be empty).
+    callback_t callback_;
+
+    /// \brief Cancellation token (may be null).
+    boost::shared_ptr<CancellationToken> token_;
+
     /// \brief Pointer to function logger (see log4cxx documentation).
     static log4cxx::LoggerPtr logger;
   };
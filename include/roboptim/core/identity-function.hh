@@ -41,6 +41,9 @@ namespace roboptim
     IdentityFunction (const vector_t& offset) throw ();
     ~IdentityFunction () throw ();
 
+    /// \brief Identity functions are separable with independent rows.
+    virtual structure_t structure () const throw ();
+
     /// \brief Display the function on the specified output stream.
     ///
     /// \param o output stream used for display
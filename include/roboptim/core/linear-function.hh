@@ -43,6 +43,10 @@ namespace roboptim
 		    size_type outputSize = 1,
 		    std::string name = std::string ()) throw ();
 
+    /// \brief Linear functions have a constant jacobian and, their
+    /// hessian being zero, are separable.
+    virtual structure_t structure () const throw ();
+
     /// \brief Display the function on the specified output stream.
     ///
     /// \param o output stream used for display
@@ -0,0 +1,89 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_LOW_RANK_QUADRATIC_FUNCTION_HH
+# define ROBOPTIM_CORE_LOW_RANK_QUADRATIC_FUNCTION_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <roboptim/core/quadratic-function.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_function
+  /// @{
+
+  /// \brief Quadratic function with a diagonal plus low-rank matrix.
+  ///
+  /// Implement a quadratic function using the formula:
+  /// \f[f(x) = \frac{1}{2} x^t (D + U U^t) x + b^t x\f]
+  /// where \f$D = diag (d)\f$ and \f$U\f$ is a \f$(n, r)\f$ matrix,
+  /// \f$r \ll n\f$. The matrix \f$D + U U^t\f$ is never formed:
+  /// storage and kernels are \f$O(n r)\f$.
+  class ROBOPTIM_DLLAPI LowRankQuadraticFunction : public QuadraticFunction
+  {
+  public:
+    /// \brief Build a quadratic function from its factors.
+    ///
+    /// See class documentation for d, U and b definition.
+    /// \param d diagonal part
+    /// \param U low-rank factor
+    /// \param b b vector
+    LowRankQuadraticFunction (const vector_t& d, const matrix_t& U,
+			      const vector_t& b) throw ();
+
+    ~LowRankQuadraticFunction () throw ();
+
+    /// \brief Diagonal part.
+    const vector_t& diagonal () const throw ();
+
+    /// \brief Low-rank factor.
+    const matrix_t& U () const throw ();
+
+    /// \brief b vector.
+    const vector_t& b () const throw ();
+
+    /// \brief Display the function on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    virtual std::ostream& print (std::ostream&) const throw ();
+
+  protected:
+    void impl_compute (result_t& , const argument_t&) const throw ();
+    void impl_gradient (gradient_t&, const argument_t&, size_type = 0)
+      const throw ();
+    void impl_hessian (hessian_t& hessian,
+		       const argument_t& argument,
+		       size_type functionId = 0) const throw ();
+  private:
+    /// \brief Diagonal part.
+    vector_t d_;
+    /// \brief Low-rank factor.
+    matrix_t u_;
+    /// \brief B vector.
+    vector_t b_;
+    /// \brief U^T x buffer.
+    mutable vector_t projection_;
+  };
+
+  /// @}
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_LOW_RANK_QUADRATIC_FUNCTION_HH
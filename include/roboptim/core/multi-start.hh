@@ -0,0 +1,209 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_MULTI_START_HH
+# define ROBOPTIM_CORE_MULTI_START_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <iostream>
+# include <stdexcept>
+# include <string>
+# include <vector>
+
+# include <boost/optional.hpp>
+# include <boost/shared_ptr.hpp>
+# include <boost/static_assert.hpp>
+# include <boost/thread/mutex.hpp>
+# include <boost/type_traits/is_base_of.hpp>
+
+# include <roboptim/core/fwd.hh>
+# include <roboptim/core/generic-solver.hh>
+# include <roboptim/core/result.hh>
+# include <roboptim/core/solver-factory.hh>
+# include <roboptim/core/solver-state.hh>
+# include <roboptim/core/thread-pool.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_solver
+  /// @{
+
+  /// \brief Local minimum found by a multi-start run.
+  struct LocalMinimum
+  {
+    /// \brief Best result converging to this minimum.
+    Result result;
+    /// \brief Number of runs which converged to this minimum.
+    std::size_t hits;
+  };
+
+  /// \brief Multi-start global optimization driver.
+  ///
+  /// Starting points are sampled in the problem argument bounds by
+  /// Latin hypercube sampling, then a local solver (any plug-in) is
+  /// run from each of them, concurrently if a thread pool is given.
+  ///
+  /// Converged runs are merged into local minima: two results closer
+  /// than the tolerance (infinity norm) are the same minimum. Runs
+  /// whose iterate enters the basin of an already known minimum are
+  /// cancelled through the iteration callback (plug-ins which do not
+  /// call it simply run to convergence).
+  ///
+  /// Infinite bounds are replaced by the starting point (or zero)
+  /// plus or minus the sampling range.
+  ///
+  /// \tparam S solver type
+  template <typename S>
+  class MultiStart
+  {
+    BOOST_STATIC_ASSERT((boost::is_base_of<GenericSolver, S>::value));
+  public:
+    /// \brief Solver type.
+    typedef S solver_t;
+    /// \brief Problem type.
+    typedef typename solver_t::problem_t problem_t;
+    /// \brief Import size type.
+    typedef Function::size_type size_type;
+    /// \brief Import value type.
+    typedef Function::value_type value_type;
+    /// \brief Import vector type.
+    typedef Function::vector_t vector_t;
+    /// \brief Starting points type.
+    typedef std::vector<vector_t> starts_t;
+    /// \brief Local minima type.
+    typedef std::vector<LocalMinimum> minima_t;
+
+    /// \brief Build a multi-start driver.
+    ///
+    /// \param plugin local solver plug-in name
+    /// \param problem problem to be solved (copied)
+    /// \param pool thread pool running the local solves, runs are
+    /// sequential if the pointer is null. The pool can be shared with
+    /// other clients: only the runs are waited for, see TaskGroup.
+    MultiStart (const std::string& plugin,
+		const problem_t& problem,
+		boost::shared_ptr<ThreadPool> pool =
+		boost::shared_ptr<ThreadPool> ()) throw ();
+    ~MultiStart () throw ();
+
+    /// \brief Problem to be solved.
+    const problem_t& problem () const throw ();
+
+    /// \name Settings
+    /// \{
+
+    /// \brief Number of starting points (default: 16).
+    std::size_t& starts () throw ();
+    /// \brief Random generator seed (default: 0).
+    unsigned& seed () throw ();
+    /// \brief Distance under which two minima are merged
+    /// (default: 1e-6).
+    value_type& tolerance () throw ();
+    /// \brief Distance to a known minimum under which a run is
+    /// cancelled (default: 1e-3, zero disables early cancellation).
+    value_type& basinRadius () throw ();
+    /// \brief Sampling half-width used for infinite bounds
+    /// (default: 1).
+    value_type& samplingRange () throw ();
+
+    /// \}
+
+    /// \brief Sample the starting points (Latin hypercube).
+    ///
+    /// Each dimension is split in starts () strata of same width, and
+    /// each stratum contains exactly one point.
+    starts_t sample () const throw ();
+
+    /// \brief Run the local solves.
+    ///
+    /// \throw std::runtime_error if the plug-in cannot be loaded
+    void solve () throw (std::runtime_error);
+
+    /// \brief Local minima, sorted by increasing cost.
+    const minima_t& minima () const throw ();
+
+    /// \brief Best minimum, if any run converged.
+    const boost::optional<Result>& best () const throw ();
+
+    /// \brief Number of runs cancelled in a known basin.
+    std::size_t cancelled () const throw ();
+
+    /// \brief Number of runs which failed.
+    std::size_t failed () const throw ();
+
+    /// \brief Display the driver on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    std::ostream& print (std::ostream& o) const throw ();
+
+  private:
+    /// \brief Run a local solve from a starting point.
+    void run (const vector_t* start) throw ();
+
+    /// \brief Iteration callback: stop in known basins.
+    bool monitor (bool* cancelled, const SolverState& state) throw ();
+
+    /// \brief Merge a converged result into the local minima.
+    void addMinimum (const Result& result) throw ();
+
+    /// \brief Local solver plug-in name.
+    std::string plugin_;
+    /// \brief Problem to be solved.
+    problem_t problem_;
+    /// \brief Thread pool (parallel mode only).
+    boost::shared_ptr<ThreadPool> pool_;
+
+    /// \brief Number of starting points.
+    std::size_t starts_;
+    /// \brief Random generator seed.
+    unsigned seed_;
+    /// \brief Minima merge tolerance.
+    value_type tolerance_;
+    /// \brief Early cancellation radius.
+    value_type basinRadius_;
+    /// \brief Sampling half-width for infinite bounds.
+    value_type samplingRange_;
+
+    /// \brief Protect the results below.
+    boost::mutex mutex_;
+    /// \brief Local minima.
+    minima_t minima_;
+    /// \brief Best minimum.
+    boost::optional<Result> best_;
+    /// \brief Cancelled runs.
+    std::size_t cancelled_;
+    /// \brief Failed runs.
+    std::size_t failed_;
+  };
+
+  /// @}
+
+  /// \brief Override operator<< to display multi-start drivers.
+  ///
+  /// \param o output stream used for display
+  /// \param ms driver to be displayed
+  /// \return output stream
+  template <typename S>
+  std::ostream& operator<< (std::ostream& o, const MultiStart<S>& ms);
+
+} // end of namespace roboptim
+
+# include <roboptim/core/multi-start.hxx>
+#endif //! ROBOPTIM_CORE_MULTI_START_HH
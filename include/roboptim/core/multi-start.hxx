@@ -0,0 +1,328 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_MULTI_START_HXX
+# define ROBOPTIM_CORE_MULTI_START_HXX
+# include <algorithm>
+# include <cmath>
+# include <exception>
+
+# include <boost/bind.hpp>
+# include <boost/random/mersenne_twister.hpp>
+# include <boost/random/uniform_01.hpp>
+# include <boost/random/uniform_int_distribution.hpp>
+
+# include <roboptim/core/indent.hh>
+# include <roboptim/core/plugin-registry.hh>
+# include <roboptim/core/result-with-warnings.hh>
+# include <roboptim/core/util.hh>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    /// \internal
+    /// \brief Order local minima by increasing cost.
+    ///
+    /// Ties are broken by comparing the points so that the order
+    /// does not depend on the runs scheduling.
+    inline bool
+    lessCost (const LocalMinimum& lhs, const LocalMinimum& rhs)
+    {
+      if (lhs.result.value[0] != rhs.result.value[0])
+	return lhs.result.value[0] < rhs.result.value[0];
+      return std::lexicographical_compare
+	(lhs.result.x.data (), lhs.result.x.data () + lhs.result.x.size (),
+	 rhs.result.x.data (), rhs.result.x.data () + rhs.result.x.size ());
+    }
+  } // end of namespace detail.
+
+  template <typename S>
+  MultiStart<S>::MultiStart (const std::string& plugin,
+			     const problem_t& problem,
+			     boost::shared_ptr<ThreadPool> pool) throw ()
+    : plugin_ (plugin),
+      problem_ (problem),
+      pool_ (pool),
+      starts_ (16),
+      seed_ (0),
+      tolerance_ (1e-6),
+      basinRadius_ (1e-3),
+      samplingRange_ (1.),
+      mutex_ (),
+      minima_ (),
+      best_ (),
+      cancelled_ (0),
+      failed_ (0)
+  {
+  }
+
+  template <typename S>
+  MultiStart<S>::~MultiStart () throw ()
+  {
+  }
+
+  template <typename S>
+  const typename MultiStart<S>::problem_t&
+  MultiStart<S>::problem () const throw ()
+  {
+    return problem_;
+  }
+
+  template <typename S>
+  std::size_t&
+  MultiStart<S>::starts () throw ()
+  {
+    return starts_;
+  }
+
+  template <typename S>
+  unsigned&
+  MultiStart<S>::seed () throw ()
+  {
+    return seed_;
+  }
+
+  template <typename S>
+  typename MultiStart<S>::value_type&
+  MultiStart<S>::tolerance () throw ()
+  {
+    return tolerance_;
+  }
+
+  template <typename S>
+  typename MultiStart<S>::value_type&
+  MultiStart<S>::basinRadius () throw ()
+  {
+    return basinRadius_;
+  }
+
+  template <typename S>
+  typename MultiStart<S>::value_type&
+  MultiStart<S>::samplingRange () throw ()
+  {
+    return samplingRange_;
+  }
+
+  template <typename S>
+  typename MultiStart<S>::starts_t
+  MultiStart<S>::sample () const throw ()
+  {
+    size_type n = problem_.function ().inputSize ();
+    starts_t starts (starts_, vector_t (n));
+
+    boost::random::mt19937 generator (seed_);
+    boost::random::uniform_01<value_type> uniform;
+    std::vector<std::size_t> strata (starts_);
+
+    for (size_type j = 0; j < n; ++j)
+      {
+	value_type center = problem_.startingPoint ()
+	  ? (*problem_.startingPoint ())[j] : 0.;
+	value_type lower = problem_.argumentBounds ()[j].first;
+	value_type upper = problem_.argumentBounds ()[j].second;
+
+	if (lower == -Function::infinity ())
+	  lower = (upper == Function::infinity ())
+	    ? center - samplingRange_ : upper - 2 * samplingRange_;
+	if (upper == Function::infinity ())
+	  upper = lower + 2 * samplingRange_;
+
+	// Random permutation of the strata (Fisher-Yates).
+	for (std::size_t i = 0; i < starts_; ++i)
+	  strata[i] = i;
+	for (std::size_t i = starts_; i > 1; --i)
+	  {
+	    boost::random::uniform_int_distribution<std::size_t>
+	      pick (0, i - 1);
+	    std::swap (strata[i - 1], strata[pick (generator)]);
+	  }
+
+	for (std::size_t i = 0; i < starts_; ++i)
+	  starts[i][j] = lower + (upper - lower)
+	    * (static_cast<value_type> (strata[i]) + uniform (generator))
+	    / static_cast<value_type> (starts_);
+      }
+    return starts;
+  }
+
+  template <typename S>
+  void
+  MultiStart<S>::solve () throw (std::runtime_error)
+  {
+    minima_.clear ();
+    best_ = boost::none;
+    cancelled_ = 0;
+    failed_ = 0;
+
+    starts_t starts = sample ();
+    if (starts.empty ())
+      return;
+
+    // Keep the plug-in loaded during all the runs, this also reports
+    // loading errors in the calling thread.
+    PluginRegistry& registry = PluginRegistry::instance ();
+    registry.acquire (plugin_);
+
+    if (pool_)
+      {
+	TaskGroup group (*pool_);
+	for (std::size_t i = 0; i < starts.size (); ++i)
+	  group.submit (boost::bind (&MultiStart<S>::run, this, &starts[i]));
+	group.wait ();
+      }
+    else
+      for (std::size_t i = 0; i < starts.size (); ++i)
+	run (&starts[i]);
+
+    registry.release (plugin_);
+
+    std::sort (minima_.begin (), minima_.end (), detail::lessCost);
+    if (!minima_.empty ())
+      best_ = minima_.front ().result;
+  }
+
+  template <typename S>
+  const typename MultiStart<S>::minima_t&
+  MultiStart<S>::minima () const throw ()
+  {
+    return minima_;
+  }
+
+  template <typename S>
+  const boost::optional<Result>&
+  MultiStart<S>::best () const throw ()
+  {
+    return best_;
+  }
+
+  template <typename S>
+  std::size_t
+  MultiStart<S>::cancelled () const throw ()
+  {
+    return cancelled_;
+  }
+
+  template <typename S>
+  std::size_t
+  MultiStart<S>::failed () const throw ()
+  {
+    return failed_;
+  }
+
+  template <typename S>
+  void
+  MultiStart<S>::run (const vector_t* start) throw ()
+  {
+    bool cancelled = false;
+    try
+      {
+	problem_t problem (problem_);
+	problem.startingPoint () = *start;
+
+	SolverFactory<solver_t> factory (plugin_, problem);
+	solver_t& solver = factory ();
+	if (basinRadius_ > 0.)
+	  solver.setIterationCallback
+	    (boost::bind (&MultiStart<S>::monitor, this, &cancelled, _1));
+
+	switch (solver.minimumType ())
+	  {
+	  case GenericSolver::SOLVER_VALUE:
+	    addMinimum (solver.template getMinimum<Result> ());
+	    return;
+	  case GenericSolver::SOLVER_VALUE_WARNINGS:
+	    addMinimum (solver.template getMinimum<ResultWithWarnings> ());
+	    return;
+	  default:
+	    break;
+	  }
+      }
+    catch (const std::exception&)
+      {
+      }
+
+    boost::mutex::scoped_lock lock (mutex_);
+    if (cancelled)
+      ++cancelled_;
+    else
+      ++failed_;
+  }
+
+  template <typename S>
+  bool
+  MultiStart<S>::monitor (bool* cancelled, const SolverState& state) throw ()
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    for (typename minima_t::const_iterator it = minima_.begin ();
+	 it != minima_.end (); ++it)
+      if ((state.x - it->result.x).template lpNorm<Eigen::Infinity> ()
+	  <= basinRadius_)
+	{
+	  *cancelled = true;
+	  return false;
+	}
+    return true;
+  }
+
+  template <typename S>
+  void
+  MultiStart<S>::addMinimum (const Result& result) throw ()
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    for (typename minima_t::iterator it = minima_.begin ();
+	 it != minima_.end (); ++it)
+      if ((result.x - it->result.x).template lpNorm<Eigen::Infinity> ()
+	  <= tolerance_)
+	{
+	  ++it->hits;
+	  if (result.value[0] < it->result.value[0])
+	    it->result = result;
+	  return;
+	}
+
+    LocalMinimum minimum = {result, 1};
+    minima_.push_back (minimum);
+  }
+
+  template <typename S>
+  std::ostream&
+  MultiStart<S>::print (std::ostream& o) const throw ()
+  {
+    o << "Multi-start:" << incindent << iendl
+      << "Starts: " << starts_ << iendl
+      << "Cancelled runs: " << cancelled_ << iendl
+      << "Failed runs: " << failed_ << iendl
+      << "Local minima:" << incindent;
+    for (typename minima_t::const_iterator it = minima_.begin ();
+	 it != minima_.end (); ++it)
+      o << iendl << it->result.x << ": " << it->result.value[0]
+	<< " (" << it->hits << " hit(s))";
+    return o << decindent << decindent;
+  }
+
+  template <typename S>
+  std::ostream&
+  operator<< (std::ostream& o, const MultiStart<S>& ms)
+  {
+    return ms.print (o);
+  }
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_MULTI_START_HXX
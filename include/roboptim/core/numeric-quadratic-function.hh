@@ -33,7 +33,17 @@ namespace roboptim
   /// \f[f(x) = \frac{1}{2} x^t A x + b^t x\f]
   /// where \f$A\f$ and \f$B\f$ are set when the class is instantiated.
   ///
-  /// \note A is a symmetric matrix.
+  /// \note A is a symmetric matrix: only its lower triangular part
+  /// is read, the strictly upper part is overwritten by its mirror
+  /// when the function is built. The value and gradient kernels are
+  /// symmetric matrix-vector products.
+  ///
+  /// \warning The hessian copies A at each call: solvers should use
+  /// A () instead.
+  ///
+  /// For structured matrices, see DiagonalQuadraticFunction,
+  /// BandedQuadraticFunction, SparseQuadraticFunction and
+  /// LowRankQuadraticFunction.
   class ROBOPTIM_DLLAPI NumericQuadraticFunction : public QuadraticFunction
   {
   public:
@@ -50,6 +60,12 @@ namespace roboptim
 
     ~NumericQuadraticFunction () throw ();
 
+    /// \brief A matrix (constant, no copy).
+    const symmetric_t& A () const throw ();
+
+    /// \brief b vector.
+    const vector_t& b () const throw ();
+
     /// \brief Display the function on the specified output stream.
     ///
     /// \param o output stream used for display
@@ -0,0 +1,215 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_PARAMETER_SCHEMA_HH
+# define ROBOPTIM_CORE_PARAMETER_SCHEMA_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <cassert>
+# include <iostream>
+# include <map>
+# include <stdexcept>
+# include <string>
+# include <vector>
+
+# include <boost/variant/get.hpp>
+# include <boost/variant/variant.hpp>
+
+# include <roboptim/core/function.hh>
+# include <roboptim/core/portability.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_problem
+  /// @{
+
+  /// \brief Parameters type.
+  struct Parameter
+  {
+    /// \brief Allowed types for parameters.
+    typedef boost::variant<Function::value_type, int, std::string> parameterValues_t;
+
+    /// \brief Parameter description (for humans).
+    std::string description;
+
+    /// \brief Value.
+    parameterValues_t value;
+  };
+
+  /// \brief Typed handle on a declared parameter.
+  ///
+  /// Returned by ParameterSchema::declare, the key is resolved to an
+  /// index once so that accessing the value does not involve any
+  /// string comparison.
+  ///
+  /// \tparam T parameter type
+  template <typename T>
+  struct ParameterKey
+  {
+    /// \brief Parameter index in the schema.
+    std::size_t index;
+  };
+
+  /// \brief Parameters values resolved by a schema.
+  ///
+  /// Values are stored by index, see ParameterSchema::bind.
+  class ROBOPTIM_DLLAPI ParameterValues
+  {
+  public:
+    /// \brief Values type.
+    typedef std::vector<Parameter::parameterValues_t> values_t;
+
+    /// \brief Typed access to a value (constant time).
+    ///
+    /// \pre the values have been bound by the schema declaring key
+    template <typename T>
+    const T& operator[] (const ParameterKey<T>& key) const throw ()
+    {
+      assert (key.index < values_.size ());
+      return *boost::get<T> (&values_[key.index]);
+    }
+
+    /// \brief Number of values.
+    std::size_t size () const throw ()
+    {
+      return values_.size ();
+    }
+
+  private:
+    friend class ParameterSchema;
+
+    /// \brief Values, indexed by the schema.
+    values_t values_;
+  };
+
+  /// \brief Declaration of the parameters of a solver.
+  ///
+  /// Plug-ins declare their parameters once (name, description, type
+  /// and default value). The schema then:
+  /// - fills a parameters map with the default values,
+  /// - validates a parameters map in bulk (unknown keys, types),
+  /// - binds a parameters map into ParameterValues for constant
+  ///   time typed access during the iterations,
+  /// - loads parameters from a file.
+  ///
+  /// Integer values are accepted for floating-point parameters.
+  class ROBOPTIM_DLLAPI ParameterSchema
+  {
+  public:
+    /// \brief Map of parameters.
+    typedef std::map<std::string, Parameter> parameters_t;
+
+    /// \brief Declared parameter.
+    struct Entry
+    {
+      /// \brief Parameter name.
+      std::string key;
+      /// \brief Default value and description.
+      Parameter parameter;
+    };
+
+    ParameterSchema () throw ();
+    ~ParameterSchema () throw ();
+
+    /// \brief Declare a parameter.
+    ///
+    /// \tparam T parameter type, one of Parameter::parameterValues_t
+    /// types
+    /// \param key parameter name
+    /// \param description parameter description (for humans)
+    /// \param value default value
+    /// \return typed handle on the parameter
+    /// \throw std::runtime_error if the parameter is already declared
+    template <typename T>
+    ParameterKey<T> declare (const std::string& key,
+			     const std::string& description,
+			     const T& value) throw (std::runtime_error);
+
+    /// \brief Number of declared parameters.
+    std::size_t size () const throw ();
+
+    /// \brief Declared parameters, in the declaration order.
+    const std::vector<Entry>& entries () const throw ();
+
+    /// \brief Retrieve the index of a parameter.
+    ///
+    /// \throw std::runtime_error if the parameter is not declared
+    std::size_t index (const std::string& key) const
+      throw (std::runtime_error);
+
+    /// \brief Set the default value of the missing parameters.
+    ///
+    /// \param parameters parameters map, existing values are kept
+    void fill (parameters_t& parameters) const throw ();
+
+    /// \brief Check a parameters map.
+    ///
+    /// All the errors (unknown parameters, type mismatches) are
+    /// reported at once.
+    ///
+    /// \param parameters parameters to be checked
+    /// \throw std::runtime_error if the parameters are invalid
+    void validate (const parameters_t& parameters) const
+      throw (std::runtime_error);
+
+    /// \brief Resolve a parameters map.
+    ///
+    /// Missing parameters take their default value.
+    ///
+    /// \param values resolved values
+    /// \param parameters parameters map
+    /// \throw std::runtime_error if the parameters are invalid
+    void bind (ParameterValues& values, const parameters_t& parameters)
+      const throw (std::runtime_error);
+
+    /// \brief Load parameters from a stream.
+    ///
+    /// The stream contains one ``key = value'' pair per line, empty
+    /// lines and lines starting with `#' are ignored. Values are
+    /// parsed according to the declared types. The parameters are
+    /// only updated if the whole stream is valid.
+    ///
+    /// \param parameters parameters map receiving the values
+    /// \param stream input stream
+    /// \throw std::runtime_error if a line is invalid
+    void load (parameters_t& parameters, std::istream& stream) const
+      throw (std::runtime_error);
+
+    /// \brief Load parameters from a file.
+    ///
+    /// \param parameters parameters map receiving the values
+    /// \param filename file name
+    /// \throw std::runtime_error if the file cannot be read or is
+    /// invalid
+    void load (parameters_t& parameters, const std::string& filename) const
+      throw (std::runtime_error);
+
+  private:
+    /// \brief Declared parameters.
+    std::vector<Entry> entries_;
+    /// \brief Parameters indices.
+    std::map<std::string, std::size_t> indices_;
+  };
+
+  /// @}
+
+} // end of namespace roboptim
+
+# include <roboptim/core/parameter-schema.hxx>
+#endif //! ROBOPTIM_CORE_PARAMETER_SCHEMA_HH
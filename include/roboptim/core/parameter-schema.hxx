@@ -0,0 +1,52 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_PARAMETER_SCHEMA_HXX
+# define ROBOPTIM_CORE_PARAMETER_SCHEMA_HXX
+# include <boost/mpl/contains.hpp>
+# include <boost/static_assert.hpp>
+
+namespace roboptim
+{
+  template <typename T>
+  ParameterKey<T>
+  ParameterSchema::declare (const std::string& key,
+			    const std::string& description,
+			    const T& value) throw (std::runtime_error)
+  {
+    BOOST_STATIC_ASSERT
+      ((boost::mpl::contains<Parameter::parameterValues_t::types, T>::value));
+
+    if (indices_.find (key) != indices_.end ())
+      throw std::runtime_error ("parameter ``" + key
+				+ "'' is already declared");
+
+    Entry entry;
+    entry.key = key;
+    entry.parameter.description = description;
+    entry.parameter.value = value;
+
+    ParameterKey<T> result = {entries_.size ()};
+    indices_[key] = entries_.size ();
+    entries_.push_back (entry);
+    return result;
+  }
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_PARAMETER_SCHEMA_HXX
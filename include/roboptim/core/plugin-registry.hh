@@ -0,0 +1,218 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_PLUGIN_REGISTRY_HH
+# define ROBOPTIM_CORE_PLUGIN_REGISTRY_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <cstddef>
+# include <map>
+# include <stdexcept>
+# include <string>
+
+# include <boost/thread/mutex.hpp>
+# include <boost/utility.hpp>
+
+# include <roboptim/core/portability.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_problem
+  /// @{
+
+  /// \brief Process-wide registry of the solver plug-ins.
+  ///
+  /// Each plug-in module is loaded once, the first time it is
+  /// requested, and its entry points (``getSizeOfProblem'',
+  /// ``create'' and ``destroy'') are resolved at the same time.
+  /// Later requests only increment a reference counter: building
+  /// several solvers from the same plug-in does not reload the
+  /// shared object.
+  ///
+  /// Modules stay loaded when they are not used anymore so that
+  /// applications creating a solver per request do not pay the
+  /// loading cost each time. They can be explicitly unloaded when
+  /// they are not referenced, and are all unloaded when the process
+  /// exits.
+  ///
+  /// Plug-ins can also be linked statically, see
+  /// StaticPluginRegistrar: they are then registered when the
+  /// program starts and are found without libltdl. When the library
+  /// is built with ROBOPTIM_CORE_NO_DYNAMIC_LOADING (static library
+  /// build), libltdl is not used at all and requesting a plug-in
+  /// which has not been registered statically fails.
+  ///
+  /// The registry is thread-safe.
+  class ROBOPTIM_DLLAPI PluginRegistry : public boost::noncopyable
+  {
+  public:
+    /// \brief Resolved plug-in entry points.
+    ///
+    /// Entry points are stored as raw pointers, the solver factory
+    /// casts them back to the right function types.
+    struct Symbols
+    {
+      /// \brief Problem type size, as seen by the plug-in.
+      unsigned sizeOfProblem;
+      /// \brief ``create'' entry point.
+      void* create;
+      /// \brief ``destroy'' entry point.
+      void* destroy;
+    };
+
+    /// \brief Retrieve the registry.
+    static PluginRegistry& instance () throw ();
+
+    /// \brief Register a statically linked plug-in.
+    ///
+    /// Static plug-ins take precedence over dynamic ones and are
+    /// never unloaded.
+    ///
+    /// \param plugin plug-in name
+    /// \param symbols plug-in entry points
+    void registerPlugin (const std::string& plugin, const Symbols& symbols)
+      throw ();
+
+    /// \brief Is a plug-in statically linked?
+    bool isStatic (const std::string& plugin) const throw ();
+
+    /// \brief Load a plug-in (if needed) and reference it.
+    ///
+    /// \param plugin plug-in name (for instance ``ipopt'')
+    /// \return plug-in entry points
+    /// \throw std::runtime_error if the plug-in cannot be loaded
+    Symbols acquire (const std::string& plugin) throw (std::runtime_error);
+
+    /// \brief Release a reference on a plug-in.
+    ///
+    /// The module is not unloaded.
+    void release (const std::string& plugin) throw ();
+
+    /// \brief Load a plug-in without referencing it.
+    ///
+    /// This is meant to be called at startup, so that the first
+    /// solver instantiation does not pay the loading cost.
+    ///
+    /// \throw std::runtime_error if the plug-in cannot be loaded
+    void preload (const std::string& plugin) throw (std::runtime_error);
+
+    /// \brief Unload a plug-in if it is not referenced anymore.
+    ///
+    /// \return true if the plug-in has been unloaded
+    bool unload (const std::string& plugin) throw ();
+
+    /// \brief Is a plug-in loaded?
+    bool isLoaded (const std::string& plugin) const throw ();
+
+    /// \brief Number of references on a plug-in.
+    std::size_t references (const std::string& plugin) const throw ();
+
+  private:
+    /// \brief Loaded plug-in.
+    struct Module
+    {
+      /// \brief libltdl handle (opaque here to avoid exposing ltdl.h).
+      ///
+      /// Null for statically linked plug-ins.
+      void* handle;
+      /// \brief Resolved entry points.
+      Symbols symbols;
+      /// \brief Number of references.
+      std::size_t references;
+    };
+
+    PluginRegistry () throw ();
+    ~PluginRegistry () throw ();
+
+    /// \brief Create the registry instance (called once).
+    static void initialize () throw ();
+
+    /// \brief Load a module, the registry must be locked.
+    Module& load (const std::string& plugin) throw (std::runtime_error);
+
+    /// \brief Registry instance.
+    static PluginRegistry* instance_;
+
+    /// \brief Has libltdl been initialized successfully?
+    bool initialized_;
+    /// \brief Protect the modules map.
+    mutable boost::mutex mutex_;
+    /// \brief Loaded modules, indexed by plug-in name.
+    std::map<std::string, Module> modules_;
+  };
+
+  /// \brief Register a statically linked plug-in at startup.
+  ///
+  /// When plug-ins are compiled with ROBOPTIM_CORE_STATIC_PLUGINS,
+  /// their entry points have internal linkage (several plug-ins can
+  /// then be linked in the same binary) and a static instance of
+  /// this class registers them by name:
+  /// \code
+  /// namespace
+  /// {
+  ///   StaticPluginRegistrar registrar
+  ///     ("my-solver", &getSizeOfProblem, &create, &destroy);
+  /// }
+  /// \endcode
+  ///
+  /// \warning When linking a static archive, make sure that the
+  /// plug-in objects are kept by the linker (--whole-archive).
+  struct StaticPluginRegistrar
+  {
+    template <typename C, typename D>
+    StaticPluginRegistrar (const char* plugin,
+			   unsigned (*getSizeOfProblem) (),
+			   C* create,
+			   D* destroy) throw ()
+    {
+      // There is no standard way to cast a pointer to function into
+      // a pointer to object.
+      union
+      {
+	C* function;
+	void* object;
+      } c;
+      c.function = create;
+      union
+      {
+	D* function;
+	void* object;
+      } d;
+      d.function = destroy;
+
+      PluginRegistry::Symbols symbols;
+      symbols.sizeOfProblem = getSizeOfProblem ();
+      symbols.create = c.object;
+      symbols.destroy = d.object;
+      PluginRegistry::instance ().registerPlugin (plugin, symbols);
+    }
+  };
+
+  /// @}
+
+  /// \def ROBOPTIM_CORE_PLUGIN_API
+  /// \brief Linkage of the plug-ins entry points.
+# ifdef ROBOPTIM_CORE_STATIC_PLUGINS
+#  define ROBOPTIM_CORE_PLUGIN_API
+# else
+#  define ROBOPTIM_CORE_PLUGIN_API ROBOPTIM_DLLEXPORT
+# endif //! ROBOPTIM_CORE_STATIC_PLUGINS
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_PLUGIN_REGISTRY_HH
@@ -31,6 +31,9 @@ namespace roboptim
   /// constraints etc.). These values can be obtained thanks to
   /// SolverError::lastState.
   ///
+  /// The iteration callback, if any, is invoked once with this state
+  /// and the cancellation token, if any, is polled before.
+  ///
   /// This solver always fails but is always available
   /// as it does not rely on the plug-in mechanism.
   ///
@@ -0,0 +1,227 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_PLUGIN_LM_HH
+# define ROBOPTIM_CORE_PLUGIN_LM_HH
+# include <vector>
+
+# include <boost/mpl/vector.hpp>
+
+# include <roboptim/core/differentiable-function.hh>
+# include <roboptim/core/linear-function.hh>
+# include <roboptim/core/solver.hh>
+# include <roboptim/core/sum-of-c1-squares.hh>
+
+namespace roboptim
+{
+  /// \brief Levenberg-Marquardt solver for least-squares problems.
+  ///
+  /// The objective has to be a SumOfC1Squares: the solver works
+  /// directly on the residuals \f$r\f$ and their jacobian \f$J\f$ of
+  /// the base function. Each iteration solves the damped normal
+  /// equations
+  /// \f[(J^T J + \mu I) h = -J^T r\f]
+  /// and the damping \f$\mu\f$ is updated from the ratio between the
+  /// actual and the predicted decrease (Nielsen's update).
+  ///
+  /// Two linear solvers are available (parameter ``lm.linear-solver''):
+  /// - ``cholesky'' (default): LDLT factorization of the damped
+  ///   normal matrix. \f$J^T J\f$ is computed once per jacobian as a
+  ///   symmetric rank-k update, rejected steps only refactorize.
+  /// - ``qr'': QR factorization of the augmented system
+  ///   \f$[J; \sqrt{\mu} I] h = [-r; 0]\f$, more accurate on badly
+  ///   conditioned problems as \f$J^T J\f$ is never formed.
+  ///
+  /// If the density of the jacobian is lower than the
+  /// ``lm.sparse-threshold'' parameter, the normal equations are
+  /// built and factorized as sparse matrices (Cholesky only). The
+  /// sparsity patterns of \f$J\f$ and \f$J^T J + I\f$, and the
+  /// symbolic factorization, are computed from the jacobian at the
+  /// starting point. Iterations then update the values of these
+  /// matrices in place; the patterns are only rebuilt if the jacobian
+  /// gains non-zeros outside of them.
+  ///
+  /// Dense workspaces are allocated by the first solve, once the path
+  /// is selected, and reused from one iteration (and one solve) to
+  /// the other: the jacobian is used by all the paths, the normal
+  /// matrices only by the dense Cholesky path and the augmented
+  /// system only by the QR path. Sparse workspaces are allocated once
+  /// per solve, but Eigen's sparse factorization itself still uses
+  /// temporary buffers.
+  ///
+  /// Argument bounds are enforced by projecting the iterates, the
+  /// variables on a bound the gradient pushes against are fixed
+  /// during the step computation. Other constraints are not supported.
+  ///
+  /// The starting point is, by order of priority, the warm start, the
+  /// problem starting point or zero. The iteration callback and the
+  /// cancellation token are honored at each iteration.
+  class LevenbergMarquardtSolver
+    : public Solver<DifferentiableFunction,
+		    boost::mpl::vector<LinearFunction, DifferentiableFunction> >
+  {
+  public:
+    /// \brief Define parent's type.
+    typedef Solver<DifferentiableFunction,
+		   boost::mpl::vector<LinearFunction, DifferentiableFunction> >
+    parent_t;
+
+    /// \brief Import size type.
+    typedef DifferentiableFunction::size_type size_type;
+    /// \brief Import value type.
+    typedef DifferentiableFunction::value_type value_type;
+    /// \brief Import vector type.
+    typedef DifferentiableFunction::vector_t vector_t;
+    /// \brief Import matrix type.
+    typedef DifferentiableFunction::matrix_t matrix_t;
+    /// \brief Import jacobian type.
+    typedef DifferentiableFunction::jacobian_t jacobian_t;
+    /// \brief Sparse matrix type.
+    typedef GenericFunctionTraits<EigenMatrixSparse>::matrix_t
+    sparseMatrix_t;
+
+    /// \brief Build a solver from a problem.
+    /// \param problem problem that will be solved
+    explicit LevenbergMarquardtSolver (const problem_t& problem) throw ();
+
+    virtual ~LevenbergMarquardtSolver () throw ();
+
+    /// \brief Implement the solve algorithm.
+    ///
+    /// Implement the solve method as required by the
+    /// #GenericSolver class.
+    virtual void solve () throw ();
+
+    /// \brief Did the last solve use the sparse path?
+    ///
+    /// Defined inline: the clients of the plug-in do not link to it.
+    bool sparse () const throw ()
+    {
+      return sparse_;
+    }
+
+  private:
+    /// \brief Allocate the workspaces of the selected path.
+    ///
+    /// Workspaces are only reallocated if their size changed.
+    void allocateWorkspaces () throw ();
+
+    /// \brief Evaluate the jacobian and the gradient at x_.
+    void computeJacobian () throw ();
+
+    /// \brief Build the normal matrix of the selected path.
+    void buildNormal () throw ();
+
+    /// \brief Compute the sparse patterns from the current jacobian
+    /// and analyze the damped normal matrix.
+    void buildSparsePattern () throw ();
+
+    /// \brief Copy the jacobian into the sparse jacobian pattern.
+    ///
+    /// \return false if the jacobian has non-zeros outside of the
+    /// pattern
+    bool updateSparseJacobian () throw ();
+
+    /// \brief Compute the step for the current damping.
+    ///
+    /// \return false if the factorization failed
+    bool computeStep (value_type damping) throw ();
+
+    /// \brief Dense Cholesky step.
+    bool denseCholeskyStep (value_type damping) throw ();
+    /// \brief Dense QR step.
+    bool denseQrStep (value_type damping) throw ();
+    /// \brief Sparse Cholesky step.
+    bool sparseCholeskyStep (value_type damping) throw ();
+
+    /// \brief Project a point on the argument bounds.
+    void project (vector_t& x) const throw ();
+
+    /// \brief Build the last result.
+    Result lastState (value_type cost) const throw ();
+
+    /// \brief Residuals function (least-squares base function).
+    const DifferentiableFunction* base_;
+
+    /// \brief Maximum number of iterations.
+    ParameterKey<int> maxIterations_;
+    /// \brief Linear solver name.
+    ParameterKey<std::string> linearSolver_;
+    /// \brief Jacobian density below which the sparse path is used.
+    ParameterKey<double> sparseThreshold_;
+    /// \brief Initial damping, relative to the normal matrix diagonal.
+    ParameterKey<double> initialDamping_;
+    /// \brief Gradient tolerance (infinity norm).
+    ParameterKey<double> gradientTolerance_;
+    /// \brief Step tolerance, relative to the argument norm.
+    ParameterKey<double> stepTolerance_;
+    /// \brief Cost tolerance, relative to the cost.
+    ParameterKey<double> costTolerance_;
+
+    /// \brief Was the sparse path used?
+    bool sparse_;
+    /// \brief Use the QR factorization?
+    bool qr_;
+
+    /// \brief Current point.
+    vector_t x_;
+    /// \brief Trial point.
+    vector_t candidate_;
+    /// \brief Residuals at x_.
+    vector_t residuals_;
+    /// \brief Residuals at the trial point.
+    vector_t candidateResiduals_;
+    /// \brief Linearized residuals at the trial point.
+    vector_t predicted_;
+    /// \brief Half the cost gradient (\f$J^T r\f$).
+    vector_t gradient_;
+    /// \brief Step.
+    vector_t step_;
+    /// \brief Residuals jacobian at x_.
+    jacobian_t jacobian_;
+
+    /// \brief Normal matrix \f$J^T J\f$ (lower part).
+    matrix_t normal_;
+    /// \brief Damped normal matrix (lower part).
+    matrix_t damped_;
+    /// \brief Dense Cholesky factorization.
+    Eigen::LDLT<matrix_t> ldlt_;
+
+    /// \brief Augmented jacobian \f$[J; \sqrt{\mu} I]\f$.
+    matrix_t augmented_;
+    /// \brief Augmented right-hand side \f$[-r; 0]\f$.
+    vector_t augmentedRhs_;
+    /// \brief Dense QR factorization.
+    Eigen::HouseholderQR<matrix_t> householder_;
+
+    /// \brief Sparse jacobian (fixed pattern).
+    sparseMatrix_t sparseJacobian_;
+    /// \brief Sparse damped normal matrix (fixed pattern).
+    sparseMatrix_t sparseDamped_;
+    /// \brief Sparse identity.
+    sparseMatrix_t sparseIdentity_;
+    /// \brief Values of \f$J^T J\f$ on the damped matrix pattern.
+    vector_t sparseNormal_;
+    /// \brief Positions of the diagonal in the damped matrix values.
+    std::vector<size_type> diagonal_;
+    /// \brief Sparse Cholesky factorization.
+    Eigen::SimplicialLDLT<sparseMatrix_t> sparseLdlt_;
+  };
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_PLUGIN_LM_HH
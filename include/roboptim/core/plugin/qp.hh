@@ -0,0 +1,193 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_PLUGIN_QP_HH
+# define ROBOPTIM_CORE_PLUGIN_QP_HH
+# include <string>
+# include <vector>
+
+# include <boost/mpl/vector.hpp>
+
+# include <roboptim/core/linear-function.hh>
+# include <roboptim/core/quadratic-function.hh>
+# include <roboptim/core/solver.hh>
+
+namespace roboptim
+{
+  /// \brief Dense active-set solver for strictly convex quadratic programs.
+  ///
+  /// Solve
+  /// \f[\min_x \frac{1}{2} x^T G x + a^T x + c\f]
+  /// under linear constraints and argument bounds, using the dual
+  /// active-set method of Goldfarb and Idnani: the solver starts from
+  /// the unconstrained minimum and adds the violated constraints one
+  /// by one, dropping the constraints whose multiplier would become
+  /// negative. The hessian \f$G\f$ has to be positive definite.
+  ///
+  /// The problem data are extracted once when the solver is built:
+  /// \f$G\f$, \f$a\f$ and \f$c\f$ from the objective hessian, gradient
+  /// and value at zero and the constraints matrices from their
+  /// jacobians and values at zero. \f$G\f$ is factorized once too.
+  /// During the solve, the factorization of the active constraints
+  /// matrix is updated by Givens rotations when a constraint is added
+  /// or dropped, never recomputed.
+  ///
+  /// All workspaces are allocated when the solver is built: repeated
+  /// solves do not allocate memory, except for the result itself.
+  ///
+  /// Multipliers are returned in Result::lambda: one per constraint
+  /// row (stacked in the problem order), then one per argument. They
+  /// are positive when the lower bound is active and negative when
+  /// the upper bound is active.
+  ///
+  /// A dual method has to start from the unconstrained minimum, the
+  /// primal point of a warm start is therefore ignored. Its active
+  /// set (rows indices, in the same layout as the multipliers) or,
+  /// if there is none, the sign of its multipliers, tell which
+  /// constraints are tried first: for slowly varying problems
+  /// (model predictive control...) the previous active set is
+  /// usually rebuilt without exploring other constraints.
+  class ActiveSetQpSolver
+    : public Solver<QuadraticFunction, boost::mpl::vector<LinearFunction> >
+  {
+  public:
+    /// \brief Define parent's type.
+    typedef Solver<QuadraticFunction, boost::mpl::vector<LinearFunction> >
+    parent_t;
+
+    /// \brief Import size type.
+    typedef QuadraticFunction::size_type size_type;
+    /// \brief Import value type.
+    typedef QuadraticFunction::value_type value_type;
+    /// \brief Import vector type.
+    typedef QuadraticFunction::vector_t vector_t;
+    /// \brief Import matrix type.
+    typedef QuadraticFunction::matrix_t matrix_t;
+
+    /// \brief Build a solver from a problem.
+    /// \param problem problem that will be solved
+    explicit ActiveSetQpSolver (const problem_t& problem) throw ();
+
+    virtual ~ActiveSetQpSolver () throw ();
+
+    /// \brief Implement the solve algorithm.
+    ///
+    /// Implement the solve method as required by the
+    /// #GenericSolver class.
+    virtual void solve () throw ();
+
+  private:
+    /// \brief Constraint side: one linear inequality \f$n^T x \geq b\f$
+    /// (or equality).
+    struct Side
+    {
+      /// \brief Row in the multipliers layout.
+      size_type row;
+      /// \brief +1 for a lower bound, -1 for an upper bound.
+      value_type sign;
+      /// \brief Is it an equality?
+      bool equality;
+    };
+
+    /// \brief Add one constraint side per finite bound.
+    void addSides (size_type row, const matrix_t& a, const vector_t& b,
+		   const Function::intervals_t& intervals) throw ();
+
+    /// \brief Compute the primal (z_) and dual (r_) step directions
+    /// for the side p.
+    void computeDirections (size_type p) throw ();
+
+    /// \brief Add the side p to the active set.
+    ///
+    /// \return false if the side is linearly dependent
+    bool addConstraint (size_type p) throw ();
+
+    /// \brief Drop the active constraint at position k.
+    void dropConstraint (size_type k) throw ();
+
+    /// \brief Select the next violated side.
+    ///
+    /// \return the number of sides if all of them are satisfied
+    size_type violatedSide (value_type tolerance) const throw ();
+
+    /// \brief Objective value at x_.
+    value_type cost () const throw ();
+
+    /// \brief Build the last result.
+    Result lastState () const throw ();
+
+    /// \brief Error detected when extracting the problem data.
+    std::string error_;
+
+    /// \brief Maximum number of iterations.
+    ParameterKey<int> maxIterations_;
+    /// \brief Feasibility tolerance.
+    ParameterKey<double> tolerance_;
+
+    /// \brief Objective hessian.
+    matrix_t g_;
+    /// \brief Objective gradient at zero.
+    vector_t a_;
+    /// \brief Objective value at zero.
+    value_type c_;
+    /// \brief Cholesky factorization of the hessian.
+    Eigen::LLT<matrix_t> llt_;
+    /// \brief Inverse of the transposed Cholesky factor.
+    matrix_t inverseFactor_;
+
+    /// \brief Constraint sides normals (one per column).
+    matrix_t normals_;
+    /// \brief Constraint sides right-hand sides.
+    vector_t bounds_;
+    /// \brief Constraint sides normals norms.
+    vector_t norms_;
+    /// \brief Constraint sides description.
+    std::vector<Side> sides_;
+    /// \brief Multipliers layout size.
+    size_type rows_;
+
+    /// \brief Current point.
+    vector_t x_;
+    /// \brief Constraint sides slacks.
+    vector_t slacks_;
+    /// \brief \f$J = L^{-T} Q\f$, where \f$G = L L^T\f$ and
+    /// \f$L^{-1} N = Q R\f$ (\f$N\f$: active normals).
+    matrix_t j_;
+    /// \brief Triangular factor \f$R\f$ of the active constraints.
+    matrix_t r_;
+    /// \brief Active sides.
+    std::vector<size_type> active_;
+    /// \brief Active sides multipliers.
+    vector_t u_;
+    /// \brief Is the side active?
+    std::vector<bool> isActive_;
+    /// \brief Is the side in the warm start active set?
+    std::vector<bool> preferred_;
+    /// \brief Transformed normal.
+    vector_t d_;
+    /// \brief Primal step direction.
+    vector_t z_;
+    /// \brief Dual step direction.
+    vector_t dual_;
+    /// \brief Hessian-vector product buffer.
+    mutable vector_t buffer_;
+  };
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_PLUGIN_QP_HH
@@ -0,0 +1,370 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_PRESOLVE_HH
+# define ROBOPTIM_CORE_PRESOLVE_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <iostream>
+# include <map>
+# include <utility>
+# include <vector>
+
+# include <boost/shared_ptr.hpp>
+
+# include <roboptim/core/fwd.hh>
+# include <roboptim/core/constraints-evaluator.hh>
+# include <roboptim/core/filter/restriction.hh>
+# include <roboptim/core/problem.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_problem
+  /// @{
+
+  /// \brief Simplify a problem before solving it.
+  ///
+  /// The presolve builds a reduced problem which is equivalent to
+  /// the original one:
+  /// - variables whose lower and upper bounds are equal are fixed and
+  ///   removed from the problem,
+  /// - constraints whose intervals are infinite on both sides are
+  ///   dropped,
+  /// - linear constraints whose rows depend on a single (free)
+  ///   variable are turned into argument bounds,
+  /// - duplicated linear constraint rows are merged, their intervals
+  ///   are intersected. Rows are compared once normalized (divided
+  ///   by their first non-zero coefficient), within a constraint or
+  ///   across constraints. A duplicated row is removed from its
+  ///   constraint when the constraint is rebuilt, otherwise its
+  ///   interval is made infinite. Constraints whose rows are all
+  ///   duplicated are removed.
+  /// .
+  ///
+  /// The reduced problem is solved instead of the original one and
+  /// postsolve maps its result back to the original problem.
+  ///
+  /// Cost function and non-linear constraints are wrapped into a
+  /// Restriction filter, reduced linear constraints are rebuilt as
+  /// NumericLinearFunction when the constraint type allows it.
+  /// SparseNumericLinearFunction constraints are read through A ()
+  /// and rebuilt as SparseNumericLinearFunction: they are never
+  /// expanded into dense matrices. As for
+  /// the Split filter, the cost function and constraints types must
+  /// then be abstract function types (Function,
+  /// DifferentiableFunction, LinearFunction, etc.).
+  ///
+  /// \warning The original problem cost function has to outlive the
+  /// presolve object.
+  ///
+  /// \tparam P problem type
+  template <typename P>
+  class Presolve
+  {
+  public:
+    /// \brief Problem type.
+    typedef P problem_t;
+    /// \brief Import function type.
+    typedef typename problem_t::function_t function_t;
+    /// \brief Import constraint type.
+    typedef typename problem_t::constraint_t constraint_t;
+    /// \brief Import intervals type.
+    typedef typename problem_t::intervals_t intervals_t;
+    /// \brief Import scales type.
+    typedef typename problem_t::scales_t scales_t;
+
+    /// \brief Import value type.
+    typedef DifferentiableFunction::value_type value_type;
+    /// \brief Import size type.
+    typedef DifferentiableFunction::size_type size_type;
+    /// \brief Import vector type.
+    typedef DifferentiableFunction::vector_t vector_t;
+    /// \brief Import jacobian type.
+    typedef DifferentiableFunction::jacobian_t jacobian_t;
+    /// \brief Import sparse matrix type.
+    typedef SparseNumericLinearFunction::sparseMatrix_t sparseMatrix_t;
+
+    /// \brief Presolve a problem.
+    ///
+    /// \param problem original problem
+    /// \param epsilon tolerance used to compare coefficients
+    explicit Presolve (const problem_t& problem, value_type epsilon = 0.)
+      throw ();
+    ~Presolve () throw ();
+
+    /// \brief Reduced problem.
+    const problem_t& problem () const throw ();
+
+    /// \brief Indices of the variables kept in the reduced problem.
+    const std::vector<size_type>& freeVariables () const throw ();
+
+    /// \brief Original argument holding the fixed variables values.
+    ///
+    /// Free variables are set to zero.
+    const vector_t& fixedPoint () const throw ();
+
+    /// \brief Original index of each reduced problem constraint.
+    const std::vector<std::size_t>& constraintsMap () const throw ();
+
+    /// \brief Has the presolve detected that the problem is infeasible?
+    bool infeasible () const throw ();
+
+    /// \brief Build an original argument from a reduced one.
+    vector_t expand (const vector_t& x) const throw ();
+
+    /// \brief Map a reduced problem result to the original problem.
+    ///
+    /// The argument is expanded and the original constraints are
+    /// evaluated.
+    ///
+    /// Lagrange multipliers are mapped back if there is one
+    /// multiplier per reduced constraint row, optionally followed by
+    /// one multiplier per reduced argument (the layout of the qp
+    /// plug-in). The multiplier of an active reduced bound goes to
+    /// the original constraint or argument bound it comes from: the
+    /// multiplier of an argument bound set by a constraint row is
+    /// moved (divided by the row coefficient) to this row, and the
+    /// multiplier of an interval set by a merged duplicate row is
+    /// moved (divided by the ratio of the rows) to the duplicate.
+    /// Other original constraint rows get a zero
+    /// multiplier.
+    ///
+    /// The multiplier of a fixed variable bound is its reduced cost
+    /// \f$(\nabla f(x) - J(x)^T \lambda)_j\f$, \f$\lambda\f$ being the
+    /// postsolved constraints multipliers, so that the stationarity
+    /// condition \f$\nabla f(x) = J(x)^T \lambda + \lambda_{bounds}\f$
+    /// of the qp layout holds for the original problem. It is zero
+    /// if the cost function is not differentiable.
+    ///
+    /// Multipliers following any other layout cannot be mapped: the
+    /// postsolved multipliers are then cleared.
+    ///
+    /// \tparam R result type (Result or ResultWithWarnings)
+    template <typename R>
+    R postsolve (const R& result) const throw ();
+
+    /// \brief Display the presolve statistics.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    std::ostream& print (std::ostream& o) const throw ();
+
+  private:
+    /// \brief Process the original problem constraints.
+    void reduceConstraints (const problem_t& problem) throw ();
+
+    /// \brief Try to turn a linear constraint into argument bounds.
+    ///
+    /// \param offset first original row of the constraint
+    /// \return true if the constraint has been removed
+    bool linearToBounds (const jacobian_t& a,
+			 const vector_t& b,
+			 const intervals_t& intervals,
+			 size_type offset) throw ();
+
+    /// \brief Try to turn a sparse linear constraint into argument
+    /// bounds.
+    ///
+    /// \param offset first original row of the constraint
+    /// \return true if the constraint has been removed
+    bool linearToBounds (const sparseMatrix_t& a,
+			 const vector_t& b,
+			 const intervals_t& intervals,
+			 size_type offset) throw ();
+
+    /// \brief Turn rows depending on one variable at most into
+    /// argument bounds.
+    ///
+    /// \param variable variable of each row (-1 for constant rows)
+    /// \param coefficient coefficient of the variable in each row
+    /// \param offset first original row of the constraint
+    /// \return true
+    bool rowsToBounds (const std::vector<size_type>& variable,
+		       const std::vector<value_type>& coefficient,
+		       const vector_t& b,
+		       const intervals_t& intervals,
+		       size_type offset) throw ();
+
+    /// \brief Reduce a sparse linear constraint.
+    ///
+    /// The fixed variables move into the constant term.
+    ///
+    /// \param constraint original constraint
+    /// \param a reduced matrix
+    /// \param b reduced constant term
+    void restrictSparse (const SparseNumericLinearFunction& constraint,
+			 sparseMatrix_t& a,
+			 vector_t& b) const throw ();
+
+    /// \brief Origin of a reduced bound.
+    struct Origin
+    {
+      /// \brief Original constraint row, or -1 for an argument bound.
+      size_type row;
+      /// \brief Coefficient of the variable in this row.
+      value_type coefficient;
+    };
+
+    /// \brief Origins of a lower and an upper bound.
+    typedef std::pair<Origin, Origin> origins_t;
+
+    /// \brief Build an origin.
+    static Origin makeOrigin (size_type row, value_type coefficient) throw ();
+
+    /// \brief Move a reduced multiplier to its origin.
+    ///
+    /// \param lambda postsolved multipliers
+    /// \param multiplier reduced multiplier
+    /// \param value value of the bounded quantity
+    /// \param interval reduced bounds
+    /// \param origins origins of the bounds
+    /// \param argumentRow row of the argument bound multiplier
+    void moveMultiplier (vector_t& lambda,
+			 value_type multiplier,
+			 value_type value,
+			 const Function::interval_t& interval,
+			 const origins_t& origins,
+			 size_type argumentRow) const throw ();
+
+    /// \brief Normalized reduced linear constraint row.
+    ///
+    /// The row \f$a^T x + b\f$ is divided by its first non-zero
+    /// coefficient, so that two rows are duplicates if their
+    /// normalized forms are equal.
+    struct LinearRow
+    {
+      /// \brief Non-zero coefficients (column, normalized value).
+      std::vector<std::pair<size_type, value_type> > coefficients;
+      /// \brief Normalized constant term.
+      value_type constant;
+      /// \brief First non-zero coefficient (normalization factor).
+      value_type scale;
+      /// \brief Reduced constraint index.
+      std::size_t constraint;
+      /// \brief Row in the reduced constraint.
+      std::size_t row;
+    };
+
+    /// \brief Normalize the rows of a reduced linear constraint.
+    void normalizeRows (const jacobian_t& a,
+			const vector_t& b,
+			std::vector<LinearRow>& rows) const throw ();
+
+    /// \brief Normalize the rows of a reduced sparse linear constraint.
+    void normalizeRows (const sparseMatrix_t& a,
+			const vector_t& b,
+			std::vector<LinearRow>& rows) const throw ();
+
+    /// \brief Kept rows indices, by hash of their normalized form.
+    typedef std::multimap<std::size_t, std::size_t> buckets_t;
+
+    /// \brief Hash a normalized row.
+    ///
+    /// Coefficients are rounded on a grid coarser than the tolerance,
+    /// so that rows equal up to the tolerance almost always share
+    /// their hash. Round values lie at the center of the grid cells.
+    /// Duplicates straddling a cell boundary are not detected, which
+    /// is safe.
+    std::size_t hashRow (const LinearRow& row) const throw ();
+
+    /// \brief Merge the rows duplicating a previously kept row.
+    ///
+    /// The interval of a duplicated row is intersected with the one
+    /// of the kept row, other rows are registered as kept rows. A row
+    /// is only compared to the kept rows having the same hash.
+    ///
+    /// \param rows normalized rows of the constraint
+    /// \param bounds constraint intervals
+    /// \param origins origins of the constraint intervals
+    /// \param intervals reduced constraints intervals
+    /// \param kept previously kept rows
+    /// \param buckets kept rows indices, by hash
+    /// \param offset first original row of the constraint
+    /// \param keep set to false for the duplicated rows
+    /// \return number of duplicated rows
+    std::size_t mergeRows (std::vector<LinearRow>& rows,
+			   intervals_t& bounds,
+			   std::vector<origins_t>& origins,
+			   std::vector<intervals_t>& intervals,
+			   std::vector<LinearRow>& kept,
+			   buckets_t& buckets,
+			   size_type offset,
+			   std::vector<bool>& keep) throw ();
+
+    /// \brief Intersect the interval of a kept row with the one of
+    /// its duplicate.
+    ///
+    /// \param kept kept row interval
+    /// \param keptOrigins origins of the kept row interval
+    /// \param interval duplicate interval
+    /// \param row original row of the duplicate
+    /// \param ratio duplicate row divided by the kept row
+    void mergeRow (Function::interval_t& kept,
+		   origins_t& keptOrigins,
+		   const Function::interval_t& interval,
+		   size_type row,
+		   value_type ratio) throw ();
+
+    /// \brief Tolerance used to compare coefficients.
+    value_type epsilon_;
+    /// \brief Original problem input size.
+    size_type inputSize_;
+    /// \brief Free variables.
+    std::vector<size_type> free_;
+    /// \brief Fixed variables values.
+    vector_t fixedPoint_;
+
+    /// \brief Reduced cost function.
+    boost::shared_ptr<Restriction<function_t> > function_;
+    /// \brief Reduced problem.
+    boost::shared_ptr<problem_t> problem_;
+    /// \brief Original constraints evaluator (postsolve).
+    ConstraintsEvaluator<problem_t> evaluator_;
+    /// \brief Original index of the reduced constraints.
+    std::vector<std::size_t> map_;
+    /// \brief Origins of the reduced constraints intervals.
+    std::vector<std::vector<origins_t> > rowOrigins_;
+    /// \brief Original row of each reduced constraint row.
+    std::vector<std::vector<size_type> > rowsMap_;
+    /// \brief Origins of the reduced argument bounds.
+    std::vector<origins_t> boundOrigins_;
+
+    /// \brief Number of dropped (unbounded) constraints.
+    std::size_t dropped_;
+    /// \brief Number of constraints turned into bounds.
+    std::size_t bounds_;
+    /// \brief Number of merged duplicated rows.
+    std::size_t duplicates_;
+    /// \brief Infeasibility flag.
+    bool infeasible_;
+  };
+
+  /// \brief Override operator<< to display the presolve statistics.
+  ///
+  /// \param o output stream used for display
+  /// \param presolve presolve to be displayed
+  /// \return output stream
+  template <typename P>
+  std::ostream& operator<< (std::ostream& o, const Presolve<P>& presolve);
+
+  /// @}
+
+} // end of namespace roboptim
+
+# include <roboptim/core/presolve.hxx>
+#endif //! ROBOPTIM_CORE_PRESOLVE_HH
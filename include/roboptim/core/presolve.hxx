@@ -0,0 +1,1016 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_PRESOLVE_HXX
+# define ROBOPTIM_CORE_PRESOLVE_HXX
+# include <algorithm>
+# include <cmath>
+
+# include <boost/functional/hash.hpp>
+# include <boost/make_shared.hpp>
+# include <boost/mpl/bool.hpp>
+# include <boost/mpl/int.hpp>
+# include <boost/type_traits/is_base_of.hpp>
+# include <boost/type_traits/is_same.hpp>
+# include <boost/variant/apply_visitor.hpp>
+# include <boost/variant/static_visitor.hpp>
+
+# include <roboptim/core/indent.hh>
+# include <roboptim/core/numeric-linear-function.hh>
+# include <roboptim/core/sparse-numeric-linear-function.hh>
+# include <roboptim/core/util.hh>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    /// \internal
+    /// \brief Deleter used to wrap objects which are not owned.
+    struct NoopDeleter
+    {
+      void operator () (const void*) const
+      {}
+    };
+
+    /// \internal
+    /// \brief Restrict a constraint type which cannot hold a
+    /// NumericLinearFunction.
+    template <typename U>
+    boost::shared_ptr<U>
+    restrictConstraint (const boost::shared_ptr<U>& constraint,
+			const Function::vector_t& point,
+			const std::vector<Function::size_type>& free,
+			const DifferentiableFunction::jacobian_t*,
+			const Function::vector_t*,
+			boost::mpl::int_<0>)
+    {
+      return boost::make_shared<Restriction<U> > (constraint, point, free);
+    }
+
+    /// \internal
+    /// \brief Restrict a constraint type which can hold a
+    /// NumericLinearFunction.
+    template <typename U>
+    boost::shared_ptr<U>
+    restrictConstraint (const boost::shared_ptr<U>& constraint,
+			const Function::vector_t& point,
+			const std::vector<Function::size_type>& free,
+			const DifferentiableFunction::jacobian_t* a,
+			const Function::vector_t* b,
+			boost::mpl::int_<1>)
+    {
+      if (a && b)
+	return boost::make_shared<NumericLinearFunction> (*a, *b);
+      return boost::make_shared<Restriction<U> > (constraint, point, free);
+    }
+
+    /// \internal
+    /// \brief Restrict a NumericLinearFunction constraint.
+    template <typename U>
+    boost::shared_ptr<U>
+    restrictConstraint (const boost::shared_ptr<U>&,
+			const Function::vector_t&,
+			const std::vector<Function::size_type>&,
+			const DifferentiableFunction::jacobian_t* a,
+			const Function::vector_t* b,
+			boost::mpl::int_<2>)
+    {
+      assert (a && b);
+      return boost::make_shared<NumericLinearFunction> (*a, *b);
+    }
+
+    /// \internal
+    /// \brief Build the reduced version of a constraint.
+    ///
+    /// If the linear part is given, the reduced constraint is a
+    /// NumericLinearFunction whenever the constraint type allows it,
+    /// otherwise it is a Restriction.
+    template <typename P>
+    struct restrictConstraintVisitor
+      : public boost::static_visitor<typename P::constraint_t>
+    {
+      restrictConstraintVisitor
+      (const Function::vector_t& point,
+       const std::vector<Function::size_type>& free,
+       const DifferentiableFunction::jacobian_t* a,
+       const Function::vector_t* b)
+	: point_ (point),
+	  free_ (free),
+	  a_ (a),
+	  b_ (b)
+      {}
+
+      template <typename U>
+      typename P::constraint_t
+      operator () (const boost::shared_ptr<U>& constraint) const
+      {
+	typedef boost::mpl::int_
+	  <boost::is_same<U, NumericLinearFunction>::value ? 2
+	   : (boost::is_base_of<U, NumericLinearFunction>::value ? 1 : 0)>
+	  kind_t;
+	return typename P::constraint_t
+	  (restrictConstraint (constraint, point_, free_, a_, b_, kind_t ()));
+      }
+
+    private:
+      const Function::vector_t& point_;
+      const std::vector<Function::size_type>& free_;
+      const DifferentiableFunction::jacobian_t* a_;
+      const Function::vector_t* b_;
+    };
+
+    /// \internal
+    /// \brief Rebuild a reduced sparse linear constraint.
+    template <typename U>
+    boost::shared_ptr<U>
+    restrictSparseConstraint (const boost::shared_ptr<U>&,
+			      const SparseNumericLinearFunction::sparseMatrix_t& a,
+			      const Function::vector_t& b,
+			      boost::mpl::true_)
+    {
+      return boost::make_shared<SparseNumericLinearFunction> (a, b);
+    }
+
+    /// \internal
+    /// \brief Constraint types which cannot hold a
+    /// SparseNumericLinearFunction are reduced by the generic path,
+    /// see isRebuildableSparseConstraintVisitor. This overload is
+    /// only required to instantiate the visitor.
+    template <typename U>
+    boost::shared_ptr<U>
+    restrictSparseConstraint (const boost::shared_ptr<U>& constraint,
+			      const SparseNumericLinearFunction::sparseMatrix_t&,
+			      const Function::vector_t&,
+			      boost::mpl::false_)
+    {
+      assert (0 && "constraint type cannot hold a sparse linear function");
+      return constraint;
+    }
+
+    /// \internal
+    /// \brief Build the reduced version of a sparse linear constraint.
+    template <typename P>
+    struct restrictSparseConstraintVisitor
+      : public boost::static_visitor<typename P::constraint_t>
+    {
+      restrictSparseConstraintVisitor
+      (const SparseNumericLinearFunction::sparseMatrix_t& a,
+       const Function::vector_t& b)
+	: a_ (a),
+	  b_ (b)
+      {}
+
+      template <typename U>
+      typename P::constraint_t
+      operator () (const boost::shared_ptr<U>& constraint) const
+      {
+	typedef boost::mpl::bool_
+	  <boost::is_base_of<U, SparseNumericLinearFunction>::value> kind_t;
+	return typename P::constraint_t
+	  (restrictSparseConstraint (constraint, a_, b_, kind_t ()));
+      }
+
+    private:
+      const SparseNumericLinearFunction::sparseMatrix_t& a_;
+      const Function::vector_t& b_;
+    };
+
+    /// \internal
+    /// \brief Can a reduced sparse linear constraint be rebuilt as a
+    /// SparseNumericLinearFunction?
+    ///
+    /// A constraint whose static type is a subclass of
+    /// SparseNumericLinearFunction cannot.
+    struct isRebuildableSparseConstraintVisitor
+      : public boost::static_visitor<bool>
+    {
+      template <typename U>
+      bool operator () (const boost::shared_ptr<U>&) const
+      {
+	return boost::is_base_of<U, SparseNumericLinearFunction>::value;
+      }
+    };
+
+    /// \internal
+    /// \brief Can a reduced linear constraint be rebuilt as a
+    /// NumericLinearFunction?
+    struct isRebuildableConstraintVisitor
+      : public boost::static_visitor<bool>
+    {
+      template <typename U>
+      bool operator () (const boost::shared_ptr<U>&) const
+      {
+	return boost::is_base_of<U, NumericLinearFunction>::value;
+      }
+    };
+
+    /// \internal
+    /// \brief Add a constraint to a problem.
+    template <typename P>
+    struct addConstraintVisitor : public boost::static_visitor<void>
+    {
+      addConstraintVisitor (P& problem,
+			    const typename P::intervals_t& intervals,
+			    const typename P::scales_t& scales)
+	: problem_ (problem),
+	  intervals_ (intervals),
+	  scales_ (scales)
+      {}
+
+      template <typename U>
+      void operator () (const boost::shared_ptr<U>& constraint) const
+      {
+	problem_.addConstraint (constraint, intervals_, scales_);
+      }
+
+    private:
+      P& problem_;
+      const typename P::intervals_t& intervals_;
+      const typename P::scales_t& scales_;
+    };
+
+    /// \internal
+    /// \brief Is an interval infinite on both sides?
+    inline bool
+    isInfiniteInterval (const Function::interval_t& interval)
+    {
+      return interval.first == -Function::infinity ()
+	&& interval.second == Function::infinity ();
+    }
+  } // end of namespace detail.
+
+  template <typename P>
+  Presolve<P>::Presolve (const problem_t& problem, value_type epsilon)
+    throw ()
+    : epsilon_ (epsilon),
+      inputSize_ (problem.function ().inputSize ()),
+      free_ (),
+      fixedPoint_ (problem.function ().inputSize ()),
+      function_ (),
+      problem_ (),
+      evaluator_ (problem),
+      map_ (),
+      rowOrigins_ (),
+      rowsMap_ (),
+      boundOrigins_ (),
+      dropped_ (0),
+      bounds_ (0),
+      duplicates_ (0),
+      infeasible_ (false)
+  {
+    // Fixed variables.
+    const intervals_t& argumentBounds = problem.argumentBounds ();
+    fixedPoint_.setZero ();
+    for (size_type i = 0; i < inputSize_; ++i)
+      if (argumentBounds[i].first == argumentBounds[i].second)
+	fixedPoint_[i] = argumentBounds[i].first;
+      else
+	free_.push_back (i);
+
+    // Reduced cost function and problem.
+    function_ = boost::make_shared<Restriction<function_t> >
+      (boost::shared_ptr<const function_t>
+       (&problem.function (), detail::NoopDeleter ()),
+       fixedPoint_, free_);
+    problem_ = boost::make_shared<problem_t> (*function_);
+    boundOrigins_.resize
+      (free_.size (), std::make_pair (makeOrigin (-1, 1.),
+				      makeOrigin (-1, 1.)));
+
+    for (std::size_t k = 0; k < free_.size (); ++k)
+      {
+	problem_->argumentBounds ()[k] = argumentBounds[free_[k]];
+	problem_->argumentScales ()[k] = problem.argumentScales ()[free_[k]];
+      }
+    if (problem.startingPoint ())
+      {
+	vector_t x (free_.size ());
+	for (std::size_t k = 0; k < free_.size (); ++k)
+	  x[k] = (*problem.startingPoint ())[free_[k]];
+	problem_->startingPoint () = x;
+      }
+
+    reduceConstraints (problem);
+  }
+
+  template <typename P>
+  Presolve<P>::~Presolve () throw ()
+  {
+  }
+
+  template <typename P>
+  void
+  Presolve<P>::reduceConstraints (const problem_t& problem) throw ()
+  {
+    std::vector<constraint_t> constraints;
+    std::vector<intervals_t> intervals;
+    std::vector<scales_t> scales;
+
+    // Normalized rows of the reduced linear constraints, used to
+    // detect duplicates.
+    std::vector<LinearRow> kept;
+    buckets_t buckets;
+
+    for (std::size_t i = 0; i < problem.constraints ().size (); ++i)
+      {
+	const constraint_t& constraint = problem.constraints ()[i];
+	const intervals_t& bounds = problem.boundsVector ()[i];
+	const scales_t& rowScales = problem.scalesVector ()[i];
+	const size_type offset = evaluator_.offsets ()[i];
+
+	// Until they are merged, the intervals come from the
+	// constraint itself.
+	std::vector<origins_t> origins (bounds.size ());
+	std::vector<size_type> rowsMap (bounds.size ());
+	for (std::size_t r = 0; r < bounds.size (); ++r)
+	  {
+	    const size_type row = offset + static_cast<size_type> (r);
+	    origins[r] = std::make_pair (makeOrigin (row, 1.),
+					 makeOrigin (row, 1.));
+	    rowsMap[r] = row;
+	  }
+
+	bool unbounded = true;
+	for (std::size_t r = 0; r < bounds.size (); ++r)
+	  unbounded = unbounded && detail::isInfiniteInterval (bounds[r]);
+	if (unbounded)
+	  {
+	    ++dropped_;
+	    continue;
+	  }
+
+	// Sparse linear constraints: their matrix is read and reduced
+	// directly, never expanded. Constraints whose type cannot hold
+	// the rebuilt function go through the generic path.
+	const SparseNumericLinearFunction* sparse = boost::apply_visitor
+	  (detail::sparseLinearConstraintVisitor (), constraint);
+	if (sparse
+	    && boost::apply_visitor
+	    (detail::isRebuildableSparseConstraintVisitor (), constraint))
+	  {
+	    sparseMatrix_t a;
+	    vector_t b;
+	    restrictSparse (*sparse, a, b);
+
+	    if (linearToBounds (a, b, bounds, offset))
+	      {
+		++bounds_;
+		continue;
+	      }
+
+	    std::vector<LinearRow> rows;
+	    normalizeRows (a, b, rows);
+	    intervals_t reducedBounds (bounds);
+	    std::vector<bool> keep;
+	    const std::size_t duplicates = mergeRows
+	      (rows, reducedBounds, origins, intervals, kept, buckets,
+	       offset, keep);
+	    duplicates_ += duplicates;
+	    if (duplicates == rows.size ())
+	      continue;
+
+	    // Duplicated rows are removed from the rebuilt constraint.
+	    typedef Eigen::Triplet<value_type> triplet_t;
+	    std::vector<triplet_t> triplets;
+	    vector_t reducedB (static_cast<size_type> (rows.size () - duplicates));
+	    intervals_t keptBounds;
+	    scales_t keptScales;
+	    std::vector<origins_t> keptOrigins;
+	    std::vector<size_type> keptRows;
+	    for (std::size_t r = 0; r < rows.size (); ++r)
+	      {
+		if (!keep[r])
+		  continue;
+		const size_type row = static_cast<size_type> (keptBounds.size ());
+		for (typename sparseMatrix_t::InnerIterator
+		       it (a, static_cast<size_type> (r)); it; ++it)
+		  triplets.push_back (triplet_t (row, it.col (), it.value ()));
+		reducedB[row] = b[static_cast<size_type> (r)];
+		keptBounds.push_back (reducedBounds[r]);
+		keptScales.push_back (rowScales[r]);
+		keptOrigins.push_back (origins[r]);
+		keptRows.push_back (rowsMap[r]);
+	      }
+	    sparseMatrix_t reducedA (reducedB.size (), a.cols ());
+	    reducedA.setFromTriplets (triplets.begin (), triplets.end ());
+
+	    detail::restrictSparseConstraintVisitor<problem_t> visitor
+	      (reducedA, reducedB);
+	    constraints.push_back (boost::apply_visitor (visitor, constraint));
+	    intervals.push_back (keptBounds);
+	    scales.push_back (keptScales);
+	    map_.push_back (i);
+	    rowOrigins_.push_back (keptOrigins);
+	    rowsMap_.push_back (keptRows);
+	    continue;
+	  }
+
+	// Same linearity criterion as the constraints evaluator.
+	if (!boost::apply_visitor (detail::isLinearConstraintVisitor (),
+				   constraint))
+	  {
+	    detail::restrictConstraintVisitor<problem_t> visitor
+	      (fixedPoint_, free_, 0, 0);
+	    constraints.push_back (boost::apply_visitor (visitor, constraint));
+	    intervals.push_back (bounds);
+	    scales.push_back (rowScales);
+	    map_.push_back (i);
+	    rowOrigins_.push_back (origins);
+	    rowsMap_.push_back (rowsMap);
+	    continue;
+	  }
+
+	// Reduced linear part: the fixed variables move into the
+	// constant term.
+	const ConstraintDispatch linear = boost::apply_visitor
+	  (detail::makeConstraintDispatchVisitor (), constraint);
+	const size_type rows = static_cast<size_type> (bounds.size ());
+	jacobian_t jacobian (rows, inputSize_);
+	linear.jacobian (linear.object, jacobian, fixedPoint_);
+	jacobian_t a (rows, static_cast<size_type> (free_.size ()));
+	for (std::size_t k = 0; k < free_.size (); ++k)
+	  a.col (k) = jacobian.col (free_[k]);
+	vector_t b (rows);
+	linear.compute (linear.object, b, fixedPoint_);
+
+	if (linearToBounds (a, b, bounds, offset))
+	  {
+	    ++bounds_;
+	    continue;
+	  }
+
+	std::vector<LinearRow> normalized;
+	normalizeRows (a, b, normalized);
+	intervals_t reducedBounds (bounds);
+	std::vector<bool> keep;
+	const std::size_t duplicates = mergeRows
+	  (normalized, reducedBounds, origins, intervals, kept, buckets,
+	   offset, keep);
+	duplicates_ += duplicates;
+	if (duplicates == normalized.size ())
+	  continue;
+
+	// Constraint types which cannot hold a NumericLinearFunction
+	// keep all their rows: the duplicated ones become unbounded.
+	if (!boost::apply_visitor
+	    (detail::isRebuildableConstraintVisitor (), constraint))
+	  {
+	    std::vector<std::size_t> position;
+	    for (std::size_t r = 0; r < keep.size (); ++r)
+	      if (keep[r])
+		position.push_back (r);
+	      else
+		reducedBounds[r] = Function::makeInfiniteInterval ();
+	    for (typename std::vector<LinearRow>::reverse_iterator
+		   it = kept.rbegin ();
+		 it != kept.rend () && it->constraint == intervals.size (); ++it)
+	      it->row = position[it->row];
+	    detail::restrictConstraintVisitor<problem_t> visitor
+	      (fixedPoint_, free_, 0, 0);
+	    constraints.push_back (boost::apply_visitor (visitor, constraint));
+	    intervals.push_back (reducedBounds);
+	    scales.push_back (rowScales);
+	    map_.push_back (i);
+	    rowOrigins_.push_back (origins);
+	    rowsMap_.push_back (rowsMap);
+	    continue;
+	  }
+
+	// Duplicated rows are removed from the rebuilt constraint.
+	const size_type keptSize =
+	  rows - static_cast<size_type> (duplicates);
+	jacobian_t reducedA (keptSize, a.cols ());
+	vector_t reducedB (keptSize);
+	intervals_t keptBounds;
+	scales_t keptScales;
+	std::vector<origins_t> keptOrigins;
+	std::vector<size_type> keptRows;
+	for (std::size_t r = 0; r < keep.size (); ++r)
+	  {
+	    if (!keep[r])
+	      continue;
+	    const size_type row = static_cast<size_type> (keptBounds.size ());
+	    reducedA.row (row) = a.row (static_cast<size_type> (r));
+	    reducedB[row] = b[static_cast<size_type> (r)];
+	    keptBounds.push_back (reducedBounds[r]);
+	    keptScales.push_back (rowScales[r]);
+	    keptOrigins.push_back (origins[r]);
+	    keptRows.push_back (rowsMap[r]);
+	  }
+
+	detail::restrictConstraintVisitor<problem_t> visitor
+	  (fixedPoint_, free_, &reducedA, &reducedB);
+	constraints.push_back (boost::apply_visitor (visitor, constraint));
+	intervals.push_back (keptBounds);
+	scales.push_back (keptScales);
+	map_.push_back (i);
+	rowOrigins_.push_back (keptOrigins);
+	rowsMap_.push_back (keptRows);
+      }
+
+    for (std::size_t i = 0; i < constraints.size (); ++i)
+      {
+	detail::addConstraintVisitor<problem_t> visitor
+	  (*problem_, intervals[i], scales[i]);
+	boost::apply_visitor (visitor, constraints[i]);
+      }
+  }
+
+  template <typename P>
+  bool
+  Presolve<P>::linearToBounds (const jacobian_t& a,
+			       const vector_t& b,
+			       const intervals_t& intervals,
+			       size_type offset) throw ()
+  {
+    // Each row has to depend on one variable at most.
+    const std::size_t rows = static_cast<std::size_t> (a.rows ());
+    std::vector<size_type> variable (rows, -1);
+    std::vector<value_type> coefficient (rows, 0.);
+    for (size_type r = 0; r < a.rows (); ++r)
+      for (size_type k = 0; k < a.cols (); ++k)
+	if (std::fabs (a (r, k)) > epsilon_)
+	  {
+	    if (variable[r] >= 0)
+	      return false;
+	    variable[r] = k;
+	    coefficient[r] = a (r, k);
+	  }
+    return rowsToBounds (variable, coefficient, b, intervals, offset);
+  }
+
+  template <typename P>
+  bool
+  Presolve<P>::linearToBounds (const sparseMatrix_t& a,
+			       const vector_t& b,
+			       const intervals_t& intervals,
+			       size_type offset) throw ()
+  {
+    // Each row has to depend on one variable at most.
+    const std::size_t rows = static_cast<std::size_t> (a.rows ());
+    std::vector<size_type> variable (rows, -1);
+    std::vector<value_type> coefficient (rows, 0.);
+    for (size_type r = 0; r < a.outerSize (); ++r)
+      for (typename sparseMatrix_t::InnerIterator it (a, r); it; ++it)
+	if (std::fabs (it.value ()) > epsilon_)
+	  {
+	    if (variable[r] >= 0)
+	      return false;
+	    variable[r] = it.col ();
+	    coefficient[r] = it.value ();
+	  }
+    return rowsToBounds (variable, coefficient, b, intervals, offset);
+  }
+
+  template <typename P>
+  bool
+  Presolve<P>::rowsToBounds (const std::vector<size_type>& variable,
+			     const std::vector<value_type>& coefficient,
+			     const vector_t& b,
+			     const intervals_t& intervals,
+			     size_type offset) throw ()
+  {
+    intervals_t& argumentBounds = problem_->argumentBounds ();
+    for (std::size_t r = 0; r < variable.size (); ++r)
+      {
+	const size_type row = static_cast<size_type> (r);
+	const value_type lower = intervals[r].first - b[row];
+	const value_type upper = intervals[r].second - b[row];
+
+	// Constant row: only check feasibility.
+	if (variable[r] < 0)
+	  {
+	    if (lower > epsilon_ || upper < -epsilon_)
+	      infeasible_ = true;
+	    continue;
+	  }
+
+	value_type l = lower / coefficient[r];
+	value_type u = upper / coefficient[r];
+	if (coefficient[r] < 0.)
+	  std::swap (l, u);
+
+	Function::interval_t& bound = argumentBounds[variable[r]];
+	origins_t& origins =
+	  boundOrigins_[static_cast<std::size_t> (variable[r])];
+	if (l > bound.first)
+	  {
+	    bound.first = l;
+	    origins.first = makeOrigin (offset + row, coefficient[r]);
+	  }
+	if (u < bound.second)
+	  {
+	    bound.second = u;
+	    origins.second = makeOrigin (offset + row, coefficient[r]);
+	  }
+	if (bound.first > bound.second + epsilon_)
+	  infeasible_ = true;
+	bound.second = std::max (bound.first, bound.second);
+      }
+    return true;
+  }
+
+  template <typename P>
+  void
+  Presolve<P>::restrictSparse (const SparseNumericLinearFunction& constraint,
+			       sparseMatrix_t& a,
+			       vector_t& b) const throw ()
+  {
+    // Column of each original variable in the reduced matrix (-1 for
+    // the fixed variables).
+    std::vector<size_type> column (static_cast<std::size_t> (inputSize_), -1);
+    for (std::size_t k = 0; k < free_.size (); ++k)
+      column[static_cast<std::size_t> (free_[k])] = static_cast<size_type> (k);
+
+    typedef Eigen::Triplet<value_type> triplet_t;
+    std::vector<triplet_t> triplets;
+    const sparseMatrix_t& original = constraint.A ();
+    triplets.reserve (static_cast<std::size_t> (original.nonZeros ()));
+    b = constraint.b ();
+    for (size_type r = 0; r < original.outerSize (); ++r)
+      for (typename sparseMatrix_t::InnerIterator it (original, r); it; ++it)
+	{
+	  const size_type k = column[static_cast<std::size_t> (it.col ())];
+	  if (k < 0)
+	    b[r] += it.value () * fixedPoint_[it.col ()];
+	  else
+	    triplets.push_back (triplet_t (r, k, it.value ()));
+	}
+
+    a.resize (original.rows (), static_cast<size_type> (free_.size ()));
+    a.setFromTriplets (triplets.begin (), triplets.end ());
+  }
+
+  template <typename P>
+  void
+  Presolve<P>::normalizeRows (const jacobian_t& a,
+			      const vector_t& b,
+			      std::vector<LinearRow>& rows) const throw ()
+  {
+    rows.resize (static_cast<std::size_t> (a.rows ()));
+    for (size_type r = 0; r < a.rows (); ++r)
+      {
+	LinearRow& row = rows[static_cast<std::size_t> (r)];
+	row.coefficients.clear ();
+	row.scale = 0.;
+	for (size_type k = 0; k < a.cols (); ++k)
+	  if (std::fabs (a (r, k)) > epsilon_)
+	    {
+	      if (row.coefficients.empty ())
+		row.scale = a (r, k);
+	      row.coefficients.push_back
+		(std::make_pair (k, a (r, k) / row.scale));
+	    }
+	row.constant = row.scale != 0. ? b[r] / row.scale : b[r];
+      }
+  }
+
+  template <typename P>
+  void
+  Presolve<P>::normalizeRows (const sparseMatrix_t& a,
+			      const vector_t& b,
+			      std::vector<LinearRow>& rows) const throw ()
+  {
+    rows.resize (static_cast<std::size_t> (a.rows ()));
+    for (size_type r = 0; r < a.outerSize (); ++r)
+      {
+	LinearRow& row = rows[static_cast<std::size_t> (r)];
+	row.coefficients.clear ();
+	row.scale = 0.;
+	for (typename sparseMatrix_t::InnerIterator it (a, r); it; ++it)
+	  if (std::fabs (it.value ()) > epsilon_)
+	    {
+	      if (row.coefficients.empty ())
+		row.scale = it.value ();
+	      row.coefficients.push_back
+		(std::make_pair (static_cast<size_type> (it.col ()),
+				 it.value () / row.scale));
+	    }
+	row.constant = row.scale != 0. ? b[r] / row.scale : b[r];
+      }
+  }
+
+  template <typename P>
+  std::size_t
+  Presolve<P>::hashRow (const LinearRow& row) const throw ()
+  {
+    // Without tolerance, rows are only duplicates if they are equal.
+    const value_type quantum = 64. * epsilon_;
+    boost::hash<value_type> hasher;
+
+    std::size_t seed = row.coefficients.size ();
+    for (std::size_t j = 0; j < row.coefficients.size (); ++j)
+      {
+	const value_type value = row.coefficients[j].second;
+	boost::hash_combine (seed, row.coefficients[j].first);
+	boost::hash_combine
+	  (seed, hasher (quantum > 0.
+			 ? std::floor (value / quantum + .5) : value));
+      }
+    boost::hash_combine
+      (seed, hasher (quantum > 0.
+		     ? std::floor (row.constant / quantum + .5)
+		     : row.constant));
+    return seed;
+  }
+
+  template <typename P>
+  std::size_t
+  Presolve<P>::mergeRows (std::vector<LinearRow>& rows,
+			  intervals_t& bounds,
+			  std::vector<origins_t>& origins,
+			  std::vector<intervals_t>& intervals,
+			  std::vector<LinearRow>& kept,
+			  buckets_t& buckets,
+			  size_type offset,
+			  std::vector<bool>& keep) throw ()
+  {
+    typedef typename buckets_t::const_iterator citer_t;
+
+    // Rows of the constraint being reduced are referenced by their
+    // position among its kept rows.
+    const std::size_t index = intervals.size ();
+    const std::size_t first = kept.size ();
+    std::vector<std::size_t> local;
+    std::size_t duplicates = 0;
+
+    keep.assign (rows.size (), true);
+    for (std::size_t r = 0; r < rows.size (); ++r)
+      {
+	LinearRow& row = rows[r];
+	row.constraint = index;
+	row.row = local.size ();
+
+	// Constant rows cannot be compared.
+	if (row.coefficients.empty ())
+	  {
+	    local.push_back (r);
+	    continue;
+	  }
+
+	// Only the rows of the same bucket may be duplicates.
+	const std::size_t hash = hashRow (row);
+	std::pair<citer_t, citer_t> range = buckets.equal_range (hash);
+	citer_t it = range.first;
+	for (; it != range.second; ++it)
+	  {
+	    const LinearRow& candidate = kept[it->second];
+	    if (candidate.coefficients.size () != row.coefficients.size ()
+		|| std::fabs (candidate.constant - row.constant) > epsilon_)
+	      continue;
+	    bool same = true;
+	    for (std::size_t j = 0; j < row.coefficients.size () && same; ++j)
+	      same = candidate.coefficients[j].first
+		== row.coefficients[j].first
+		&& std::fabs (candidate.coefficients[j].second
+			      - row.coefficients[j].second) <= epsilon_;
+	    if (same)
+	      break;
+	  }
+
+	if (it == range.second)
+	  {
+	    buckets.insert (std::make_pair (hash, kept.size ()));
+	    kept.push_back (row);
+	    local.push_back (r);
+	    continue;
+	  }
+
+	const std::size_t k = it->second;
+	const LinearRow& target = kept[k];
+	const size_type original = offset + static_cast<size_type> (r);
+	const value_type ratio = row.scale / target.scale;
+	if (k >= first)
+	  mergeRow (bounds[local[target.row]], origins[local[target.row]],
+		    bounds[r], original, ratio);
+	else
+	  mergeRow (intervals[target.constraint][target.row],
+		    rowOrigins_[target.constraint][target.row],
+		    bounds[r], original, ratio);
+	keep[r] = false;
+	++duplicates;
+      }
+    return duplicates;
+  }
+
+  template <typename P>
+  void
+  Presolve<P>::mergeRow (Function::interval_t& kept,
+			 origins_t& keptOrigins,
+			 const Function::interval_t& interval,
+			 size_type row,
+			 value_type ratio) throw ()
+  {
+    // The duplicate is ratio times the kept row: its interval is
+    // divided by the ratio.
+    value_type lower = interval.first / ratio;
+    value_type upper = interval.second / ratio;
+    if (ratio < 0.)
+      std::swap (lower, upper);
+
+    if (lower > kept.first)
+      {
+	kept.first = lower;
+	keptOrigins.first = makeOrigin (row, ratio);
+      }
+    if (upper < kept.second)
+      {
+	kept.second = upper;
+	keptOrigins.second = makeOrigin (row, ratio);
+      }
+    if (kept.first > kept.second + epsilon_)
+      infeasible_ = true;
+    kept.second = std::max (kept.first, kept.second);
+  }
+
+  template <typename P>
+  const typename Presolve<P>::problem_t&
+  Presolve<P>::problem () const throw ()
+  {
+    return *problem_;
+  }
+
+  template <typename P>
+  const std::vector<typename Presolve<P>::size_type>&
+  Presolve<P>::freeVariables () const throw ()
+  {
+    return free_;
+  }
+
+  template <typename P>
+  const typename Presolve<P>::vector_t&
+  Presolve<P>::fixedPoint () const throw ()
+  {
+    return fixedPoint_;
+  }
+
+  template <typename P>
+  const std::vector<std::size_t>&
+  Presolve<P>::constraintsMap () const throw ()
+  {
+    return map_;
+  }
+
+  template <typename P>
+  bool
+  Presolve<P>::infeasible () const throw ()
+  {
+    return infeasible_;
+  }
+
+  template <typename P>
+  typename Presolve<P>::vector_t
+  Presolve<P>::expand (const vector_t& x) const throw ()
+  {
+    assert (x.size () == static_cast<size_type> (free_.size ()));
+    vector_t full = fixedPoint_;
+    function_->expand (full, x);
+    return full;
+  }
+
+  template <typename P>
+  template <typename R>
+  R
+  Presolve<P>::postsolve (const R& result) const throw ()
+  {
+    R full (result);
+    full.inputSize = inputSize_;
+    full.x = expand (result.x);
+
+    full.constraints.resize (evaluator_.outputSize ());
+    evaluator_.computeConstraints (full.constraints, full.x);
+
+    // Map the multipliers of the kept constraints and, if present,
+    // of the argument bounds.
+    size_type reducedRows = 0;
+    for (std::size_t i = 0; i < problem_->boundsVector ().size (); ++i)
+      reducedRows += static_cast<size_type>
+	(problem_->boundsVector ()[i].size ());
+    const size_type freeSize = static_cast<size_type> (free_.size ());
+    const size_type rows = evaluator_.outputSize ();
+    const bool hasBounds = result.lambda.size () == reducedRows + freeSize;
+    if (result.lambda.size () != reducedRows && !hasBounds)
+      {
+	full.lambda.resize (0);
+	return full;
+      }
+
+    full.lambda.resize (hasBounds ? rows + inputSize_ : rows);
+    full.lambda.setZero ();
+    size_type offset = 0;
+    for (std::size_t i = 0; i < map_.size (); ++i)
+      {
+	const intervals_t& intervals = problem_->boundsVector ()[i];
+	for (std::size_t r = 0; r < intervals.size (); ++r, ++offset)
+	  moveMultiplier
+	    (full.lambda, result.lambda[offset],
+	     full.constraints[rowsMap_[i][r]],
+	     intervals[r], rowOrigins_[i][r], -1);
+      }
+    if (!hasBounds)
+      return full;
+
+    for (std::size_t k = 0; k < free_.size (); ++k)
+      moveMultiplier
+	(full.lambda, result.lambda[reducedRows + static_cast<size_type> (k)],
+	 full.x[free_[k]], problem_->argumentBounds ()[k],
+	 boundOrigins_[k], rows + free_[k]);
+
+    // The multiplier of a fixed variable bound is its reduced cost:
+    // grad f (x) - J (x)^T lambda.
+    if (free_.size () == static_cast<std::size_t> (inputSize_))
+      return full;
+    vector_t reducedCost (inputSize_);
+    if (!detail::costGradient (*function_->function (), reducedCost, full.x))
+      return full;
+    vector_t gradient (inputSize_);
+    const std::vector<size_type>& offsets = evaluator_.offsets ();
+    for (std::size_t i = 0; i < offsets.size (); ++i)
+      {
+	const size_type end =
+	  i + 1 < offsets.size () ? offsets[i + 1] : rows;
+	for (size_type row = offsets[i]; row < end; ++row)
+	  {
+	    if (full.lambda[row] == 0.)
+	      continue;
+	    evaluator_.computeGradient (gradient, full.x, i, row - offsets[i]);
+	    reducedCost -= full.lambda[row] * gradient;
+	  }
+      }
+    for (size_type j = 0, k = 0; j < inputSize_; ++j)
+      if (k < freeSize && free_[static_cast<std::size_t> (k)] == j)
+	++k;
+      else
+	full.lambda[rows + j] = reducedCost[j];
+    return full;
+  }
+
+  template <typename P>
+  typename Presolve<P>::Origin
+  Presolve<P>::makeOrigin (size_type row, value_type coefficient) throw ()
+  {
+    Origin origin;
+    origin.row = row;
+    origin.coefficient = coefficient;
+    return origin;
+  }
+
+  template <typename P>
+  void
+  Presolve<P>::moveMultiplier (vector_t& lambda,
+			       value_type multiplier,
+			       value_type value,
+			       const Function::interval_t& interval,
+			       const origins_t& origins,
+			       size_type argumentRow) const throw ()
+  {
+    if (multiplier == 0.)
+      return;
+
+    // The active bound is the closest one.
+    const Origin& origin =
+      std::fabs (value - interval.first) <= std::fabs (value - interval.second)
+      ? origins.first : origins.second;
+    if (origin.row < 0)
+      lambda[argumentRow] += multiplier;
+    else
+      lambda[origin.row] += multiplier / origin.coefficient;
+  }
+
+  template <typename P>
+  std::ostream&
+  Presolve<P>::print (std::ostream& o) const throw ()
+  {
+    o << "Presolve:" << incindent << iendl
+      << "Fixed variables: " << inputSize_ - free_.size () << iendl
+      << "Dropped constraints: " << dropped_ << iendl
+      << "Constraints turned into bounds: " << bounds_ << iendl
+      << "Duplicated rows: " << duplicates_ << iendl
+      << "Infeasible: " << (infeasible_ ? "yes" : "no");
+    return o << decindent;
+  }
+
+  template <typename P>
+  std::ostream&
+  operator<< (std::ostream& o, const Presolve<P>& presolve)
+  {
+    return presolve.print (o);
+  }
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_PRESOLVE_HXX
@@ -406,6 +406,10 @@ namespace roboptim
     /// \return constraints bounds vector
     const intervalsVect_t& boundsVector () const throw ();
 
+    /// \brief Retrieve constraints scales vector.
+    /// \return constraints scales vector
+    scalesVect_t& scalesVector () throw ();
+
     /// \brief Retrieve constraints scales vector.
     /// \return constraints scales vector
     const scalesVect_t& scalesVector () const throw ();
@@ -352,6 +352,13 @@ namespace roboptim
     return argumentBounds_;
   }
 
+  template <typename F, typename CLIST>
+  typename Problem<F, CLIST>::scalesVect_t&
+  Problem<F, CLIST>::scalesVector () throw ()
+  {
+    return scalesVect_;
+  }
+
   template <typename F, typename CLIST>
   const typename Problem<F, CLIST>::scalesVect_t&
   Problem<F, CLIST>::scalesVector () const throw ()
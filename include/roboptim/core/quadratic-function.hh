@@ -43,6 +43,9 @@ namespace roboptim
 		       size_type outputSize = 1,
 		       std::string name = std::string ()) throw ();
 
+    /// \brief Quadratic functions have a constant hessian.
+    virtual structure_t structure () const throw ();
+
     /// \brief Display the function on the specified output stream.
     ///
     /// \param o output stream used for display
@@ -0,0 +1,172 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_SCALING_HH
+# define ROBOPTIM_CORE_SCALING_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <iostream>
+# include <vector>
+
+# include <roboptim/core/fwd.hh>
+# include <roboptim/core/constraints-evaluator.hh>
+# include <roboptim/core/problem.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_problem
+  /// @{
+
+  /// \brief Compute the problem scales from the derivatives magnitudes.
+  ///
+  /// The magnitude of each derivative is estimated by evaluating the
+  /// cost gradient and the constraints jacobian at a few sample
+  /// points (by default, the starting point or a point inside the
+  /// argument bounds). The matrix of the largest absolute values is
+  /// then equilibrated using geometric mean scaling: rows and
+  /// columns are alternately divided by the geometric mean of their
+  /// smallest and largest non-zero entries.
+  ///
+  /// Scales follow the usual solvers convention: the scaled argument
+  /// is \f$\tilde{x}_j = s_j x_j\f$ and the scaled constraint is
+  /// \f$\tilde{g}_i = s_i g_i\f$.
+  ///
+  /// The cost gradient takes part in the equilibration, so the
+  /// arguments scales assume that the cost function is multiplied by
+  /// costScale (). Problems do not store a cost scale: apply does
+  /// not scale the cost, the caller has to do it (e.g. through the
+  /// solver parameters or by wrapping the cost function).
+  ///
+  /// \pre constraints have to be differentiable. The cost function
+  /// gradient is only used if the cost function is differentiable.
+  ///
+  /// \tparam P problem type
+  template <typename P>
+  class Scaling
+  {
+  public:
+    /// \brief Problem type.
+    typedef P problem_t;
+    /// \brief Import scales type.
+    typedef typename problem_t::scales_t scales_t;
+    /// \brief Import scales vector type.
+    typedef typename problem_t::scalesVect_t scalesVect_t;
+
+    /// \brief Import value type.
+    typedef DifferentiableFunction::value_type value_type;
+    /// \brief Import size type.
+    typedef DifferentiableFunction::size_type size_type;
+    /// \brief Import vector type.
+    typedef DifferentiableFunction::vector_t vector_t;
+    /// \brief Import argument type.
+    typedef DifferentiableFunction::argument_t argument_t;
+    /// \brief Import jacobian type.
+    typedef DifferentiableFunction::jacobian_t jacobian_t;
+
+    /// \brief Prepare the scaling of a problem.
+    ///
+    /// \param problem problem which will be scaled
+    explicit Scaling (const problem_t& problem) throw ();
+    ~Scaling () throw ();
+
+    /// \brief Add a sample point.
+    ///
+    /// If no sample is given, the starting point is used or, if
+    /// there is none, a point inside the argument bounds.
+    void addSample (const argument_t& x) throw ();
+
+    /// \brief Compute the scales.
+    ///
+    /// \param iterations maximum number of equilibration passes
+    /// \param minScale smallest allowed scale
+    /// \param maxScale largest allowed scale
+    void compute (unsigned iterations = 10,
+		  value_type minScale = 1e-8,
+		  value_type maxScale = 1e8) throw ();
+
+    /// \brief Arguments scales.
+    const scales_t& argumentScales () const throw ();
+
+    /// \brief Constraints scales.
+    const scalesVect_t& scalesVector () const throw ();
+
+    /// \brief Cost function scale.
+    ///
+    /// This scale is not applied by apply, see the class
+    /// documentation.
+    value_type costScale () const throw ();
+
+    /// \brief Ratio between the largest and the smallest constraints
+    /// derivative magnitudes, before and after scaling.
+    ///
+    /// The scaled magnitudes use the stored (i.e. clamped) scales.
+    /// The cost function is left out as its scale is not applied.
+    ///
+    /// The closer to one, the better the problem is scaled.
+    std::pair<value_type, value_type> ratio () const throw ();
+
+    /// \brief Store the computed scales in a problem.
+    ///
+    /// The cost function is not scaled, see costScale.
+    ///
+    /// \param problem problem whose arguments and constraints scales
+    /// will be replaced
+    void apply (problem_t& problem) const throw ();
+
+    /// \brief Display the scales on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    std::ostream& print (std::ostream& o) const throw ();
+
+  private:
+    /// \brief Default sample point.
+    argument_t defaultSample () const throw ();
+
+    /// \brief Largest derivatives magnitudes over the samples.
+    jacobian_t magnitudes () const throw ();
+
+    /// \brief Scaled problem.
+    const problem_t& problem_;
+    /// \brief Sample points.
+    std::vector<argument_t> samples_;
+
+    /// \brief Arguments scales.
+    scales_t argumentScales_;
+    /// \brief Constraints scales.
+    scalesVect_t scalesVect_;
+    /// \brief Cost scale.
+    value_type costScale_;
+    /// \brief Magnitude ratio before and after scaling.
+    std::pair<value_type, value_type> ratio_;
+  };
+
+  /// \brief Override operator<< to display the scales.
+  ///
+  /// \param o output stream used for display
+  /// \param scaling scaling to be displayed
+  /// \return output stream
+  template <typename P>
+  std::ostream& operator<< (std::ostream& o, const Scaling<P>& scaling);
+
+  /// @}
+
+} // end of namespace roboptim
+
+# include <roboptim/core/scaling.hxx>
+#endif //! ROBOPTIM_CORE_SCALING_HH
@@ -0,0 +1,276 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_SCALING_HXX
+# define ROBOPTIM_CORE_SCALING_HXX
+# include <algorithm>
+# include <cmath>
+# include <limits>
+
+# include <roboptim/core/indent.hh>
+# include <roboptim/core/util.hh>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    /// \internal
+    /// \brief Geometric mean of the extreme non-zero magnitudes of a
+    /// scaled vector (one if the vector is zero).
+    template <typename V>
+    Function::value_type
+    geometricMean (const V& v)
+    {
+      Function::value_type min = std::numeric_limits<double>::infinity ();
+      Function::value_type max = 0.;
+      for (typename V::Index i = 0; i < v.size (); ++i)
+	if (v[i] > 0.)
+	  {
+	    min = std::min (min, v[i]);
+	    max = std::max (max, v[i]);
+	  }
+      return max > 0. ? std::sqrt (min * max) : 1.;
+    }
+
+    /// \internal
+    /// \brief Ratio between the largest and smallest non-zero entries.
+    template <typename M>
+    Function::value_type
+    magnitudeRatio (const M& m)
+    {
+      Function::value_type min = std::numeric_limits<double>::infinity ();
+      Function::value_type max = 0.;
+      for (typename M::Index j = 0; j < m.cols (); ++j)
+	for (typename M::Index i = 0; i < m.rows (); ++i)
+	  if (m (i, j) > 0.)
+	    {
+	      min = std::min (min, m (i, j));
+	      max = std::max (max, m (i, j));
+	    }
+      return max > 0. ? max / min : 1.;
+    }
+  } // end of namespace detail.
+
+  template <typename P>
+  Scaling<P>::Scaling (const problem_t& problem) throw ()
+    : problem_ (problem),
+      samples_ (),
+      argumentScales_ (problem.argumentScales ()),
+      scalesVect_ (problem.scalesVector ()),
+      costScale_ (1.),
+      ratio_ (1., 1.)
+  {
+  }
+
+  template <typename P>
+  Scaling<P>::~Scaling () throw ()
+  {
+  }
+
+  template <typename P>
+  void
+  Scaling<P>::addSample (const argument_t& x) throw ()
+  {
+    assert (x.size () == problem_.function ().inputSize ());
+    samples_.push_back (x);
+  }
+
+  template <typename P>
+  typename Scaling<P>::argument_t
+  Scaling<P>::defaultSample () const throw ()
+  {
+    if (problem_.startingPoint ())
+      return *problem_.startingPoint ();
+
+    const typename problem_t::intervals_t& bounds =
+      problem_.argumentBounds ();
+    argument_t x (problem_.function ().inputSize ());
+    for (size_type j = 0; j < x.size (); ++j)
+      {
+	const bool lower = bounds[j].first != -Function::infinity ();
+	const bool upper = bounds[j].second != Function::infinity ();
+	if (lower && upper)
+	  x[j] = .5 * (bounds[j].first + bounds[j].second);
+	else if (lower)
+	  x[j] = bounds[j].first;
+	else if (upper)
+	  x[j] = bounds[j].second;
+	else
+	  x[j] = 0.;
+      }
+    return x;
+  }
+
+  template <typename P>
+  typename Scaling<P>::jacobian_t
+  Scaling<P>::magnitudes () const throw ()
+  {
+    ConstraintsEvaluator<problem_t> evaluator (problem_);
+    const size_type n = evaluator.inputSize ();
+
+    // First row: cost function, then the stacked constraints.
+    jacobian_t magnitudes (1 + evaluator.outputSize (), n);
+    magnitudes.setZero ();
+
+    std::vector<argument_t> samples = samples_;
+    if (samples.empty ())
+      samples.push_back (defaultSample ());
+
+    DifferentiableFunction::gradient_t gradient (n);
+    jacobian_t jacobian (evaluator.outputSize (), n);
+    for (std::size_t k = 0; k < samples.size (); ++k)
+      {
+	if (detail::costGradient (problem_.function (), gradient, samples[k]))
+	  magnitudes.row (0) =
+	    magnitudes.row (0).cwiseMax (gradient.cwiseAbs ().transpose ());
+
+	evaluator.computeJacobian (jacobian, samples[k]);
+	magnitudes.bottomRows (jacobian.rows ()) =
+	  magnitudes.bottomRows (jacobian.rows ()).cwiseMax
+	  (jacobian.cwiseAbs ());
+      }
+    return magnitudes;
+  }
+
+  template <typename P>
+  void
+  Scaling<P>::compute (unsigned iterations,
+		       value_type minScale,
+		       value_type maxScale) throw ()
+  {
+    const jacobian_t magnitudes = this->magnitudes ();
+    jacobian_t m = magnitudes;
+
+    vector_t rows (m.rows ());
+    rows.setOnes ();
+    vector_t cols (m.cols ());
+    cols.setOnes ();
+
+    // Geometric mean scaling: the matrix is equilibrated in place,
+    // the scales accumulate the applied factors.
+    for (unsigned k = 0; k < iterations; ++k)
+      {
+	value_type change = 0.;
+	for (size_type i = 0; i < m.rows (); ++i)
+	  {
+	    const value_type factor = detail::geometricMean (m.row (i));
+	    m.row (i) /= factor;
+	    rows[i] /= factor;
+	    change = std::max (change, std::fabs (std::log (factor)));
+	  }
+	for (size_type j = 0; j < m.cols (); ++j)
+	  {
+	    const value_type factor = detail::geometricMean (m.col (j));
+	    m.col (j) /= factor;
+	    cols[j] /= factor;
+	    change = std::max (change, std::fabs (std::log (factor)));
+	  }
+	if (change < 1e-3)
+	  break;
+      }
+
+    // Scaling the jacobian columns by c_j amounts to use x_j / c_j as
+    // the new variable.
+    costScale_ = std::min (std::max (rows[0], minScale), maxScale);
+    for (std::size_t j = 0; j < argumentScales_.size (); ++j)
+      argumentScales_[j] = std::min
+	(std::max (1. / cols[static_cast<size_type> (j)], minScale),
+	 maxScale);
+
+    size_type offset = 1;
+    for (std::size_t i = 0; i < scalesVect_.size (); ++i)
+      for (std::size_t r = 0; r < scalesVect_[i].size (); ++r)
+	scalesVect_[i][r] = std::min (std::max (rows[offset++], minScale),
+				      maxScale);
+
+    // The ratio only covers the constraints (the cost scale is not
+    // applied by apply) and uses the scales actually stored.
+    const size_type constraintsRows = magnitudes.rows () - 1;
+    jacobian_t scaled = magnitudes.bottomRows (constraintsRows);
+    ratio_.first = detail::magnitudeRatio (scaled);
+    offset = 0;
+    for (std::size_t i = 0; i < scalesVect_.size (); ++i)
+      for (std::size_t r = 0; r < scalesVect_[i].size (); ++r)
+	scaled.row (offset++) *= scalesVect_[i][r];
+    for (std::size_t j = 0; j < argumentScales_.size (); ++j)
+      scaled.col (static_cast<size_type> (j)) /= argumentScales_[j];
+    ratio_.second = detail::magnitudeRatio (scaled);
+  }
+
+  template <typename P>
+  const typename Scaling<P>::scales_t&
+  Scaling<P>::argumentScales () const throw ()
+  {
+    return argumentScales_;
+  }
+
+  template <typename P>
+  const typename Scaling<P>::scalesVect_t&
+  Scaling<P>::scalesVector () const throw ()
+  {
+    return scalesVect_;
+  }
+
+  template <typename P>
+  typename Scaling<P>::value_type
+  Scaling<P>::costScale () const throw ()
+  {
+    return costScale_;
+  }
+
+  template <typename P>
+  std::pair<typename Scaling<P>::value_type, typename Scaling<P>::value_type>
+  Scaling<P>::ratio () const throw ()
+  {
+    return ratio_;
+  }
+
+  template <typename P>
+  void
+  Scaling<P>::apply (problem_t& problem) const throw ()
+  {
+    assert (problem.argumentScales ().size () == argumentScales_.size ());
+    assert (problem.scalesVector ().size () == scalesVect_.size ());
+    problem.argumentScales () = argumentScales_;
+    problem.scalesVector () = scalesVect_;
+  }
+
+  template <typename P>
+  std::ostream&
+  Scaling<P>::print (std::ostream& o) const throw ()
+  {
+    o << "Scaling:" << incindent << iendl
+      << "Cost scale: " << costScale_ << iendl
+      << "Arguments scales: " << argumentScales_ << iendl
+      << "Constraints scales:" << incindent;
+    for (std::size_t i = 0; i < scalesVect_.size (); ++i)
+      o << iendl << scalesVect_[i];
+    o << decindent << iendl
+      << "Magnitude ratio: " << ratio_.first << " -> " << ratio_.second;
+    return o << decindent;
+  }
+
+  template <typename P>
+  std::ostream&
+  operator<< (std::ostream& o, const Scaling<P>& scaling)
+  {
+    return scaling.print (o);
+  }
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_SCALING_HXX
@@ -0,0 +1,210 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_SERIALIZATION_HH
+# define ROBOPTIM_CORE_SERIALIZATION_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <iostream>
+# include <stdexcept>
+# include <string>
+# include <vector>
+
+# include <boost/scoped_ptr.hpp>
+# include <boost/utility.hpp>
+
+# include <roboptim/core/function.hh>
+# include <roboptim/core/generic-solver.hh>
+# include <roboptim/core/portability.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_problem
+  /// @{
+
+  /// \brief Binary format version written by this library.
+  ///
+  /// The format stores, for each solver outcome, its kind (no
+  /// solution, result, result with warnings, solver error), the
+  /// sizes, the x, value, constraints and lambda vectors, the error
+  /// message and the warnings. Data are 8 bytes aligned and stored in
+  /// the host byte order: files written on a host with a different
+  /// byte order are rejected.
+  static const unsigned resultFormatVersion = 1;
+
+  /// \brief Write a solver outcome to a binary stream.
+  ///
+  /// \param o output stream (opened in binary mode)
+  /// \param result solver outcome
+  /// \throw std::runtime_error if the stream cannot be written
+  ROBOPTIM_DLLAPI void
+  writeResult (std::ostream& o, const GenericSolver::result_t& result)
+    throw (std::runtime_error);
+
+  /// \brief Read a solver outcome from a binary stream.
+  ///
+  /// \param i input stream (opened in binary mode)
+  /// \return solver outcome
+  /// \throw std::runtime_error if the data are invalid
+  ROBOPTIM_DLLAPI GenericSolver::result_t
+  readResult (std::istream& i) throw (std::runtime_error);
+
+  /// \brief Read-only view of a serialized solver outcome.
+  ///
+  /// Vectors are mapped on the serialized data, nothing is copied.
+  /// The view is valid as long as the underlying data are (see
+  /// ResultArchive).
+  class ROBOPTIM_DLLAPI ResultView
+  {
+  public:
+    /// \brief Import size type from Function class.
+    typedef Function::size_type size_type;
+    /// \brief Import value type from Function class.
+    typedef Function::value_type value_type;
+    /// \brief Import vector type from Function class.
+    typedef Function::vector_t vector_t;
+    /// \brief Read-only vector view.
+    typedef Eigen::Map<const vector_t> vectorView_t;
+
+    /// \brief Build a view on a serialized record.
+    ///
+    /// \param data record data (8 bytes aligned)
+    /// \param size record size in bytes
+    /// \throw std::runtime_error if the record is invalid
+    ResultView (const char* data, std::size_t size)
+      throw (std::runtime_error);
+
+    /// \brief Kind of outcome.
+    GenericSolver::solutions kind () const throw ();
+
+    /// \brief Does the record contain a result (or a solver error
+    /// last state)?
+    bool hasResult () const throw ();
+
+    /// \brief Result input size.
+    size_type inputSize () const throw ();
+    /// \brief Result output size.
+    size_type outputSize () const throw ();
+
+    /// \brief Point found by the solver.
+    vectorView_t x () const throw ();
+    /// \brief Function value at the solver found point.
+    vectorView_t value () const throw ();
+    /// \brief Constraints final values.
+    vectorView_t constraints () const throw ();
+    /// \brief Lagrange multipliers.
+    vectorView_t lambda () const throw ();
+
+    /// \brief Error message (solver errors only).
+    std::string message () const throw ();
+
+    /// \brief Number of warnings.
+    std::size_t warnings () const throw ();
+    /// \brief Warning message.
+    std::string warning (std::size_t i) const throw ();
+
+    /// \brief Build the solver outcome (copies the data).
+    GenericSolver::result_t result () const throw ();
+
+  private:
+    /// \brief Retrieve one of the vectors.
+    vectorView_t vector (std::size_t i) const throw ();
+
+    /// \brief Record data.
+    const char* data_;
+    /// \brief Vectors offsets (x, value, constraints, lambda, end).
+    std::size_t offsets_[5];
+    /// \brief Warnings offsets.
+    std::vector<std::size_t> warnings_;
+  };
+
+  /// \brief Write many solver outcomes to a binary archive.
+  ///
+  /// Records are appended one after the other, the index is written
+  /// when the archive is closed. The archive can then be read without
+  /// copy by ResultArchive.
+  class ROBOPTIM_DLLAPI ResultArchiveWriter : public boost::noncopyable
+  {
+  public:
+    /// \brief Create an archive.
+    ///
+    /// \param filename archive file name (overwritten)
+    /// \throw std::runtime_error if the file cannot be created
+    explicit ResultArchiveWriter (const std::string& filename)
+      throw (std::runtime_error);
+
+    /// \brief Close the archive if needed.
+    ~ResultArchiveWriter () throw ();
+
+    /// \brief Append a solver outcome.
+    ///
+    /// \throw std::runtime_error if the file cannot be written
+    void append (const GenericSolver::result_t& result)
+      throw (std::runtime_error);
+
+    /// \brief Number of records written so far.
+    std::size_t size () const throw ();
+
+    /// \brief Write the index and close the archive.
+    ///
+    /// \throw std::runtime_error if the file cannot be written
+    void close () throw (std::runtime_error);
+
+  private:
+    struct Impl;
+    /// \brief Implementation (output file, offsets...).
+    boost::scoped_ptr<Impl> impl_;
+  };
+
+  /// \brief Memory-mapped archive of solver outcomes.
+  ///
+  /// The archive file is mapped in memory: records are accessed
+  /// through ResultView objects pointing directly into the mapping.
+  class ROBOPTIM_DLLAPI ResultArchive : public boost::noncopyable
+  {
+  public:
+    /// \brief Map an archive.
+    ///
+    /// \param filename archive file name
+    /// \throw std::runtime_error if the file is not a valid archive
+    explicit ResultArchive (const std::string& filename)
+      throw (std::runtime_error);
+
+    ~ResultArchive () throw ();
+
+    /// \brief Number of records.
+    std::size_t size () const throw ();
+
+    /// \brief Access a record (no copy).
+    ///
+    /// \param i record index
+    /// \throw std::runtime_error if the record is invalid
+    ResultView operator[] (std::size_t i) const throw (std::runtime_error);
+
+  private:
+    struct Impl;
+    /// \brief Implementation (file mapping, index...).
+    boost::scoped_ptr<Impl> impl_;
+  };
+
+  /// @}
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_SERIALIZATION_HH
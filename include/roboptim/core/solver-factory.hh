@@ -23,12 +23,11 @@
 # include <stdexcept>
 # include <string>
 
-# include <ltdl.h>
-
 # include <boost/static_assert.hpp>
 # include <boost/type_traits/is_base_of.hpp>
 
 # include <roboptim/core/fwd.hh>
+# include <roboptim/core/plugin-registry.hh>
 # include <roboptim/core/solver.hh>
 # include <roboptim/core/solver-error.hh>
 
@@ -42,9 +41,13 @@ namespace roboptim
   /// The solver factory has to be used to instantiate solvers which
   /// are packaged as roboptim-core plug-ins.
   ///
-  /// This class uses libltdl to handle plug-ins. This lightweight library
-  /// is provided with GNU Libtool and wraps OS specific behavior into
-  /// a uniform interface.
+  /// This class relies on the PluginRegistry to handle plug-ins,
+  /// which uses libltdl to load them dynamically. libltdl headers are
+  /// not required to use the factory.
+  ///
+  /// Plug-ins are loaded through the PluginRegistry: a plug-in
+  /// module is loaded only once per process, whatever the number of
+  /// factories using it.
   ///
   /// \warning The solver lifetime is bound to the factory lifetime,
   /// when the factory goes out of scope, the solver is destroyed too.
@@ -71,7 +74,7 @@ namespace roboptim
     explicit SolverFactory (std::string solver, const problem_t& problem)
       throw (std::runtime_error);
 
-    /// Unload the plug-in and free the instantiated solver.
+    /// Release the plug-in and free the instantiated solver.
     ~SolverFactory () throw ();
 
     /// \brief Retrieve a reference on the solver.
@@ -79,8 +82,10 @@ namespace roboptim
     solver_t& operator () () throw ();
 
   private:
-    /// \brief ltdl plug-in handle.
-    lt_dlhandle handle_;
+    /// \brief Plug-in name.
+    std::string plugin_;
+    /// \brief Plug-in entry points.
+    PluginRegistry::Symbols symbols_;
     /// \brief Allocated solver.
     solver_t* solver_;
   };
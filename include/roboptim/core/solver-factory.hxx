@@ -25,7 +25,7 @@ namespace roboptim
   // standard. There is *no* way to cast a pointer to object into a
   // pointer to function.
   //
-  // Unfortunately lt_dlsym is giving us a void* so we have to use
+  // Unfortunately the plug-in symbols are void* pointers so we have to use
   // this kind of trick to transform it into a pointer to function.
   template <typename T>
   T* unionCast(void* ptr)
@@ -42,41 +42,13 @@ namespace roboptim
   template <typename T>
   SolverFactory<T>::SolverFactory (std::string plugin, const problem_t& pb)
   throw (std::runtime_error)
-    : handle_ (),
+    : plugin_ (plugin),
+      symbols_ (PluginRegistry::instance ().acquire (plugin)),
       solver_ ()
   {
-    typedef unsigned getsizeofproblem_t ();
     typedef solver_t* create_t (const problem_t&);
 
-    if (lt_dlinit () > 0)
-      throw std::runtime_error ("failed to initialize libltdl.");
-
-    std::stringstream ss;
-    ss << "roboptim-core-plugin-" << plugin;
-    handle_ = lt_dlopenext (ss.str ().c_str ());
-    if (!handle_)
-      {
-	std::stringstream sserror;
-	sserror << "libltdl failed to load plug-in ``"
-		<< ss.str () << "'': " << lt_dlerror ();
-	lt_dlexit ();
-	throw std::runtime_error (sserror.str ().c_str ());
-      }
-
-    getsizeofproblem_t* getSizeOfProblem =
-      unionCast<getsizeofproblem_t> (lt_dlsym (handle_, "getSizeOfProblem"));
-    if (!getSizeOfProblem)
-      {
-	std::stringstream sserror;
-	sserror << "libltdl failed to find symbol ``getSizeOfProblem'': "
-		<< lt_dlerror ();
-
-	lt_dlclose (handle_);
-	lt_dlexit ();
-	throw std::runtime_error (sserror.str ().c_str ());
-      }
-
-    unsigned sizeOfProblem = getSizeOfProblem ();
+    unsigned sizeOfProblem = symbols_.sizeOfProblem;
     if (sizeOfProblem != sizeof (typename solver_t::problem_t))
       {
 	std::stringstream sserror;
@@ -86,36 +58,26 @@ namespace roboptim
 	  << " byte(s) but " << sizeof (typename solver_t::problem_t)
 	  << " byte(s) was expected by application)";
 
-	lt_dlclose (handle_);
-	lt_dlexit ();
+	PluginRegistry::instance ().release (plugin_);
 	throw std::runtime_error (sserror.str ().c_str ());
       }
 
-
-    create_t* c =
-      unionCast<create_t> (lt_dlsym (handle_, "create"));
-    if (!c)
+    create_t* c = unionCast<create_t> (symbols_.create);
+    try
       {
-	std::stringstream sserror;
-	sserror << "libltdl failed to find symbol ``create'': "
-		<< lt_dlerror ();
-
-	lt_dlclose (handle_);
-	lt_dlexit ();
-	throw std::runtime_error (sserror.str ().c_str ());
+	solver_ = c (pb);
+      }
+    catch (...)
+      {
+	// The destructor will not be called: release the plug-in here.
+	PluginRegistry::instance ().release (plugin_);
+	throw;
       }
-
-    solver_ = c (pb);
 
     if (!solver_)
       {
-	std::stringstream sserror;
-	sserror << "libltdl failed to call ``create'': "
-		<< lt_dlerror ();
-
-	lt_dlclose (handle_);
-	lt_dlexit ();
-	throw std::runtime_error (sserror.str ().c_str ());
+	PluginRegistry::instance ().release (plugin_);
+	throw std::runtime_error ("failed to call ``create''");
       }
   }
 
@@ -124,35 +86,11 @@ namespace roboptim
   {
     typedef void destroy_t (solver_t*);
 
-    destroy_t* destructor =
-      unionCast<destroy_t> (lt_dlsym (handle_, "destroy"));
-    if (destructor)
-      {
-        destructor (solver_);
-        solver_ = 0;
-      }
-    else
-      {
-	std::stringstream sserror;
-	sserror << "libltdl failed to call ``destroy'': "
-		<< lt_dlerror ();
-      }
-
-    if (lt_dlclose (handle_))
-      {
-	std::stringstream sserror;
-	sserror << "libltdl failed to close plug-in: "
-		<< lt_dlerror ();
-	std::cerr << sserror << std::endl;
-      }
+    destroy_t* destructor = unionCast<destroy_t> (symbols_.destroy);
+    destructor (solver_);
+    solver_ = 0;
 
-    if (lt_dlexit ())
-      {
-	std::stringstream sserror;
-	sserror << "libltdl failed to call ``create'': "
-		<< lt_dlerror ();
-	std::cerr << sserror << std::endl;
-      }
+    PluginRegistry::instance ().release (plugin_);
   }
 
   template <typename T>
@@ -0,0 +1,111 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_SOLVER_STATE_HH
+# define ROBOPTIM_CORE_SOLVER_STATE_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <iostream>
+
+# include <roboptim/core/function.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_solver
+  /// @{
+
+  /// \brief Read-only view of a solver state during the optimization.
+  ///
+  /// Plug-ins build this object at each iteration and pass it to the
+  /// iteration callback (see GenericSolver::setIterationCallback).
+  /// Vectors are mapped on the solver own buffers: nothing is copied,
+  /// hence the state is only valid during the callback.
+  class ROBOPTIM_DLLAPI SolverState
+  {
+  public:
+    /// \brief Import size type from Function class.
+    typedef Function::size_type size_type;
+    /// \brief Import value type from Function class.
+    typedef Function::value_type value_type;
+    /// \brief Import vector type from Function class.
+    typedef Function::vector_t vector_t;
+    /// \brief Read-only vector view.
+    typedef Eigen::Map<const vector_t> vectorView_t;
+
+    /// \brief Build a state from raw solver buffers.
+    ///
+    /// \param iteration current iteration
+    /// \param x current iterate (inputSize elements)
+    /// \param inputSize problem input size
+    /// \param cost cost function value at x
+    /// \param constraintViolation constraints violation at x
+    /// \param lambda multipliers, may be null
+    /// \param lambdaSize number of multipliers
+    SolverState (size_type iteration,
+		 const value_type* x,
+		 size_type inputSize,
+		 value_type cost,
+		 value_type constraintViolation,
+		 const value_type* lambda = 0,
+		 size_type lambdaSize = 0) throw ();
+
+    /// \brief Build a state from Eigen vectors.
+    ///
+    /// \param iteration current iteration
+    /// \param x current iterate
+    /// \param cost cost function value at x
+    /// \param constraintViolation constraints violation at x
+    /// \param lambda multipliers
+    SolverState (size_type iteration,
+		 const vector_t& x,
+		 value_type cost,
+		 value_type constraintViolation,
+		 const vector_t& lambda) throw ();
+
+    /// \brief Display the state on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    std::ostream& print (std::ostream& o) const throw ();
+
+    /// \brief Current iteration.
+    size_type iteration;
+    /// \brief Current iterate.
+    vectorView_t x;
+    /// \brief Cost function value.
+    value_type cost;
+    /// \brief Constraints violation (e.g. infinity norm of the
+    /// distance to the constraints intervals).
+    value_type constraintViolation;
+    /// \brief Lagrange multipliers (may be empty).
+    vectorView_t lambda;
+  };
+
+  /// @}
+
+  /// \brief Override operator<< to handle solver state display.
+  ///
+  /// \param o output stream used for display
+  /// \param state state to be displayed
+  /// \return output stream
+  ROBOPTIM_DLLAPI std::ostream& operator<< (std::ostream& o,
+					    const SolverState& state);
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_SOLVER_STATE_HH
@@ -21,6 +21,7 @@
 # include <roboptim/core/debug.hh>
 
 # include <map>
+# include <stdexcept>
 # include <string>
 
 # include <boost/static_assert.hpp>
@@ -30,6 +31,7 @@
 
 # include <roboptim/core/fwd.hh>
 # include <roboptim/core/function.hh>
+# include <roboptim/core/parameter-schema.hh>
 # include <roboptim/core/problem.hh>
 # include <roboptim/core/generic-solver.hh>
 
@@ -38,19 +40,6 @@ namespace roboptim
   /// \addtogroup roboptim_problem
   /// @{
 
-  /// \brief Parameters type.
-  struct Parameter
-  {
-    /// \brief Allowed types for parameters.
-    typedef boost::variant<Function::value_type, int, std::string> parameterValues_t;
-
-    /// \brief Parameter description (for humans).
-    std::string description;
-
-    /// \brief Value.
-    parameterValues_t value;
-  };
-
   /// \brief Solver for a specific problem class.
   ///
   /// This class is parametrized by two types:
@@ -113,8 +102,37 @@ namespace roboptim
     const parameters_t& parameters () const throw ();
     parameters_t& parameters () throw ();
 
+
+    /// \brief Retrieve a parameter value.
+    ///
+    /// \tparam T parameter type
+    /// \param key parameter name
+    /// \throw std::runtime_error if the parameter does not exist
+    /// \throw boost::bad_get if the parameter type does not match
     template <typename T>
-    const T& getParameter (const std::string& key) const;
+    const T& getParameter (const std::string& key) const
+      throw (std::runtime_error, boost::bad_get);
+
+    /// \brief Parameters declared by the solver.
+    ///
+    /// Solvers which do not declare their parameters have an empty
+    /// schema.
+    const ParameterSchema& parameterSchema () const throw ();
+
+    /// \brief Check the parameters against the solver schema.
+    ///
+    /// \throw std::runtime_error if the parameters are invalid
+    void validateParameters () const throw (std::runtime_error);
+
+    /// \brief Load parameters from a file.
+    ///
+    /// See ParameterSchema::load for the file format.
+    ///
+    /// \param filename file name
+    /// \throw std::runtime_error if the file cannot be read or is
+    /// invalid
+    void loadParameters (const std::string& filename)
+      throw (std::runtime_error);
     /// \}
 
     /// \brief Display the solver on the specified output stream.
@@ -129,6 +147,41 @@ namespace roboptim
     /// \brief Solver parameters (run-time configuration).
     parameters_t parameters_;
 
+    /// \brief Declare a parameter.
+    ///
+    /// Plug-ins declare their parameters once, in their constructor:
+    /// the parameter is added to the schema and its default value to
+    /// the parameters map.
+    ///
+    /// \return typed handle on the parameter
+    template <typename T>
+    ParameterKey<T> declareParameter (const std::string& key,
+				      const std::string& description,
+				      const T& value);
+
+    /// \brief Resolve the parameters map for typed access.
+    ///
+    /// Plug-ins call it when the solve starts, then access the values
+    /// through parameter ().
+    ///
+    /// \throw std::runtime_error if the parameters are invalid
+    void bindParameters () throw (std::runtime_error);
+
+    /// \brief Typed access to a bound parameter (constant time).
+    ///
+    /// \pre bindParameters () has been called
+    template <typename T>
+    const T& parameter (const ParameterKey<T>& key) const throw ()
+    {
+      return parameterValues_[key];
+    }
+
+    /// \brief Parameters declared by the solver.
+    ParameterSchema schema_;
+
+    /// \brief Bound parameters values.
+    ParameterValues parameterValues_;
+
     /// \brief Pointer to function logger (see log4cxx documentation).
     static log4cxx::LoggerPtr logger;
   };
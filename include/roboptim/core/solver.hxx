@@ -25,7 +25,10 @@ namespace roboptim
   template <typename F, typename C>
   Solver<F, C>::Solver (const problem_t& pb) throw ()
     : GenericSolver (),
-      problem_ (pb)
+      problem_ (pb),
+      parameters_ (),
+      schema_ (),
+      parameterValues_ ()
   {
   }
 
@@ -33,7 +36,10 @@ namespace roboptim
   template <typename F_, typename C_>
   Solver<F, C>::Solver (const Problem<F_, C_>& pb) throw ()
     : GenericSolver (),
-      problem_ (pb)
+      problem_ (pb),
+      parameters_ (),
+      schema_ (),
+      parameterValues_ ()
   {
   }
 
@@ -67,11 +73,57 @@ namespace roboptim
   template <typename T>
   const T&
   Solver<F, C>::getParameter (const std::string& key) const
+    throw (std::runtime_error, boost::bad_get)
   {
     parameters_t::const_iterator it = parameters_.find (key);
+    if (it == parameters_.end ())
+      throw std::runtime_error ("unknown parameter ``" + key + "''");
     return boost::get<T> (it->second.value);
   }
 
+  template <typename F, typename C>
+  const ParameterSchema&
+  Solver<F, C>::parameterSchema () const throw ()
+  {
+    return schema_;
+  }
+
+  template <typename F, typename C>
+  void
+  Solver<F, C>::validateParameters () const throw (std::runtime_error)
+  {
+    schema_.validate (parameters_);
+  }
+
+  template <typename F, typename C>
+  void
+  Solver<F, C>::loadParameters (const std::string& filename)
+    throw (std::runtime_error)
+  {
+    schema_.load (parameters_, filename);
+  }
+
+  template <typename F, typename C>
+  template <typename T>
+  ParameterKey<T>
+  Solver<F, C>::declareParameter (const std::string& key,
+				  const std::string& description,
+				  const T& value)
+  {
+    ParameterKey<T> result = schema_.declare (key, description, value);
+    Parameter& parameter = parameters_[key];
+    parameter.description = description;
+    parameter.value = value;
+    return result;
+  }
+
+  template <typename F, typename C>
+  void
+  Solver<F, C>::bindParameters () throw (std::runtime_error)
+  {
+    schema_.bind (parameterValues_, parameters_);
+  }
+
 
   template <typename F, typename C>
   std::ostream&
@@ -0,0 +1,91 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_SPARSE_NUMERIC_LINEAR_FUNCTION_HH
+# define ROBOPTIM_CORE_SPARSE_NUMERIC_LINEAR_FUNCTION_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <roboptim/core/linear-function.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_function
+  /// @{
+
+  /// \brief Build a linear function from a vector and a sparse matrix.
+  ///
+  /// Implement a linear function using the general formula:
+  /// \f[f(x) = A x + b\f]
+  /// where \f$A\f$ is a sparse matrix stored row by row (CSR). The
+  /// value is computed by a sparse matrix-vector product and each
+  /// gradient by scattering the non-zeros of one row: both costs are
+  /// proportional to the number of non-zeros, the matrix is never
+  /// expanded.
+  ///
+  /// The jacobian is constant: use A () to access it without any
+  /// copy. The constraints evaluator (see ConstraintsEvaluator)
+  /// detects this class and uses A () directly.
+  ///
+  /// \warning impl_jacobian fills a dense matrix, avoid calling
+  /// jacobian () on large instances.
+  class ROBOPTIM_DLLAPI SparseNumericLinearFunction : public LinearFunction
+  {
+  public:
+    /// \brief Sparse matrix type (row-major).
+    typedef Eigen::SparseMatrix<value_type, Eigen::RowMajor> sparseMatrix_t;
+
+    /// \brief Build a linear function from a sparse matrix and a vector.
+    ///
+    /// See class documentation for A and b definition.
+    /// \param A A sparse matrix
+    /// \param b b vector
+    SparseNumericLinearFunction (const sparseMatrix_t& A, const vector_t& b)
+      throw ();
+
+    ~SparseNumericLinearFunction () throw ();
+
+    /// \brief A matrix, i.e. the constant jacobian (no copy).
+    const sparseMatrix_t& A () const throw ();
+
+    /// \brief b vector.
+    const vector_t& b () const throw ();
+
+    /// \brief Display the function on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    virtual std::ostream& print (std::ostream&) const throw ();
+
+  protected:
+    void impl_compute (result_t& , const argument_t&) const throw ();
+    void impl_gradient (gradient_t&, const argument_t&, size_type = 0)
+      const throw ();
+    void impl_jacobian (jacobian_t&, const argument_t&) const throw ();
+
+  private:
+    /// \brief A matrix.
+    sparseMatrix_t a_;
+    /// \brief B vector.
+    vector_t b_;
+  };
+
+  /// @}
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_SPARSE_NUMERIC_LINEAR_FUNCTION_HH
@@ -0,0 +1,92 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_SPARSE_QUADRATIC_FUNCTION_HH
+# define ROBOPTIM_CORE_SPARSE_QUADRATIC_FUNCTION_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <roboptim/core/quadratic-function.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_function
+  /// @{
+
+  /// \brief Quadratic function with a sparse symmetric matrix.
+  ///
+  /// Implement a quadratic function using the formula:
+  /// \f[f(x) = \frac{1}{2} x^t A x + b^t x\f]
+  /// where \f$A\f$ is a sparse symmetric matrix. Only its lower
+  /// triangular part is read: the value and gradient kernels are
+  /// symmetric sparse matrix-vector products whose cost is
+  /// proportional to the number of non-zeros.
+  ///
+  /// \warning The hessian is a dense matrix (see
+  /// TwiceDifferentiableFunction), use A () to access the sparse
+  /// matrix.
+  class ROBOPTIM_DLLAPI SparseQuadraticFunction : public QuadraticFunction
+  {
+  public:
+    /// \brief Sparse matrix type.
+    typedef GenericFunctionTraits<EigenMatrixSparse>::matrix_t
+    sparseMatrix_t;
+
+    /// \brief Build a quadratic function from a sparse matrix and a vector.
+    ///
+    /// See class documentation for A and b definition.
+    /// \param A A sparse symmetric matrix
+    /// \param b b vector
+    SparseQuadraticFunction (const sparseMatrix_t& A, const vector_t& b)
+      throw ();
+
+    ~SparseQuadraticFunction () throw ();
+
+    /// \brief A matrix (constant, no copy).
+    const sparseMatrix_t& A () const throw ();
+
+    /// \brief b vector.
+    const vector_t& b () const throw ();
+
+    /// \brief Display the function on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    virtual std::ostream& print (std::ostream&) const throw ();
+
+  protected:
+    void impl_compute (result_t& , const argument_t&) const throw ();
+    void impl_gradient (gradient_t&, const argument_t&, size_type = 0)
+      const throw ();
+    void impl_hessian (hessian_t& hessian,
+		       const argument_t& argument,
+		       size_type functionId = 0) const throw ();
+  private:
+    /// \brief A matrix.
+    sparseMatrix_t a_;
+    /// \brief B vector.
+    vector_t b_;
+    /// \brief buffer to avoid allocating during computation.
+    mutable vector_t buffer_;
+  };
+
+  /// @}
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_SPARSE_QUADRATIC_FUNCTION_HH
@@ -24,6 +24,7 @@
 
 # include <roboptim/core/differentiable-function.hh>
 # include <roboptim/core/function.hh>
+# include <roboptim/core/twice-differentiable-function.hh>
 
 namespace roboptim {
   /// \addtogroup roboptim_meta_function
@@ -37,15 +38,31 @@ namespace roboptim {
   ///
   /// The differentiable functions are stored in a vector valued function
   /// called base function.
-  class SumOfC1Squares : public DifferentiableFunction
+  ///
+  /// The gradient is computed as \f$2 J^T r\f$ where \f$r\f$ and
+  /// \f$J\f$ are the base function value and jacobian: one jacobian
+  /// evaluation per point instead of one gradient evaluation per
+  /// residual. Both are cached, evaluating the function and its
+  /// gradient at the same point evaluates the base function once.
+  ///
+  /// The hessian is the Gauss-Newton approximation \f$2 J^T J\f$:
+  /// the second order terms \f$2 \sum_i r_i \nabla^2 r_i\f$ of the
+  /// exact hessian are dropped, so the base function only has to be
+  /// differentiable. This approximation is exact at a zero residual
+  /// solution and is always positive semi-definite. It is computed as
+  /// a symmetric rank-k update from the cached jacobian and cached
+  /// as well. Its buffer is only allocated if the hessian is
+  /// requested.
+  class SumOfC1Squares : public TwiceDifferentiableFunction
   {
   public:
     /// @name Types
     /// @{
-    typedef DifferentiableFunction parent_t;
+    typedef TwiceDifferentiableFunction parent_t;
     typedef parent_t::argument_t argument_t;
     typedef parent_t::jacobian_t jacobian_t;
     typedef parent_t::gradient_t gradient_t;
+    typedef parent_t::hessian_t hessian_t;
     typedef parent_t::jacobianSize_t jacobianSize_t;
     typedef Function::size_type size_t;
     typedef Function::value_type value_t;
@@ -71,17 +88,32 @@ namespace roboptim {
     virtual void
     impl_gradient(gradient_t& gradient, const argument_t& x,
 		  size_type row = 0) const throw ();
+    /// \brief Gauss-Newton hessian \f$2 J^T J\f$
+    virtual void
+    impl_hessian(hessian_t& hessian, const argument_t& x,
+		 size_type row = 0) const throw ();
   private:
     /// Compute base function and store result in value_.
-    void computeFunction (const argument_t x) const;
+    void computeFunction (const argument_t& x) const;
+    /// Compute base function jacobian and store result in jacobian_.
+    void computeJacobian (const argument_t& x) const;
     /// \brief Vector valued function given at construction
     boost::shared_ptr<const DifferentiableFunction> baseFunction_;
     /// \brief Store last argument for which the function has been computed
     mutable argument_t x_;
     /// \brief temporary variable to store vector value of input function
     mutable result_t value_;
-    /// \brief temporary variable to store gradients
-    mutable gradient_t gradient_;
+    /// \brief Store last argument for which the jacobian has been computed
+    mutable argument_t jacobianX_;
+    /// \brief Is the stored jacobian valid?
+    mutable bool jacobianValid_;
+    /// \brief temporary variable to store jacobian of input function
+    mutable jacobian_t jacobian_;
+    /// \brief Is the stored hessian valid (for jacobianX_)?
+    mutable bool hessianValid_;
+    /// \brief Gauss-Newton hessian computed from jacobian_ (empty
+    /// until the first hessian request)
+    mutable hessian_t hessian_;
   }; // class Solver
   /// @}
 } // namespace roboptim
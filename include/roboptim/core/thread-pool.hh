@@ -0,0 +1,232 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_THREAD_POOL_HH
+# define ROBOPTIM_CORE_THREAD_POOL_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <cstddef>
+# include <vector>
+
+# include <boost/function.hpp>
+# include <boost/shared_ptr.hpp>
+# include <boost/thread/condition_variable.hpp>
+# include <boost/thread/mutex.hpp>
+# include <boost/thread/thread.hpp>
+# include <boost/thread/tss.hpp>
+# include <boost/utility.hpp>
+
+# include <roboptim/core/portability.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_problem
+  /// @{
+
+  /// \brief Fixed-size work-stealing thread pool.
+  ///
+  /// Each worker owns a task deque, protected by its own mutex. A
+  /// worker executes the last task of its own deque first and, once
+  /// it is empty, steals the first task of another deque.
+  ///
+  /// A single task submitted by a worker is pushed on its own deque,
+  /// a task submitted by another thread is given to the deques in a
+  /// round-robin fashion. A batch of tasks is dealt over all the
+  /// deques, in order: if the batch is sorted by decreasing cost,
+  /// each worker starts with its most expensive task and the idle
+  /// workers steal the cheapest remaining ones.
+  ///
+  /// The workers only report the executed tasks when they run out of
+  /// work: running a task locks its deque, the pool mutex is only
+  /// locked by submissions and idle workers.
+  ///
+  /// Tasks must not throw.
+  ///
+  /// wait blocks until all the pool tasks are done. Clients sharing a
+  /// pool should submit their tasks through a TaskGroup and only wait
+  /// for them.
+  class ROBOPTIM_DLLAPI ThreadPool : public boost::noncopyable
+  {
+  public:
+    /// \brief Task type.
+    typedef boost::function<void ()> task_t;
+
+    /// \brief Start the workers.
+    ///
+    /// \param size number of workers, if zero the number of hardware
+    /// threads is used
+    explicit ThreadPool (std::size_t size = 0) throw ();
+
+    /// \brief Wait for the pending tasks and stop the workers.
+    ~ThreadPool () throw ();
+
+    /// \brief Number of workers.
+    std::size_t size () const throw ();
+
+    /// \brief Submit a task.
+    ///
+    /// \param task task that will be executed
+    void submit (const task_t& task) throw ();
+
+    /// \brief Submit a batch of tasks, dealt over the workers.
+    ///
+    /// \param tasks tasks that will be executed, the first ones are
+    /// executed first
+    void submit (const std::vector<task_t>& tasks) throw ();
+
+    /// \brief Block until all the submitted tasks have been executed.
+    void wait () throw ();
+
+  private:
+    friend class TaskGroup;
+
+    /// \brief Worker task deque.
+    struct Worker;
+
+    /// \brief Submit a task of a group.
+    ///
+    /// \param task task that will be executed
+    /// \param group group tag, null outside of a group
+    void push (const task_t& task, const void* group) throw ();
+
+    /// \brief Submit a batch of tasks of a group.
+    ///
+    /// \param tasks tasks that will be executed
+    /// \param group group tag, null outside of a group
+    void push (const std::vector<task_t>& tasks, const void* group) throw ();
+
+    /// \brief Remove a queued task of a group and execute it.
+    ///
+    /// \param group group tag
+    /// \return false if no task of the group was queued
+    bool runGroupTask (const void* group) throw ();
+
+    /// \brief Thread exit handler of current_: the deques are owned
+    /// by the pool.
+    static void keepWorker (Worker*) throw ();
+
+    /// \brief Worker main loop.
+    ///
+    /// \param index worker index
+    void run (std::size_t index) throw ();
+
+    /// \brief Retrieve a task from a worker deque or steal one.
+    ///
+    /// \param index worker index
+    /// \param task retrieved task
+    /// \return false if all the deques are empty
+    bool pop (std::size_t index, task_t& task) throw ();
+
+    /// \brief Number of workers.
+    std::size_t size_;
+    /// \brief Workers deques.
+    std::vector<boost::shared_ptr<Worker> > workers_;
+    /// \brief Deque of the current thread, null outside of the
+    /// workers.
+    boost::thread_specific_ptr<Worker> current_;
+    /// \brief Workers threads.
+    boost::thread_group threads_;
+
+    /// \brief Protect the counters below.
+    ///
+    /// Locked when tasks are submitted and when a worker runs out of
+    /// tasks, the deques have their own mutexes.
+    boost::mutex mutex_;
+    /// \brief Signaled when tasks are submitted.
+    boost::condition_variable taskAvailable_;
+    /// \brief Signaled when all the tasks have been executed.
+    boost::condition_variable tasksDone_;
+    /// \brief Number of submitted tasks, used by the idle workers to
+    /// detect new tasks.
+    std::size_t submitted_;
+    /// \brief Number of submitted tasks which have not been reported
+    /// as done yet.
+    std::size_t pending_;
+    /// \brief Deque receiving the next task submitted from outside.
+    std::size_t next_;
+    /// \brief Are the workers stopping?
+    bool stop_;
+  };
+
+  /// \brief Tasks submitted to a thread pool and waited for together.
+  ///
+  /// Only the tasks of the group are waited for, so that a pool can
+  /// be shared by several clients. The tasks are queued in the
+  /// workers deques, tagged with their group.
+  ///
+  /// While waiting, the calling thread removes the queued tasks of
+  /// its own group from the deques and executes them, and never the
+  /// tasks of other clients. A pool task
+  /// waiting for a nested group (a parallel constraints evaluation
+  /// inside a parallel batch solve for instance) therefore does not
+  /// deadlock the pool, and a waiting thread cannot be blocked by an
+  /// unrelated task.
+  ///
+  /// A group must not be used concurrently.
+  class ROBOPTIM_DLLAPI TaskGroup : public boost::noncopyable
+  {
+  public:
+    /// \brief Create an empty group.
+    ///
+    /// \param pool pool executing the tasks
+    explicit TaskGroup (ThreadPool& pool) throw ();
+
+    /// \brief Wait for the group tasks.
+    ~TaskGroup () throw ();
+
+    /// \brief Submit a task to the pool.
+    ///
+    /// \param task task that will be executed
+    void submit (const ThreadPool::task_t& task) throw ();
+
+    /// \brief Submit a batch of tasks to the pool.
+    ///
+    /// \param tasks tasks that will be executed, see
+    /// ThreadPool::submit
+    void submit (const std::vector<ThreadPool::task_t>& tasks) throw ();
+
+    /// \brief Block until all the group tasks have been executed.
+    void wait () throw ();
+
+  private:
+    /// \brief Group counter.
+    ///
+    /// Shared with the queued tasks, which may outlive the group.
+    struct State;
+
+    /// \brief Execute a task and report it to its group.
+    ///
+    /// \param state group state
+    /// \param task group task
+    static void runTask (const boost::shared_ptr<State>& state,
+			 const ThreadPool::task_t& task) throw ();
+
+    /// \brief Wrap a task so that it reports to the group.
+    ThreadPool::task_t wrap (const ThreadPool::task_t& task) const throw ();
+
+    /// \brief Pool executing the tasks.
+    ThreadPool& pool_;
+    /// \brief Group state.
+    boost::shared_ptr<State> state_;
+  };
+
+  /// @}
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_THREAD_POOL_HH
@@ -45,6 +45,24 @@ namespace roboptim
     jacobian_from_gradients (typename DifferentiableFunction::matrix_t& jac,
                              const std::vector<const T*>& c,
                              const DifferentiableFunction::vector_t& x);
+
+    /// \internal
+    /// \brief Compute the gradient of a differentiable cost function.
+    ///
+    /// \return true
+    inline bool
+    costGradient (const DifferentiableFunction& function,
+		  DifferentiableFunction::gradient_t& gradient,
+		  const DifferentiableFunction::argument_t& argument);
+
+    /// \internal
+    /// \brief Non-differentiable cost functions do not have a gradient.
+    ///
+    /// \return false
+    inline bool
+    costGradient (const Function& function,
+		  DifferentiableFunction::gradient_t& gradient,
+		  const DifferentiableFunction::argument_t& argument);
   } // end of namespace detail.
 
   /// \brief Display a vector.
@@ -37,6 +37,23 @@ namespace roboptim
             jac (i, j) = grad(0, j);
         }
     }
+
+    inline bool
+    costGradient (const DifferentiableFunction& function,
+		  DifferentiableFunction::gradient_t& gradient,
+		  const DifferentiableFunction::argument_t& argument)
+    {
+      function.gradient (gradient, argument, 0);
+      return true;
+    }
+
+    inline bool
+    costGradient (const Function&,
+		  DifferentiableFunction::gradient_t&,
+		  const DifferentiableFunction::argument_t&)
+    {
+      return false;
+    }
   } // end of namespace detail.
 
   template <typename T>
@@ -0,0 +1,102 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ROBOPTIM_CORE_WARM_START_HH
+# define ROBOPTIM_CORE_WARM_START_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <iostream>
+# include <vector>
+
+# include <boost/optional.hpp>
+
+# include <roboptim/core/function.hh>
+# include <roboptim/core/result.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_problem
+  /// @{
+
+  /// \brief Initial state of a solver, reused from a previous solve.
+  ///
+  /// When consecutive problems are close (receding-horizon control,
+  /// parameter sweeps...), starting from the previous solution saves
+  /// many iterations. This class gathers what a solver may reuse:
+  /// the primal point, the Lagrange multipliers and, optionally, the
+  /// active set and the Hessian approximation of the Lagrangian.
+  ///
+  /// A warm start is set on the solver (see GenericSolver::warmStart),
+  /// plug-ins are free to use all of it, part of it or nothing.
+  class ROBOPTIM_DLLAPI WarmStart
+  {
+  public:
+    /// \brief Import size type from Function class.
+    typedef Function::size_type size_type;
+    /// \brief Import vector type from Function class.
+    typedef Function::vector_t vector_t;
+    /// \brief Import matrix type from Function class.
+    typedef Function::matrix_t matrix_t;
+    /// \brief Active set type (indices of the active constraints rows).
+    typedef std::vector<size_type> activeSet_t;
+
+    /// \brief Instantiate an empty warm start.
+    ///
+    /// The primal point is set to zero and there is no multiplier.
+    ///
+    /// \param inputSize problem input size
+    explicit WarmStart (size_type inputSize) throw ();
+
+    /// \brief Instantiate a warm start from a previous result.
+    ///
+    /// \param result result of a previous solve
+    explicit WarmStart (const Result& result) throw ();
+
+    virtual ~WarmStart () throw ();
+
+    /// \brief Display the warm start on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    virtual std::ostream& print (std::ostream& o) const throw ();
+
+    /// \brief Input size (i.e. argument size).
+    size_type inputSize;
+    /// \brief Primal point.
+    vector_t x;
+    /// \brief Lagrange multipliers (empty if unknown).
+    vector_t lambda;
+    /// \brief Active constraints rows (optional).
+    boost::optional<activeSet_t> activeSet;
+    /// \brief Hessian approximation of the Lagrangian (optional).
+    boost::optional<matrix_t> hessian;
+  };
+
+  /// @}
+
+  /// \brief Override operator<< to handle warm start display.
+  ///
+  /// \param o output stream used for display
+  /// \param ws warm start to be displayed
+  /// \return output stream
+  ROBOPTIM_DLLAPI std::ostream& operator<< (std::ostream& o,
+					    const WarmStart& ws);
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_WARM_START_HH
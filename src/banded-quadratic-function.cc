@@ -0,0 +1,123 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "debug.hh"
+
+#include <roboptim/core/indent.hh>
+#include <roboptim/core/banded-quadratic-function.hh>
+#include <roboptim/core/util.hh>
+
+namespace roboptim
+{
+  BandedQuadraticFunction::BandedQuadraticFunction (const matrix_t& bands,
+						    const vector_t& b)
+    throw ()
+    : QuadraticFunction (bands.rows (), 1, "banded quadratic function"),
+      bands_ (bands),
+      b_ (b),
+      buffer_ (b.size ())
+  {
+    assert (bands.rows () == b.size ());
+    assert (bands.cols () >= 1 && bands.cols () <= bands.rows ());
+  }
+
+  BandedQuadraticFunction::~BandedQuadraticFunction () throw ()
+  {
+  }
+
+  const BandedQuadraticFunction::matrix_t&
+  BandedQuadraticFunction::bands () const throw ()
+  {
+    return bands_;
+  }
+
+  BandedQuadraticFunction::size_type
+  BandedQuadraticFunction::bandwidth () const throw ()
+  {
+    return bands_.cols () - 1;
+  }
+
+  const BandedQuadraticFunction::vector_t&
+  BandedQuadraticFunction::b () const throw ()
+  {
+    return b_;
+  }
+
+  void
+  BandedQuadraticFunction::multiply (vector_t& y, const argument_t& x)
+    const throw ()
+  {
+    const size_type n = x.size ();
+    y = bands_.col (0).cwiseProduct (x);
+
+    // Each sub-diagonal contributes twice, as A is symmetric.
+    for (size_type j = 1; j < bands_.cols (); ++j)
+      {
+	const size_type m = n - j;
+	y.tail (m) += bands_.col (j).head (m).cwiseProduct (x.head (m));
+	y.head (m) += bands_.col (j).head (m).cwiseProduct (x.tail (m));
+      }
+  }
+
+  // 1/2 * x^T * A * x + b^T * x
+  void
+  BandedQuadraticFunction::impl_compute (result_t& result,
+					 const argument_t& argument)
+    const throw ()
+  {
+    multiply (buffer_, argument);
+    result (0) = .5 * argument.dot (buffer_) + b_.dot (argument);
+  }
+
+  // A * x + b
+  void
+  BandedQuadraticFunction::impl_gradient (gradient_t& gradient,
+					  const argument_t& x,
+					  size_type) const throw ()
+  {
+    multiply (gradient, x);
+    gradient += b_;
+  }
+
+  // A
+  void
+  BandedQuadraticFunction::impl_hessian (hessian_t& hessian,
+					 const argument_t&,
+					 size_type) const throw ()
+  {
+    const size_type n = hessian.rows ();
+    hessian.setZero ();
+    hessian.diagonal () = bands_.col (0);
+    for (size_type j = 1; j < bands_.cols (); ++j)
+      {
+	hessian.diagonal (-j) = bands_.col (j).head (n - j);
+	hessian.diagonal (j) = bands_.col (j).head (n - j);
+      }
+  }
+
+  std::ostream&
+  BandedQuadraticFunction::print (std::ostream& o) const throw ()
+  {
+    return o << "Banded quadratic function" << incindent << iendl
+             << "Bandwidth = " << bandwidth () << iendl
+             << "Bands = " << bands_ << iendl
+             << "B = " << b_
+             << decindent;
+  }
+
+} // end of namespace roboptim
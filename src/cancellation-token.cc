@@ -0,0 +1,146 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "debug.hh"
+
+#include "roboptim/core/cancellation-token.hh"
+
+namespace roboptim
+{
+  namespace
+  {
+    CancellationToken::deadline_t utcNow ()
+    {
+      return boost::posix_time::microsec_clock::universal_time ();
+    }
+  } // end of anonymous namespace.
+
+  CancellationToken::steadyClock_t::time_point
+  CancellationToken::steadyDeadline (const duration_t& timeout) throw ()
+  {
+    if (timeout.is_pos_infinity ())
+      return steadyClock_t::time_point::max ();
+    if (timeout.is_neg_infinity ())
+      return steadyClock_t::time_point::min ();
+    return steadyClock_t::now ()
+      + boost::chrono::microseconds (timeout.total_microseconds ());
+  }
+
+  CancellationToken::CancellationToken () throw ()
+    : mutex_ (),
+      cancelled_ (false),
+      deadline_ (steadyClock_t::time_point::max ())
+  {
+  }
+
+  CancellationToken::CancellationToken (const duration_t& timeout) throw ()
+    : mutex_ (),
+      cancelled_ (false),
+      deadline_ (steadyDeadline (timeout))
+  {
+  }
+
+  CancellationToken::~CancellationToken () throw ()
+  {
+  }
+
+  void
+  CancellationToken::cancel () throw ()
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    cancelled_ = true;
+  }
+
+  bool
+  CancellationToken::cancelled () const throw ()
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    return cancelled_;
+  }
+
+  void
+  CancellationToken::setDeadline (const deadline_t& deadline) throw ()
+  {
+    if (deadline.is_pos_infinity ())
+      setTimeout (boost::posix_time::pos_infin);
+    else if (deadline.is_neg_infinity ())
+      setTimeout (boost::posix_time::neg_infin);
+    else
+      setTimeout (deadline - utcNow ());
+  }
+
+  void
+  CancellationToken::setTimeout (const duration_t& timeout) throw ()
+  {
+    steadyClock_t::time_point deadline = steadyDeadline (timeout);
+    boost::mutex::scoped_lock lock (mutex_);
+    deadline_ = deadline;
+  }
+
+  CancellationToken::deadline_t
+  CancellationToken::deadline () const throw ()
+  {
+    steadyClock_t::time_point deadline;
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      deadline = deadline_;
+    }
+    if (deadline == steadyClock_t::time_point::max ())
+      return boost::posix_time::pos_infin;
+    if (deadline == steadyClock_t::time_point::min ())
+      return boost::posix_time::neg_infin;
+
+    boost::chrono::microseconds remaining =
+      boost::chrono::duration_cast<boost::chrono::microseconds>
+      (deadline - steadyClock_t::now ());
+    return utcNow () + boost::posix_time::microseconds (remaining.count ());
+  }
+
+  bool
+  CancellationToken::expired () const throw ()
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    return deadline_ != steadyClock_t::time_point::max ()
+      && steadyClock_t::now () >= deadline_;
+  }
+
+  bool
+  CancellationToken::stopRequested () const throw ()
+  {
+    return cancelled () || expired ();
+  }
+
+  std::string
+  CancellationToken::reason () const throw ()
+  {
+    if (cancelled ())
+      return "solve cancelled";
+    if (expired ())
+      return "deadline exceeded";
+    return std::string ();
+  }
+
+  void
+  CancellationToken::reset () throw ()
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    cancelled_ = false;
+    deadline_ = steadyClock_t::time_point::max ();
+  }
+
+} // end of namespace roboptim
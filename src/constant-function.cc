@@ -58,6 +58,12 @@ namespace roboptim
     gradient.setZero ();
   }
 
+  ConstantFunction::structure_t
+  ConstantFunction::structure () const throw ()
+  {
+    return LinearFunction::structure () | SEPARABLE | INDEPENDENT_ROWS;
+  }
+
   std::ostream&
   ConstantFunction::print (std::ostream& o) const throw ()
   {
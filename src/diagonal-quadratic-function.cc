@@ -0,0 +1,97 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "debug.hh"
+
+#include <roboptim/core/indent.hh>
+#include <roboptim/core/diagonal-quadratic-function.hh>
+#include <roboptim/core/util.hh>
+
+namespace roboptim
+{
+  DiagonalQuadraticFunction::DiagonalQuadraticFunction (const vector_t& d,
+							const vector_t& b)
+    throw ()
+    : QuadraticFunction (d.size (), 1, "diagonal quadratic function"),
+      d_ (d),
+      b_ (b)
+  {
+    assert (d.size () == b.size ());
+  }
+
+  DiagonalQuadraticFunction::~DiagonalQuadraticFunction () throw ()
+  {
+  }
+
+  const DiagonalQuadraticFunction::vector_t&
+  DiagonalQuadraticFunction::diagonal () const throw ()
+  {
+    return d_;
+  }
+
+  const DiagonalQuadraticFunction::vector_t&
+  DiagonalQuadraticFunction::b () const throw ()
+  {
+    return b_;
+  }
+
+  // 1/2 * sum (d_i * x_i^2) + b^T * x
+  void
+  DiagonalQuadraticFunction::impl_compute (result_t& result,
+					   const argument_t& argument)
+    const throw ()
+  {
+    result (0) = .5 * (d_.array () * argument.array ().square ()).sum ()
+      + b_.dot (argument);
+  }
+
+  // d .* x + b
+  void
+  DiagonalQuadraticFunction::impl_gradient (gradient_t& gradient,
+					    const argument_t& x,
+					    size_type) const throw ()
+  {
+    gradient = d_.cwiseProduct (x) + b_;
+  }
+
+  // diag (d)
+  void
+  DiagonalQuadraticFunction::impl_hessian (hessian_t& hessian,
+					   const argument_t&,
+					   size_type) const throw ()
+  {
+    hessian.setZero ();
+    hessian.diagonal () = d_;
+  }
+
+  DiagonalQuadraticFunction::structure_t
+  DiagonalQuadraticFunction::structure () const throw ()
+  {
+    return QuadraticFunction::structure () | SEPARABLE;
+  }
+
+  std::ostream&
+  DiagonalQuadraticFunction::print (std::ostream& o) const throw ()
+  {
+    return o << "Diagonal quadratic function" << incindent << iendl
+             << "D = " << d_ << iendl
+             << "B = " << b_
+             << decindent;
+  }
+
+} // end of namespace roboptim
@@ -18,6 +18,7 @@
 #include "debug.hh"
 
 #include "roboptim/core/function.hh"
+#include "roboptim/core/plugin-registry.hh"
 #include "roboptim/core/problem.hh"
 #include "roboptim/core/plugin/dummy-laststate.hh"
 
@@ -26,14 +27,10 @@ namespace roboptim
   DummySolverLastState::DummySolverLastState (const problem_t& pb) throw ()
     : parent_t (pb)
   {
-    parameters_["dummy-parameter"].description = "dummy parameter";
-    parameters_["dummy-parameter"].value = 42.;
-
-    parameters_["dummy-parameter2"].description = "yet another dummy parameter";
-    parameters_["dummy-parameter2"].value = 3;
-
-    parameters_["dummy-parameter3"].description = "just a dummy key";
-    parameters_["dummy-parameter3"].value = "...and a dummy value!";
+    declareParameter ("dummy-parameter", "dummy parameter", 42.);
+    declareParameter ("dummy-parameter2", "yet another dummy parameter", 3);
+    declareParameter ("dummy-parameter3", "just a dummy key",
+		      std::string ("...and a dummy value!"));
   }
 
   DummySolverLastState::~DummySolverLastState () throw ()
@@ -50,35 +47,64 @@ namespace roboptim
     res.lambda.fill(0);
     res.value.fill(42);
 
+    // Stop if requested by the client.
+    if (stopRequested ())
+      {
+	interrupt (res);
+	return;
+      }
+
+    // Report the (only) iteration.
+    if (hasIterationCallback ()
+	&& !iterate (SolverState (0, res.x, res.value[0], 0., res.lambda)))
+      {
+	result_ = SolverError ("The dummy solver has been stopped.", res);
+	return;
+      }
+
     // Add these values to SolverError
     result_ = SolverError ("The dummy solver always fail.", res);
   }
 
 } // end of namespace roboptim
 
+// When plug-ins are linked statically, entry points are file-local
+// and registered by name.
+#ifdef ROBOPTIM_CORE_STATIC_PLUGINS
+namespace
+#else
 extern "C"
+#endif //! ROBOPTIM_CORE_STATIC_PLUGINS
 {
   using namespace roboptim;
   typedef DummySolverLastState::parent_t solver_t;
 
-  ROBOPTIM_DLLEXPORT unsigned getSizeOfProblem ();
-  ROBOPTIM_DLLEXPORT solver_t* create
+  ROBOPTIM_CORE_PLUGIN_API unsigned getSizeOfProblem ();
+  ROBOPTIM_CORE_PLUGIN_API solver_t* create
     (const DummySolverLastState::problem_t& pb);
-  ROBOPTIM_DLLEXPORT void destroy (solver_t* p);
+  ROBOPTIM_CORE_PLUGIN_API void destroy (solver_t* p);
 
-  ROBOPTIM_DLLEXPORT unsigned getSizeOfProblem ()
+  ROBOPTIM_CORE_PLUGIN_API unsigned getSizeOfProblem ()
   {
     return sizeof (solver_t::problem_t);
   }
 
-  ROBOPTIM_DLLEXPORT solver_t* create
+  ROBOPTIM_CORE_PLUGIN_API solver_t* create
     (const DummySolverLastState::problem_t& pb)
   {
     return new DummySolverLastState (pb);
   }
 
-  ROBOPTIM_DLLEXPORT void destroy (solver_t* p)
+  ROBOPTIM_CORE_PLUGIN_API void destroy (solver_t* p)
   {
     delete p;
   }
 }
+
+#ifdef ROBOPTIM_CORE_STATIC_PLUGINS
+namespace
+{
+  StaticPluginRegistrar registrar
+  ("dummy-laststate", &getSizeOfProblem, &create, &destroy);
+}
+#endif //! ROBOPTIM_CORE_STATIC_PLUGINS
@@ -18,6 +18,7 @@
 #include "debug.hh"
 
 #include "roboptim/core/function.hh"
+#include "roboptim/core/plugin-registry.hh"
 #include "roboptim/core/problem.hh"
 #include "roboptim/core/plugin/dummy.hh"
 
@@ -26,14 +27,10 @@ namespace roboptim
   DummySolver::DummySolver (const problem_t& pb) throw ()
     : parent_t (pb)
   {
-    parameters_["dummy-parameter"].description = "dummy parameter";
-    parameters_["dummy-parameter"].value = 42.;
-
-    parameters_["dummy-parameter2"].description = "yet another dummy parameter";
-    parameters_["dummy-parameter2"].value = 3;
-
-    parameters_["dummy-parameter3"].description = "just a dummy key";
-    parameters_["dummy-parameter3"].value = "...and a dummy value!";
+    declareParameter ("dummy-parameter", "dummy parameter", 42.);
+    declareParameter ("dummy-parameter2", "yet another dummy parameter", 3);
+    declareParameter ("dummy-parameter3", "just a dummy key",
+		      std::string ("...and a dummy value!"));
   }
 
   DummySolver::~DummySolver () throw ()
@@ -48,27 +45,43 @@ namespace roboptim
 
 } // end of namespace roboptim
 
+// When plug-ins are linked statically, entry points are file-local
+// and registered by name.
+#ifdef ROBOPTIM_CORE_STATIC_PLUGINS
+namespace
+#else
 extern "C"
+#endif //! ROBOPTIM_CORE_STATIC_PLUGINS
 {
   using namespace roboptim;
   typedef DummySolver::parent_t solver_t;
 
-  ROBOPTIM_DLLEXPORT unsigned getSizeOfProblem ();
-  ROBOPTIM_DLLEXPORT solver_t* create (const DummySolver::problem_t& pb);
-  ROBOPTIM_DLLEXPORT void destroy (solver_t* p);
+  ROBOPTIM_CORE_PLUGIN_API unsigned getSizeOfProblem ();
+  ROBOPTIM_CORE_PLUGIN_API solver_t* create
+    (const DummySolver::problem_t& pb);
+  ROBOPTIM_CORE_PLUGIN_API void destroy (solver_t* p);
 
-  ROBOPTIM_DLLEXPORT unsigned getSizeOfProblem ()
+  ROBOPTIM_CORE_PLUGIN_API unsigned getSizeOfProblem ()
   {
     return sizeof (solver_t::problem_t);
   }
 
-  ROBOPTIM_DLLEXPORT solver_t* create (const DummySolver::problem_t& pb)
+  ROBOPTIM_CORE_PLUGIN_API solver_t* create
+    (const DummySolver::problem_t& pb)
   {
     return new DummySolver (pb);
   }
 
-  ROBOPTIM_DLLEXPORT void destroy (solver_t* p)
+  ROBOPTIM_CORE_PLUGIN_API void destroy (solver_t* p)
   {
     delete p;
   }
 }
+
+#ifdef ROBOPTIM_CORE_STATIC_PLUGINS
+namespace
+{
+  StaticPluginRegistrar registrar
+  ("dummy", &getSizeOfProblem, &create, &destroy);
+}
+#endif //! ROBOPTIM_CORE_STATIC_PLUGINS
@@ -0,0 +1,295 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "debug.hh"
+
+#include <limits>
+#include <stdexcept>
+
+#include <boost/format.hpp>
+
+#include <roboptim/core/indent.hh>
+#include <roboptim/core/filter/algebra.hh>
+#include <roboptim/core/filter/chain.hh>
+
+namespace roboptim
+{
+  namespace
+  {
+    /// \brief Check the stages and return them unchanged.
+    ///
+    /// \throw std::runtime_error if there is no stage or if a stage
+    /// input size is not the previous stage output size
+    const Chain::stages_t& checkStages (const Chain::stages_t& stages)
+    {
+      if (stages.empty ())
+	throw std::runtime_error ("Invalid chain (no stage)");
+      for (std::size_t k = 1; k < stages.size (); ++k)
+	if (stages[k]->inputSize () != stages[k - 1]->outputSize ())
+	  throw std::runtime_error ("Invalid chain (wrong stage input size)");
+      return stages;
+    }
+
+    std::string chainName (const Chain::stages_t& stages)
+    {
+      std::string name = stages[0]->getName ();
+      for (std::size_t k = 1; k < stages.size (); ++k)
+	{
+	  boost::format fmt ("%1% (%2%)");
+	  fmt % stages[k]->getName () % name;
+	  name = fmt.str ();
+	}
+      return name;
+    }
+  } // end of anonymous namespace.
+
+  // The base class arguments evaluation order is unspecified: each
+  // of them checks the stages before using them.
+  Chain::Chain (const stages_t& stages)
+    : DifferentiableFunction (checkStages (stages).front ()->inputSize (),
+			      checkStages (stages).back ()->outputSize (),
+			      chainName (checkStages (stages))),
+      stages_ (stages),
+      values_ (),
+      jacobians_ (),
+      adjoints_ (),
+      jacobianX_ (stages.front ()->inputSize ()),
+      jacobianValid_ (false),
+      products_ (),
+      schedule_ (),
+      partials_ (),
+      root_ (-1),
+      cost_ (0)
+  {
+    const std::size_t n = stages_.size ();
+    for (std::size_t k = 0; k < n; ++k)
+      {
+	values_.push_back (vector_t (stages_[k]->outputSize ()));
+	values_.back ().setZero ();
+	jacobians_.push_back (jacobian_t (stages_[k]->outputSize (),
+					  stages_[k]->inputSize ()));
+	jacobians_.back ().setZero ();
+	adjoints_.push_back (gradient_t (stages_[k]->inputSize ()));
+	adjoints_.back ().setZero ();
+      }
+
+    // The product J_{n-1} ... J_0 is written from the last stage:
+    // position p holds the jacobian of stage n - 1 - p, of size
+    // dims[p] x dims[p + 1].
+    std::vector<size_type> dims (n + 1);
+    for (std::size_t p = 0; p < n; ++p)
+      dims[p] = stages_[n - 1 - p]->outputSize ();
+    dims[n] = stages_[0]->inputSize ();
+
+    // Matrix-chain ordering: cost[i][j] is the minimal number of
+    // multiplications to compute the product of positions i to j,
+    // split[i][j] the position after which this product is split.
+    std::vector<std::vector<size_type> > cost
+      (n, std::vector<size_type> (n, 0));
+    std::vector<std::vector<std::size_t> > split
+      (n, std::vector<std::size_t> (n, 0));
+    for (std::size_t length = 2; length <= n; ++length)
+      for (std::size_t i = 0; i + length <= n; ++i)
+	{
+	  const std::size_t j = i + length - 1;
+	  cost[i][j] = std::numeric_limits<size_type>::max ();
+	  for (std::size_t k = i; k < j; ++k)
+	    {
+	      const size_type c = cost[i][k] + cost[k + 1][j]
+		+ dims[i] * dims[k + 1] * dims[j + 1];
+	      if (c < cost[i][j])
+		{
+		  cost[i][j] = c;
+		  split[i][j] = k;
+		}
+	    }
+	}
+    cost_ = cost[0][n - 1];
+    root_ = buildProduct (split, 0, n - 1);
+  }
+
+  Chain::~Chain () throw ()
+  {
+  }
+
+  int
+  Chain::buildProduct (const std::vector<std::vector<std::size_t> >& split,
+		       std::size_t i, std::size_t j) throw ()
+  {
+    Product product;
+    product.left = -1;
+    product.right = -1;
+    product.stage = stages_.size () - 1 - i;
+
+    if (i != j)
+      {
+	product.left = buildProduct (split, i, split[i][j]);
+	product.right = buildProduct (split, split[i][j] + 1, j);
+      }
+
+    products_.push_back (product);
+    const int node = static_cast<int> (products_.size ()) - 1;
+
+    // Only internal nodes need a buffer, except the root one: the
+    // root product is written directly into the result.
+    partials_.push_back (jacobian_t ());
+    if (i == j)
+      return node;
+    schedule_.push_back (node);
+    if (i > 0 || j + 1 < stages_.size ())
+      {
+	partials_.back ().resize
+	  (operand (product.left).rows (), operand (product.right).cols ());
+	partials_.back ().setZero ();
+      }
+    return node;
+  }
+
+  const Chain::jacobian_t&
+  Chain::operand (int node) const throw ()
+  {
+    const Product& product = products_[static_cast<std::size_t> (node)];
+    if (product.left < 0)
+      return jacobians_[product.stage];
+    return partials_[static_cast<std::size_t> (node)];
+  }
+
+  const Chain::stages_t&
+  Chain::stages () const throw ()
+  {
+    return stages_;
+  }
+
+  Chain::size_type
+  Chain::productCost () const throw ()
+  {
+    return cost_;
+  }
+
+  Chain::structure_t
+  Chain::structure () const throw ()
+  {
+    structure_t flags = stages_[0]->structure ();
+    for (std::size_t k = 1; k < stages_.size (); ++k)
+      flags = detail::composeStructure (stages_[k]->structure (), flags);
+    return flags;
+  }
+
+  void
+  Chain::computeStages (const argument_t& argument, std::size_t count,
+			bool jacobians) const throw ()
+  {
+    for (std::size_t k = 0; k < count; ++k)
+      {
+	const argument_t& input = k ? values_[k - 1] : argument;
+	(*stages_[k]) (values_[k], input);
+	if (jacobians)
+	  stages_[k]->jacobian (jacobians_[k], input);
+      }
+  }
+
+  void
+  Chain::impl_compute (result_t& result, const argument_t& argument)
+    const throw ()
+  {
+    // The stages values are overwritten: the cache is lost.
+    jacobianValid_ = false;
+    const std::size_t n = stages_.size ();
+    computeStages (argument, n - 1, false);
+    (*stages_.back ()) (result, n > 1 ? values_[n - 2] : argument);
+  }
+
+  void
+  Chain::impl_gradient (gradient_t& gradient,
+			const argument_t& argument,
+			size_type functionId)
+    const throw ()
+  {
+    // Reverse accumulation: J_0^T ... J_{n-2}^T grad f_{n-1}.
+    const std::size_t n = stages_.size ();
+    if (!jacobianValid_ || jacobianX_ != argument)
+      {
+	computeStages (argument, n - 1, true);
+	jacobianX_ = argument;
+	jacobianValid_ = true;
+      }
+    if (n == 1)
+      {
+	stages_[0]->gradient (gradient, argument, functionId);
+	return;
+      }
+
+    stages_.back ()->gradient (adjoints_[n - 1], values_[n - 2], functionId);
+    for (std::size_t k = n - 2; k > 0; --k)
+      adjoints_[k].noalias () = jacobians_[k].transpose () * adjoints_[k + 1];
+    gradient.noalias () = jacobians_[0].transpose () * adjoints_[1];
+  }
+
+  void
+  Chain::impl_jacobian (jacobian_t& jacobian, const argument_t& argument)
+    const throw ()
+  {
+    computeStages (argument, stages_.size (), true);
+    jacobianX_ = argument;
+    jacobianValid_ = true;
+    if (schedule_.empty ())
+      {
+	jacobian = jacobians_[0];
+	return;
+      }
+
+    // Children are always scheduled before their parent, the root
+    // is the last node.
+    for (std::size_t k = 0; k + 1 < schedule_.size (); ++k)
+      {
+	const std::size_t node = static_cast<std::size_t> (schedule_[k]);
+	partials_[node].noalias () =
+	  operand (products_[node].left) * operand (products_[node].right);
+      }
+    const Product& root = products_[static_cast<std::size_t> (root_)];
+    jacobian.noalias () = operand (root.left) * operand (root.right);
+  }
+
+  void
+  Chain::printProduct (std::ostream& o, int node) const throw ()
+  {
+    const Product& product = products_[static_cast<std::size_t> (node)];
+    if (product.left < 0)
+      {
+	o << "J" << product.stage;
+	return;
+      }
+    o << "(";
+    printProduct (o, product.left);
+    o << " ";
+    printProduct (o, product.right);
+    o << ")";
+  }
+
+  std::ostream&
+  Chain::print (std::ostream& o) const throw ()
+  {
+    o << "Chain (" << stages_.size () << " stages)" << incindent << iendl
+      << "Jacobian product: ";
+    printProduct (o, root_);
+    o << " (" << cost_ << " multiplications)";
+    for (std::size_t k = 0; k < stages_.size (); ++k)
+      o << iendl << k << ": " << *stages_[k];
+    return o << decindent;
+  }
+
+} // end of namespace roboptim
@@ -28,13 +28,19 @@ namespace roboptim
 
   GenericSolver::GenericSolver () throw ()
     : boost::noncopyable (),
-      result_ (NoSolution ())
+      result_ (NoSolution ()),
+      warmStart_ (),
+      callback_ (),
+      token_ ()
   {
   }
 
   GenericSolver::GenericSolver (const GenericSolver& solver) throw ()
     : boost::noncopyable (),
-      result_ (solver.result_)
+      result_ (solver.result_),
+      warmStart_ (solver.warmStart_),
+      callback_ (solver.callback_),
+      token_ (solver.token_)
   {
   }
 
@@ -49,6 +55,85 @@ namespace roboptim
     result_ = NoSolution ();
   }
 
+  void
+  GenericSolver::setWarmStart (const WarmStart& warmStart) throw ()
+  {
+    warmStart_ = warmStart;
+  }
+
+  bool
+  GenericSolver::setWarmStart (const result_t& result) throw ()
+  {
+    switch (result.which ())
+      {
+      case SOLVER_VALUE:
+	warmStart_ = WarmStart (boost::get<Result> (result));
+	return true;
+      case SOLVER_VALUE_WARNINGS:
+	warmStart_ = WarmStart (boost::get<ResultWithWarnings> (result));
+	return true;
+      case SOLVER_ERROR:
+	{
+	  const SolverError& error = boost::get<SolverError> (result);
+	  if (!error.lastState ())
+	    return false;
+	  warmStart_ = WarmStart (*error.lastState ());
+	  return true;
+	}
+      default:
+	break;
+      }
+    return false;
+  }
+
+  void
+  GenericSolver::resetWarmStart () throw ()
+  {
+    warmStart_ = boost::none;
+  }
+
+  const boost::optional<WarmStart>&
+  GenericSolver::warmStart () const throw ()
+  {
+    return warmStart_;
+  }
+
+  void
+  GenericSolver::setIterationCallback (const callback_t& callback) throw ()
+  {
+    callback_ = callback;
+  }
+
+  const GenericSolver::callback_t&
+  GenericSolver::iterationCallback () const throw ()
+  {
+    return callback_;
+  }
+
+  void
+  GenericSolver::setCancellationToken
+  (boost::shared_ptr<CancellationToken> token) throw ()
+  {
+    token_ = token;
+  }
+
+  const boost::shared_ptr<CancellationToken>&
+  GenericSolver::cancellationToken () const throw ()
+  {
+    return token_;
+  }
+
+  void
+  GenericSolver::interrupt (const Result& lastState) throw ()
+  {
+    std::string reason = token_ ? token_->reason () : std::string ();
+    if (reason.empty ())
+      reason = "stopped by the iteration callback";
+
+    LOG4CXX_INFO (logger, "Solver has been interrupted: " << reason);
+    result_ = SolverError ("solver interrupted: " + reason, lastState);
+  }
+
   const GenericSolver::result_t&
   GenericSolver::minimum () throw ()
   {
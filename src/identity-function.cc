@@ -59,6 +59,12 @@ namespace roboptim
     gradient[idFunction] = 1.;
   }
 
+  IdentityFunction::structure_t
+  IdentityFunction::structure () const throw ()
+  {
+    return LinearFunction::structure () | SEPARABLE | INDEPENDENT_ROWS;
+  }
+
   std::ostream&
   IdentityFunction::print (std::ostream& o) const throw ()
   {
@@ -30,6 +30,13 @@ namespace roboptim
   {
   }
 
+  LinearFunction::structure_t
+  LinearFunction::structure () const throw ()
+  {
+    return QuadraticFunction::structure () | LINEAR | CONSTANT_JACOBIAN
+      | SEPARABLE;
+  }
+
   void
   LinearFunction::impl_hessian (hessian_t& hessian,
 				const vector_t&,
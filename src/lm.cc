@@ -0,0 +1,495 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "debug.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "roboptim/core/function.hh"
+#include "roboptim/core/plugin-registry.hh"
+#include "roboptim/core/problem.hh"
+#include "roboptim/core/plugin/lm.hh"
+
+namespace roboptim
+{
+  namespace
+  {
+    /// \brief Retrieve the residuals of a least-squares objective.
+    ///
+    /// \return null if the objective is not a sum of squares
+    const DifferentiableFunction*
+    leastSquaresBase (const DifferentiableFunction& objective)
+    {
+      const SumOfC1Squares* squares =
+	dynamic_cast<const SumOfC1Squares*> (&objective);
+      return squares ? squares->baseFunction ().get () : 0;
+    }
+
+    /// \brief Are all the coefficients of a vector finite?
+    ///
+    /// x - x is zero for finite coefficients and NaN otherwise
+    /// (allFinite requires Eigen 3.2).
+    bool
+    allFinite (const Function::vector_t& x)
+    {
+      return ((x - x).array () == 0.).all ();
+    }
+  } // end of anonymous namespace.
+
+  LevenbergMarquardtSolver::LevenbergMarquardtSolver (const problem_t& pb)
+    throw ()
+    : parent_t (pb),
+      base_ (leastSquaresBase (pb.function ())),
+      maxIterations_
+      (declareParameter ("max-iterations",
+			 "maximum number of iterations", 100)),
+      linearSolver_
+      (declareParameter ("lm.linear-solver",
+			 "linear solver (cholesky or qr)",
+			 std::string ("cholesky"))),
+      sparseThreshold_
+      (declareParameter ("lm.sparse-threshold",
+			 "jacobian density below which sparse matrices are used",
+			 0.1)),
+      initialDamping_
+      (declareParameter ("lm.initial-damping",
+			 "initial damping, relative to max (diag (J^T J))",
+			 1e-3)),
+      gradientTolerance_
+      (declareParameter ("lm.gradient-tolerance",
+			 "tolerance on the gradient infinity norm", 1e-10)),
+      stepTolerance_
+      (declareParameter ("lm.step-tolerance",
+			 "tolerance on the step norm, relative to x", 1e-10)),
+      costTolerance_
+      (declareParameter ("lm.cost-tolerance",
+			 "tolerance on the cost decrease, relative to the cost",
+			 1e-12)),
+      sparse_ (false),
+      qr_ (false)
+  {
+  }
+
+  LevenbergMarquardtSolver::~LevenbergMarquardtSolver () throw ()
+  {
+  }
+
+  void
+  LevenbergMarquardtSolver::solve () throw ()
+  {
+    if (!base_)
+      {
+	result_ = SolverError
+	  ("the lm solver requires a SumOfC1Squares objective");
+	return;
+      }
+    if (!problem ().constraints ().empty ())
+      {
+	result_ = SolverError ("the lm solver does not support constraints");
+	return;
+      }
+
+    try
+      {
+	bindParameters ();
+      }
+    catch (const std::runtime_error& e)
+      {
+	result_ = SolverError (e.what ());
+	return;
+      }
+
+    const std::string& linearSolver = parameter (linearSolver_);
+    if (linearSolver != "cholesky" && linearSolver != "qr")
+      {
+	result_ = SolverError
+	  ("unknown linear solver ``" + linearSolver + "''");
+	return;
+      }
+    qr_ = linearSolver == "qr";
+
+    // Workspaces shared by all the paths.
+    const size_type n = problem ().function ().inputSize ();
+    const size_type m = base_->outputSize ();
+    if (jacobian_.rows () != m || jacobian_.cols () != n)
+      {
+	x_.resize (n);
+	candidate_.resize (n);
+	residuals_.resize (m);
+	candidateResiduals_.resize (m);
+	predicted_.resize (m);
+	gradient_.resize (n);
+	step_.resize (n);
+	jacobian_.resize (m, n);
+      }
+
+    // Starting point.
+    if (warmStart () && warmStart ()->x.size () == x_.size ())
+      x_ = warmStart ()->x;
+    else if (problem ().startingPoint ())
+      x_ = *problem ().startingPoint ();
+    else
+      x_.setZero ();
+    project (x_);
+
+    (*base_) (residuals_, x_);
+    value_type cost = residuals_.squaredNorm ();
+    computeJacobian ();
+
+    // The path is selected once, from the jacobian at the starting
+    // point.
+    const value_type density = jacobian_.size ()
+      ? static_cast<value_type> ((jacobian_.array () != 0.).count ())
+      / static_cast<value_type> (jacobian_.size ())
+      : 1.;
+    sparse_ = !qr_ && density < parameter (sparseThreshold_);
+    allocateWorkspaces ();
+    if (sparse_)
+      buildSparsePattern ();
+    buildNormal ();
+
+    value_type damping = parameter (initialDamping_);
+    if (jacobian_.size ())
+      {
+	const value_type scale = jacobian_.colwise ().squaredNorm ().maxCoeff ();
+	if (scale > 0.)
+	  damping *= scale;
+      }
+    value_type factor = 2.;
+
+    const value_type xtol = parameter (stepTolerance_);
+    for (int iteration = 0; ; ++iteration)
+      {
+	if (stopRequested ())
+	  {
+	    interrupt (lastState (cost));
+	    return;
+	  }
+	if (hasIterationCallback ()
+	    && !iterate (SolverState (iteration, x_, cost, 0., vector_t ())))
+	  {
+	    result_ = SolverError ("the lm solver has been stopped",
+				   lastState (cost));
+	    return;
+	  }
+
+	if (gradient_.lpNorm<Eigen::Infinity> ()
+	    <= parameter (gradientTolerance_))
+	  {
+	    result_ = lastState (cost);
+	    return;
+	  }
+	if (iteration >= parameter (maxIterations_))
+	  {
+	    result_ = SolverError ("maximum number of iterations reached",
+				   lastState (cost));
+	    return;
+	  }
+
+	if (!computeStep (damping))
+	  {
+	    damping *= factor;
+	    factor *= 2.;
+	    continue;
+	  }
+
+	// Project the trial point, the step is the projected one.
+	candidate_ = x_ + step_;
+	project (candidate_);
+	step_ = candidate_ - x_;
+	if (step_.norm () <= xtol * (x_.norm () + xtol))
+	  {
+	    result_ = lastState (cost);
+	    return;
+	  }
+
+	predicted_.noalias () = jacobian_ * step_;
+	predicted_ += residuals_;
+	const value_type predictedDecrease = cost - predicted_.squaredNorm ();
+
+	(*base_) (candidateResiduals_, candidate_);
+	const value_type candidateCost = candidateResiduals_.squaredNorm ();
+
+	const value_type ratio = predictedDecrease > 0.
+	  ? (cost - candidateCost) / predictedDecrease : -1.;
+	if (ratio > 0.)
+	  {
+	    const bool converged =
+	      cost - candidateCost <= parameter (costTolerance_) * cost;
+
+	    x_.swap (candidate_);
+	    residuals_.swap (candidateResiduals_);
+	    cost = candidateCost;
+	    computeJacobian ();
+	    buildNormal ();
+
+	    damping *= std::max (1. / 3., 1. - std::pow (2. * ratio - 1., 3));
+	    factor = 2.;
+
+	    if (converged)
+	      {
+		result_ = lastState (cost);
+		return;
+	      }
+	  }
+	else
+	  {
+	    damping *= factor;
+	    factor *= 2.;
+	  }
+      }
+  }
+
+  void
+  LevenbergMarquardtSolver::allocateWorkspaces () throw ()
+  {
+    const size_type m = jacobian_.rows ();
+    const size_type n = jacobian_.cols ();
+
+    if (qr_)
+      {
+	if (augmented_.rows () != m + n || augmented_.cols () != n)
+	  {
+	    augmented_.resize (m + n, n);
+	    augmentedRhs_.resize (m + n);
+	    householder_ = Eigen::HouseholderQR<matrix_t> (m + n, n);
+	  }
+	return;
+      }
+
+    if (sparse_)
+      {
+	if (sparseIdentity_.rows () != n)
+	  {
+	    sparseIdentity_.resize (n, n);
+	    sparseIdentity_.setIdentity ();
+	  }
+	return;
+      }
+
+    if (normal_.rows () != n)
+      {
+	normal_.resize (n, n);
+	damped_.resize (n, n);
+	ldlt_ = Eigen::LDLT<matrix_t> (n);
+      }
+  }
+
+  void
+  LevenbergMarquardtSolver::computeJacobian () throw ()
+  {
+    base_->jacobian (jacobian_, x_);
+    gradient_.noalias () = jacobian_.transpose () * residuals_;
+
+    // Variables on a bound the gradient pushes against are fixed:
+    // removing their column decouples them from the step (which is
+    // zero for them) and the gradient becomes the projected gradient.
+    const problem_t::intervals_t& bounds = problem ().argumentBounds ();
+    for (size_type i = 0; i < x_.size (); ++i)
+      if ((x_[i] <= bounds[i].first && gradient_[i] > 0.)
+	  || (x_[i] >= bounds[i].second && gradient_[i] < 0.))
+	{
+	  jacobian_.col (i).setZero ();
+	  gradient_[i] = 0.;
+	}
+  }
+
+  void
+  LevenbergMarquardtSolver::buildNormal () throw ()
+  {
+    // The QR path works on the jacobian directly.
+    if (qr_)
+      return;
+
+    if (sparse_)
+      {
+	if (!updateSparseJacobian ())
+	  buildSparsePattern ();
+
+	// J^T J values, computed on the fixed pattern.
+	size_type k = 0;
+	for (size_type j = 0; j < sparseDamped_.outerSize (); ++j)
+	  for (sparseMatrix_t::InnerIterator it (sparseDamped_, j); it; ++it)
+	    sparseNormal_[k++] = sparseJacobian_.col (it.row ()).dot
+	      (sparseJacobian_.col (j));
+	return;
+      }
+
+    // Only the lower part is used by the factorization.
+    normal_.setZero ();
+    normal_.selfadjointView<Eigen::Lower> ()
+      .rankUpdate (jacobian_.transpose ());
+  }
+
+  void
+  LevenbergMarquardtSolver::buildSparsePattern () throw ()
+  {
+    sparseJacobian_ = jacobian_.sparseView ();
+    sparseJacobian_.makeCompressed ();
+
+    // The identity keeps the whole diagonal in the pattern.
+    sparseDamped_ = sparseJacobian_.transpose () * sparseJacobian_
+      + sparseIdentity_;
+    sparseDamped_.makeCompressed ();
+    sparseNormal_.resize (sparseDamped_.nonZeros ());
+
+    diagonal_.resize (static_cast<std::size_t> (sparseDamped_.outerSize ()));
+    for (size_type j = 0; j < sparseDamped_.outerSize (); ++j)
+      for (sparseMatrix_t::InnerIterator it (sparseDamped_, j); it; ++it)
+	if (it.row () == j)
+	  diagonal_[static_cast<std::size_t> (j)] =
+	    &it.valueRef () - sparseDamped_.valuePtr ();
+
+    sparseLdlt_.analyzePattern (sparseDamped_);
+  }
+
+  bool
+  LevenbergMarquardtSolver::updateSparseJacobian () throw ()
+  {
+    // Entries which became zero are kept as explicit zeros.
+    size_type covered = 0;
+    for (size_type j = 0; j < sparseJacobian_.outerSize (); ++j)
+      for (sparseMatrix_t::InnerIterator it (sparseJacobian_, j); it; ++it)
+	{
+	  it.valueRef () = jacobian_ (it.row (), j);
+	  if (it.value () != 0.)
+	    ++covered;
+	}
+    return covered == (jacobian_.array () != 0.).count ();
+  }
+
+  bool
+  LevenbergMarquardtSolver::computeStep (value_type damping) throw ()
+  {
+    if (qr_)
+      return denseQrStep (damping);
+    if (sparse_)
+      return sparseCholeskyStep (damping);
+    return denseCholeskyStep (damping);
+  }
+
+  bool
+  LevenbergMarquardtSolver::denseCholeskyStep (value_type damping) throw ()
+  {
+    damped_ = normal_;
+    damped_.diagonal ().array () += damping;
+    ldlt_.compute (damped_);
+    if (ldlt_.info () != Eigen::Success)
+      return false;
+
+    step_ = -gradient_;
+    ldlt_.solveInPlace (step_);
+    return true;
+  }
+
+  bool
+  LevenbergMarquardtSolver::denseQrStep (value_type damping) throw ()
+  {
+    const size_type m = jacobian_.rows ();
+    const size_type n = jacobian_.cols ();
+
+    augmented_.topRows (m) = jacobian_;
+    augmented_.bottomRows (n).setZero ();
+    augmented_.bottomRows (n).diagonal ().setConstant (std::sqrt (damping));
+    augmentedRhs_.head (m) = -residuals_;
+    augmentedRhs_.tail (n).setZero ();
+
+    householder_.compute (augmented_);
+    step_ = householder_.solve (augmentedRhs_);
+    return allFinite (step_);
+  }
+
+  bool
+  LevenbergMarquardtSolver::sparseCholeskyStep (value_type damping) throw ()
+  {
+    // Only the values change: the symbolic factorization computed
+    // with the pattern stays valid.
+    Eigen::Map<vector_t> (sparseDamped_.valuePtr (), sparseNormal_.size ())
+      = sparseNormal_;
+    for (std::size_t j = 0; j < diagonal_.size (); ++j)
+      sparseDamped_.valuePtr ()[diagonal_[j]] += damping;
+
+    sparseLdlt_.factorize (sparseDamped_);
+    if (sparseLdlt_.info () != Eigen::Success)
+      return false;
+
+    step_ = sparseLdlt_.solve (gradient_);
+    step_ = -step_;
+    return true;
+  }
+
+  void
+  LevenbergMarquardtSolver::project (vector_t& x) const throw ()
+  {
+    const problem_t::intervals_t& bounds = problem ().argumentBounds ();
+    for (size_type i = 0; i < x.size (); ++i)
+      x[i] = std::min (std::max (x[i], bounds[i].first), bounds[i].second);
+  }
+
+  Result
+  LevenbergMarquardtSolver::lastState (value_type cost) const throw ()
+  {
+    Result res (x_.size (), 1);
+    res.x = x_;
+    res.value[0] = cost;
+    return res;
+  }
+
+} // end of namespace roboptim
+
+// When plug-ins are linked statically, entry points are file-local
+// and registered by name.
+#ifdef ROBOPTIM_CORE_STATIC_PLUGINS
+namespace
+#else
+extern "C"
+#endif //! ROBOPTIM_CORE_STATIC_PLUGINS
+{
+  using namespace roboptim;
+  typedef LevenbergMarquardtSolver::parent_t solver_t;
+
+  ROBOPTIM_CORE_PLUGIN_API unsigned getSizeOfProblem ();
+  ROBOPTIM_CORE_PLUGIN_API solver_t* create
+    (const LevenbergMarquardtSolver::problem_t& pb);
+  ROBOPTIM_CORE_PLUGIN_API void destroy (solver_t* p);
+
+  ROBOPTIM_CORE_PLUGIN_API unsigned getSizeOfProblem ()
+  {
+    return sizeof (solver_t::problem_t);
+  }
+
+  ROBOPTIM_CORE_PLUGIN_API solver_t* create
+    (const LevenbergMarquardtSolver::problem_t& pb)
+  {
+    return new LevenbergMarquardtSolver (pb);
+  }
+
+  ROBOPTIM_CORE_PLUGIN_API void destroy (solver_t* p)
+  {
+    delete p;
+  }
+}
+
+#ifdef ROBOPTIM_CORE_STATIC_PLUGINS
+namespace
+{
+  StaticPluginRegistrar registrar
+  ("lm", &getSizeOfProblem, &create, &destroy);
+}
+#endif //! ROBOPTIM_CORE_STATIC_PLUGINS
@@ -0,0 +1,105 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "debug.hh"
+
+#include <roboptim/core/indent.hh>
+#include <roboptim/core/low-rank-quadratic-function.hh>
+#include <roboptim/core/util.hh>
+
+namespace roboptim
+{
+  LowRankQuadraticFunction::LowRankQuadraticFunction (const vector_t& d,
+						      const matrix_t& u,
+						      const vector_t& b)
+    throw ()
+    : QuadraticFunction (d.size (), 1, "low-rank quadratic function"),
+      d_ (d),
+      u_ (u),
+      b_ (b),
+      projection_ (u.cols ())
+  {
+    assert (d.size () == b.size () && u.rows () == d.size ());
+  }
+
+  LowRankQuadraticFunction::~LowRankQuadraticFunction () throw ()
+  {
+  }
+
+  const LowRankQuadraticFunction::vector_t&
+  LowRankQuadraticFunction::diagonal () const throw ()
+  {
+    return d_;
+  }
+
+  const LowRankQuadraticFunction::matrix_t&
+  LowRankQuadraticFunction::U () const throw ()
+  {
+    return u_;
+  }
+
+  const LowRankQuadraticFunction::vector_t&
+  LowRankQuadraticFunction::b () const throw ()
+  {
+    return b_;
+  }
+
+  // 1/2 * (sum (d_i * x_i^2) + |U^T x|^2) + b^T * x
+  void
+  LowRankQuadraticFunction::impl_compute (result_t& result,
+					  const argument_t& argument)
+    const throw ()
+  {
+    projection_.noalias () = u_.transpose () * argument;
+    result (0) = .5 * ((d_.array () * argument.array ().square ()).sum ()
+		       + projection_.squaredNorm ())
+      + b_.dot (argument);
+  }
+
+  // d .* x + U (U^T x) + b
+  void
+  LowRankQuadraticFunction::impl_gradient (gradient_t& gradient,
+					   const argument_t& x,
+					   size_type) const throw ()
+  {
+    projection_.noalias () = u_.transpose () * x;
+    gradient = d_.cwiseProduct (x) + b_;
+    gradient.noalias () += u_ * projection_;
+  }
+
+  // D + U U^T
+  void
+  LowRankQuadraticFunction::impl_hessian (hessian_t& hessian,
+					  const argument_t&,
+					  size_type) const throw ()
+  {
+    hessian.noalias () = u_ * u_.transpose ();
+    hessian.diagonal () += d_;
+  }
+
+  std::ostream&
+  LowRankQuadraticFunction::print (std::ostream& o) const throw ()
+  {
+    return o << "Low-rank quadratic function" << incindent << iendl
+             << "D = " << d_ << iendl
+             << "U = " << u_ << iendl
+             << "B = " << b_
+             << decindent;
+  }
+
+} // end of namespace roboptim
@@ -62,8 +62,7 @@ namespace roboptim
 					const argument_t&,
 					size_type idFunction) const throw ()
   {
-    for (size_type j = 0; j < inputSize (); ++j)
-      gradient[j] = a_ (idFunction, j);
+    gradient = a_.row (idFunction);
   }
 
   std::ostream&
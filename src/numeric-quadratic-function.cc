@@ -32,6 +32,10 @@ namespace roboptim
       buffer_ (b.size ())
   {
     assert (a.rows () == a.cols () && a.cols () == b.size ());
+
+    // Mirror the lower triangular part so that the hessian matches
+    // the value and gradient kernels.
+    a_.triangularView<Eigen::StrictlyUpper> () = a.transpose ();
   }
 
 
@@ -39,6 +43,18 @@ namespace roboptim
   {
   }
 
+  const NumericQuadraticFunction::symmetric_t&
+  NumericQuadraticFunction::A () const throw ()
+  {
+    return a_;
+  }
+
+  const NumericQuadraticFunction::vector_t&
+  NumericQuadraticFunction::b () const throw ()
+  {
+    return b_;
+  }
+
 
   // 1/2 * x^T * A * x + b^T * x
   void
@@ -46,7 +62,7 @@ namespace roboptim
 					  const argument_t& argument)
     const throw ()
   {
-    buffer_.noalias () = a_ * argument;
+    buffer_.noalias () = a_.selfadjointView<Eigen::Lower> () * argument;
     result (0) = .5 * argument.adjoint ()  * buffer_;
     result (0) += b_.adjoint () * argument;
   }
@@ -57,7 +73,7 @@ namespace roboptim
 					   const argument_t& x,
 					   size_type) const throw ()
   {
-    result.noalias () = a_ * x;
+    result.noalias () = a_.selfadjointView<Eigen::Lower> () * x;
     result += b_;
   }
 
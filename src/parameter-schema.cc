@@ -0,0 +1,270 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "debug.hh"
+
+#include <fstream>
+#include <sstream>
+
+#include "roboptim/core/parameter-schema.hh"
+
+namespace roboptim
+{
+  namespace
+  {
+    /// \brief Human-readable name of a parameter type.
+    const char* typeName (int which)
+    {
+      switch (which)
+	{
+	case 0:
+	  return "floating-point";
+	case 1:
+	  return "integer";
+	case 2:
+	  return "string";
+	default:
+	  break;
+	}
+      assert (0);
+      return "unknown";
+    }
+
+    /// \brief Can a value be used for a parameter of a given type?
+    ///
+    /// Integers are accepted for floating-point parameters.
+    bool compatible (int expected, int actual)
+    {
+      return expected == actual || (expected == 0 && actual == 1);
+    }
+
+    /// \brief Convert a value to the expected parameter type.
+    Parameter::parameterValues_t
+    convert (int expected, const Parameter::parameterValues_t& value)
+    {
+      if (expected == 0 && value.which () == 1)
+	return static_cast<Function::value_type> (boost::get<int> (value));
+      return value;
+    }
+
+    /// \brief Strip leading and trailing blanks.
+    std::string trim (const std::string& str)
+    {
+      std::string::size_type begin = str.find_first_not_of (" \t\r");
+      if (begin == std::string::npos)
+	return std::string ();
+      std::string::size_type end = str.find_last_not_of (" \t\r");
+      return str.substr (begin, end - begin + 1);
+    }
+
+    /// \brief Parse a value, the whole string has to be consumed.
+    template <typename T>
+    bool parse (const std::string& str, Parameter::parameterValues_t& value)
+    {
+      std::istringstream stream (str);
+      T result;
+      stream >> result;
+      if (stream.fail () || !stream.eof ())
+	return false;
+      value = result;
+      return true;
+    }
+  } // end of anonymous namespace.
+
+  ParameterSchema::ParameterSchema () throw ()
+    : entries_ (),
+      indices_ ()
+  {
+  }
+
+  ParameterSchema::~ParameterSchema () throw ()
+  {
+  }
+
+  std::size_t
+  ParameterSchema::size () const throw ()
+  {
+    return entries_.size ();
+  }
+
+  const std::vector<ParameterSchema::Entry>&
+  ParameterSchema::entries () const throw ()
+  {
+    return entries_;
+  }
+
+  std::size_t
+  ParameterSchema::index (const std::string& key) const
+    throw (std::runtime_error)
+  {
+    std::map<std::string, std::size_t>::const_iterator it =
+      indices_.find (key);
+    if (it == indices_.end ())
+      throw std::runtime_error ("unknown parameter ``" + key + "''");
+    return it->second;
+  }
+
+  void
+  ParameterSchema::fill (parameters_t& parameters) const throw ()
+  {
+    for (std::vector<Entry>::const_iterator it = entries_.begin ();
+	 it != entries_.end (); ++it)
+      if (parameters.find (it->key) == parameters.end ())
+	parameters[it->key] = it->parameter;
+  }
+
+  void
+  ParameterSchema::validate (const parameters_t& parameters) const
+    throw (std::runtime_error)
+  {
+    std::stringstream errors;
+    for (parameters_t::const_iterator it = parameters.begin ();
+	 it != parameters.end (); ++it)
+      {
+	std::map<std::string, std::size_t>::const_iterator index =
+	  indices_.find (it->first);
+	if (index == indices_.end ())
+	  {
+	    errors << "unknown parameter ``" << it->first << "''; ";
+	    continue;
+	  }
+
+	int expected = entries_[index->second].parameter.value.which ();
+	if (!compatible (expected, it->second.value.which ()))
+	  errors << "parameter ``" << it->first << "'' should be "
+		 << typeName (expected) << " but is "
+		 << typeName (it->second.value.which ()) << "; ";
+      }
+
+    std::string message = errors.str ();
+    if (!message.empty ())
+      throw std::runtime_error
+	("invalid parameters: " + message.substr (0, message.size () - 2));
+  }
+
+  void
+  ParameterSchema::bind (ParameterValues& values,
+			 const parameters_t& parameters) const
+    throw (std::runtime_error)
+  {
+    validate (parameters);
+
+    values.values_.resize (entries_.size ());
+    for (std::size_t i = 0; i < entries_.size (); ++i)
+      {
+	const Parameter::parameterValues_t& defaultValue =
+	  entries_[i].parameter.value;
+	parameters_t::const_iterator it = parameters.find (entries_[i].key);
+	values.values_[i] = it == parameters.end ()
+	  ? defaultValue : convert (defaultValue.which (), it->second.value);
+      }
+  }
+
+  void
+  ParameterSchema::load (parameters_t& parameters,
+			 std::istream& stream) const
+    throw (std::runtime_error)
+  {
+    // Parse in a temporary map: the parameters are left untouched on
+    // error.
+    parameters_t loaded;
+    std::stringstream errors;
+    std::string line;
+    for (unsigned lineno = 1; std::getline (stream, line); ++lineno)
+      {
+	line = trim (line);
+	if (line.empty () || line[0] == '#')
+	  continue;
+
+	std::string::size_type separator = line.find ('=');
+	if (separator == std::string::npos)
+	  {
+	    errors << "line " << lineno << ": missing ``=''; ";
+	    continue;
+	  }
+
+	std::string key = trim (line.substr (0, separator));
+	std::string str = trim (line.substr (separator + 1));
+
+	std::map<std::string, std::size_t>::const_iterator index =
+	  indices_.find (key);
+	if (index == indices_.end ())
+	  {
+	    errors << "line " << lineno << ": unknown parameter ``"
+		   << key << "''; ";
+	    continue;
+	  }
+
+	const Entry& entry = entries_[index->second];
+	Parameter::parameterValues_t value;
+	bool ok = true;
+	switch (entry.parameter.value.which ())
+	  {
+	  case 0:
+	    ok = parse<Function::value_type> (str, value);
+	    break;
+	  case 1:
+	    ok = parse<int> (str, value);
+	    break;
+	  default:
+	    value = str;
+	    break;
+	  }
+	if (!ok)
+	  {
+	    errors << "line " << lineno << ": ``" << str
+		   << "'' is not a valid "
+		   << typeName (entry.parameter.value.which ())
+		   << " value; ";
+	    continue;
+	  }
+
+	parameters_t::iterator it = loaded.find (key);
+	if (it == loaded.end ())
+	  it = loaded.insert (std::make_pair (key, entry.parameter)).first;
+	it->second.value = value;
+      }
+
+    std::string message = errors.str ();
+    if (!message.empty ())
+      throw std::runtime_error
+	("invalid parameters: " + message.substr (0, message.size () - 2));
+
+    for (parameters_t::const_iterator it = loaded.begin ();
+	 it != loaded.end (); ++it)
+      {
+	parameters_t::iterator current = parameters.find (it->first);
+	if (current == parameters.end ())
+	  parameters.insert (*it);
+	else
+	  current->second.value = it->second.value;
+      }
+  }
+
+  void
+  ParameterSchema::load (parameters_t& parameters,
+			 const std::string& filename) const
+    throw (std::runtime_error)
+  {
+    std::ifstream file (filename.c_str ());
+    if (!file)
+      throw std::runtime_error ("failed to open ``" + filename + "''");
+    load (parameters, file);
+  }
+
+} // end of namespace roboptim
@@ -0,0 +1,247 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "debug.hh"
+
+#include <cassert>
+#include <iostream>
+#include <sstream>
+
+#ifndef ROBOPTIM_CORE_NO_DYNAMIC_LOADING
+# include <ltdl.h>
+#endif //! ROBOPTIM_CORE_NO_DYNAMIC_LOADING
+
+#include <boost/thread/once.hpp>
+
+#include "roboptim/core/plugin-registry.hh"
+
+namespace roboptim
+{
+  namespace
+  {
+    boost::once_flag registryFlag = BOOST_ONCE_INIT;
+  } // end of anonymous namespace.
+
+  PluginRegistry* PluginRegistry::instance_ = 0;
+
+  // Without dynamic loading, libltdl is never initialized: only
+  // statically registered plug-ins can be found.
+  PluginRegistry::PluginRegistry () throw ()
+#ifndef ROBOPTIM_CORE_NO_DYNAMIC_LOADING
+    : initialized_ (lt_dlinit () == 0),
+#else
+    : initialized_ (false),
+#endif //! ROBOPTIM_CORE_NO_DYNAMIC_LOADING
+      mutex_ (),
+      modules_ ()
+  {
+  }
+
+  PluginRegistry::~PluginRegistry () throw ()
+  {
+#ifndef ROBOPTIM_CORE_NO_DYNAMIC_LOADING
+    typedef std::map<std::string, Module>::iterator iter_t;
+    for (iter_t it = modules_.begin (); it != modules_.end (); ++it)
+      if (it->second.handle
+	  && lt_dlclose (static_cast<lt_dlhandle> (it->second.handle)))
+	std::cerr << "libltdl failed to close plug-in ``" << it->first
+		  << "'': " << lt_dlerror () << std::endl;
+    modules_.clear ();
+
+    if (initialized_ && lt_dlexit ())
+      std::cerr << "libltdl failed to exit: " << lt_dlerror () << std::endl;
+#else
+    modules_.clear ();
+#endif //! ROBOPTIM_CORE_NO_DYNAMIC_LOADING
+  }
+
+  void
+  PluginRegistry::initialize () throw ()
+  {
+    static PluginRegistry registry;
+    instance_ = &registry;
+  }
+
+  PluginRegistry&
+  PluginRegistry::instance () throw ()
+  {
+    boost::call_once (&PluginRegistry::initialize, registryFlag);
+    return *instance_;
+  }
+
+  PluginRegistry::Module&
+  PluginRegistry::load (const std::string& plugin)
+    throw (std::runtime_error)
+  {
+    std::map<std::string, Module>::iterator it = modules_.find (plugin);
+    if (it != modules_.end ())
+      return it->second;
+
+#ifdef ROBOPTIM_CORE_NO_DYNAMIC_LOADING
+    std::stringstream sserror;
+    sserror << "plug-in ``" << plugin << "'' is not statically linked"
+	    << " and dynamic loading is disabled";
+    throw std::runtime_error (sserror.str ().c_str ());
+#else
+    if (!initialized_)
+      throw std::runtime_error ("failed to initialize libltdl.");
+
+    std::stringstream ss;
+    ss << "roboptim-core-plugin-" << plugin;
+    lt_dlhandle handle = lt_dlopenext (ss.str ().c_str ());
+    if (!handle)
+      {
+	std::stringstream sserror;
+	sserror << "libltdl failed to load plug-in ``"
+		<< ss.str () << "'': " << lt_dlerror ();
+	throw std::runtime_error (sserror.str ().c_str ());
+      }
+
+    Module module;
+    module.handle = handle;
+    module.references = 0;
+
+    // Resolve all the entry points once.
+    const char* names[] = {"getSizeOfProblem", "create", "destroy"};
+    void* symbols[3];
+    for (unsigned i = 0; i < 3; ++i)
+      {
+	symbols[i] = lt_dlsym (handle, names[i]);
+	if (!symbols[i])
+	  {
+	    std::stringstream sserror;
+	    sserror << "libltdl failed to find symbol ``" << names[i]
+		    << "'': " << lt_dlerror ();
+	    lt_dlclose (handle);
+	    throw std::runtime_error (sserror.str ().c_str ());
+	  }
+      }
+
+    // There is no standard way to cast a pointer to object into a
+    // pointer to function, see SolverFactory.
+    union
+    {
+      void* object;
+      unsigned (*function) ();
+    } getSizeOfProblem;
+    getSizeOfProblem.object = symbols[0];
+
+    module.symbols.sizeOfProblem = getSizeOfProblem.function ();
+    module.symbols.create = symbols[1];
+    module.symbols.destroy = symbols[2];
+
+    return modules_[plugin] = module;
+#endif //! ROBOPTIM_CORE_NO_DYNAMIC_LOADING
+  }
+
+  void
+  PluginRegistry::registerPlugin (const std::string& plugin,
+				  const Symbols& symbols) throw ()
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    Module module;
+    module.handle = 0;
+    module.symbols = symbols;
+    module.references = 0;
+
+    // A static plug-in replaces a module which would already have
+    // been loaded dynamically.
+    std::map<std::string, Module>::iterator it = modules_.find (plugin);
+    if (it != modules_.end ())
+      {
+	assert (!it->second.references);
+#ifndef ROBOPTIM_CORE_NO_DYNAMIC_LOADING
+	if (it->second.handle)
+	  lt_dlclose (static_cast<lt_dlhandle> (it->second.handle));
+#endif //! ROBOPTIM_CORE_NO_DYNAMIC_LOADING
+      }
+    modules_[plugin] = module;
+  }
+
+  bool
+  PluginRegistry::isStatic (const std::string& plugin) const throw ()
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    std::map<std::string, Module>::const_iterator it =
+      modules_.find (plugin);
+    return it != modules_.end () && !it->second.handle;
+  }
+
+  PluginRegistry::Symbols
+  PluginRegistry::acquire (const std::string& plugin)
+    throw (std::runtime_error)
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    Module& module = load (plugin);
+    ++module.references;
+    return module.symbols;
+  }
+
+  void
+  PluginRegistry::release (const std::string& plugin) throw ()
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    std::map<std::string, Module>::iterator it = modules_.find (plugin);
+    assert (it != modules_.end ());
+    assert (it->second.references > 0);
+    if (it != modules_.end () && it->second.references > 0)
+      --it->second.references;
+  }
+
+  void
+  PluginRegistry::preload (const std::string& plugin)
+    throw (std::runtime_error)
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    load (plugin);
+  }
+
+  bool
+  PluginRegistry::unload (const std::string& plugin) throw ()
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    std::map<std::string, Module>::iterator it = modules_.find (plugin);
+    if (it == modules_.end () || it->second.references > 0
+	|| !it->second.handle)
+      return false;
+
+#ifndef ROBOPTIM_CORE_NO_DYNAMIC_LOADING
+    if (lt_dlclose (static_cast<lt_dlhandle> (it->second.handle)))
+      std::cerr << "libltdl failed to close plug-in ``" << plugin
+		<< "'': " << lt_dlerror () << std::endl;
+#endif //! ROBOPTIM_CORE_NO_DYNAMIC_LOADING
+    modules_.erase (it);
+    return true;
+  }
+
+  bool
+  PluginRegistry::isLoaded (const std::string& plugin) const throw ()
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    return modules_.find (plugin) != modules_.end ();
+  }
+
+  std::size_t
+  PluginRegistry::references (const std::string& plugin) const throw ()
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    std::map<std::string, Module>::const_iterator it =
+      modules_.find (plugin);
+    return it == modules_.end () ? 0 : it->second.references;
+  }
+
+} // end of namespace roboptim
@@ -0,0 +1,496 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "debug.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "roboptim/core/function.hh"
+#include "roboptim/core/plugin-registry.hh"
+#include "roboptim/core/problem.hh"
+#include "roboptim/core/plugin/qp.hh"
+
+namespace roboptim
+{
+  ActiveSetQpSolver::ActiveSetQpSolver (const problem_t& pb) throw ()
+    : parent_t (pb),
+      error_ (),
+      maxIterations_
+      (declareParameter ("max-iterations",
+			 "maximum number of iterations", 1000)),
+      tolerance_
+      (declareParameter ("qp.tolerance",
+			 "feasibility tolerance (normalized constraints)",
+			 1e-10)),
+      g_ (),
+      a_ (),
+      c_ (0.),
+      llt_ (pb.function ().inputSize ()),
+      inverseFactor_ (),
+      normals_ (pb.function ().inputSize (), 0),
+      bounds_ (),
+      norms_ (),
+      sides_ (),
+      rows_ (0),
+      x_ (pb.function ().inputSize ()),
+      slacks_ (),
+      j_ (),
+      r_ (),
+      active_ (),
+      u_ (),
+      isActive_ (),
+      preferred_ (),
+      d_ (pb.function ().inputSize ()),
+      z_ (pb.function ().inputSize ()),
+      dual_ (pb.function ().inputSize ()),
+      buffer_ (pb.function ().inputSize ())
+  {
+    const size_type n = pb.function ().inputSize ();
+    const vector_t zero = vector_t::Zero (n);
+
+    // Objective: 1/2 x^T G x + a^T x + c.
+    g_ = pb.function ().hessian (zero, 0);
+    a_ = pb.function ().gradient (zero, 0);
+    c_ = pb.function () (zero)[0];
+
+    llt_.compute (g_);
+    if (llt_.info () != Eigen::Success)
+      error_ = "the qp solver requires a positive definite hessian";
+    inverseFactor_.setIdentity (n, n);
+    llt_.matrixU ().solveInPlace (inverseFactor_);
+
+    // Constraints, then argument bounds.
+    for (std::size_t i = 0; i < pb.constraints ().size (); ++i)
+      {
+	const boost::shared_ptr<LinearFunction>& constraint =
+	  boost::get<boost::shared_ptr<LinearFunction> >
+	  (pb.constraints ()[i]);
+	addSides (rows_, constraint->jacobian (zero), (*constraint) (zero),
+		  pb.boundsVector ()[i]);
+	rows_ += constraint->outputSize ();
+      }
+    addSides (rows_, matrix_t::Identity (n, n), zero, pb.argumentBounds ());
+    rows_ += n;
+
+    const std::size_t sides = sides_.size ();
+    slacks_.resize (static_cast<size_type> (sides));
+    j_.resize (n, n);
+    r_.resize (n, n);
+    r_.setZero ();
+    active_.reserve (static_cast<std::size_t> (n));
+    u_.resize (n);
+    isActive_.resize (sides);
+    preferred_.resize (sides);
+  }
+
+  ActiveSetQpSolver::~ActiveSetQpSolver () throw ()
+  {
+  }
+
+  void
+  ActiveSetQpSolver::addSides (size_type row, const matrix_t& a,
+			       const vector_t& b,
+			       const Function::intervals_t& intervals)
+    throw ()
+  {
+    for (size_type i = 0; i < a.rows (); ++i)
+      {
+	const value_type lower = intervals[i].first;
+	const value_type upper = intervals[i].second;
+	const value_type norm = a.row (i).norm ();
+
+	for (int k = 0; k < 2; ++k)
+	  {
+	    const bool equality = lower == upper;
+	    if (k == 0 && lower == -Function::infinity ())
+	      continue;
+	    if (k == 1 && (equality || upper == Function::infinity ()))
+	      continue;
+
+	    // n^T x >= bound, with n = a or -a.
+	    const value_type sign = k == 0 ? 1. : -1.;
+	    const value_type bound = k == 0 ? lower - b[i] : b[i] - upper;
+
+	    // Constant rows are checked once and for all.
+	    if (norm == 0.)
+	      {
+		if (bound > 0. || (equality && bound < 0.))
+		  error_ = "the quadratic program is infeasible";
+		continue;
+	      }
+
+	    const size_type side = normals_.cols ();
+	    normals_.conservativeResize (Eigen::NoChange, side + 1);
+	    normals_.col (side) = sign * a.row (i).transpose ();
+	    bounds_.conservativeResize (side + 1);
+	    bounds_[side] = bound;
+	    norms_.conservativeResize (side + 1);
+	    norms_[side] = norm;
+
+	    Side s;
+	    s.row = row + i;
+	    s.sign = sign;
+	    s.equality = equality;
+	    sides_.push_back (s);
+	  }
+      }
+  }
+
+  void
+  ActiveSetQpSolver::solve () throw ()
+  {
+    if (!error_.empty ())
+      {
+	result_ = SolverError (error_);
+	return;
+      }
+
+    try
+      {
+	bindParameters ();
+      }
+    catch (const std::runtime_error& e)
+      {
+	result_ = SolverError (e.what ());
+	return;
+      }
+
+    const value_type tolerance = parameter (tolerance_);
+    const value_type epsilon = std::numeric_limits<value_type>::epsilon ();
+    const value_type infinity = std::numeric_limits<value_type>::infinity ();
+    const size_type sides = static_cast<size_type> (sides_.size ());
+
+    // Start from the unconstrained minimum.
+    x_ = -a_;
+    llt_.solveInPlace (x_);
+    j_ = inverseFactor_;
+    active_.clear ();
+    std::fill (isActive_.begin (), isActive_.end (), false);
+
+    // Constraints active in the warm start are tried first.
+    std::fill (preferred_.begin (), preferred_.end (), false);
+    if (warmStart ())
+      {
+	const WarmStart& start = *warmStart ();
+	for (std::size_t s = 0; s < sides_.size (); ++s)
+	  if (start.activeSet)
+	    preferred_[s] = std::find (start.activeSet->begin (),
+				       start.activeSet->end (),
+				       sides_[s].row)
+	      != start.activeSet->end ();
+	  else if (start.lambda.size () == rows_)
+	    preferred_[s] = sides_[s].sign * start.lambda[sides_[s].row] > 0.;
+      }
+
+    // Equality constraints are added first, with a full step.
+    for (size_type p = 0; p < sides; ++p)
+      {
+	if (!sides_[p].equality)
+	  continue;
+
+	computeDirections (p);
+	if (z_.norm () <= epsilon * norms_[p])
+	  {
+	    result_ = SolverError
+	      ("the equality constraints are linearly dependent");
+	    return;
+	  }
+
+	const size_type q = static_cast<size_type> (active_.size ());
+	const value_type slack = normals_.col (p).dot (x_) - bounds_[p];
+	const value_type t = -slack / z_.dot (normals_.col (p));
+	x_ += t * z_;
+	u_.head (q) -= t * dual_.head (q);
+	u_[q] = t;
+	addConstraint (p);
+      }
+
+    for (int iteration = 0; ; ++iteration)
+      {
+	slacks_.noalias () = normals_.transpose () * x_;
+	slacks_ -= bounds_;
+
+	if (stopRequested ())
+	  {
+	    interrupt (lastState ());
+	    return;
+	  }
+	if (hasIterationCallback ())
+	  {
+	    const value_type violation = sides
+	      ? std::max (0., -slacks_.minCoeff ()) : 0.;
+	    if (!iterate (SolverState (iteration, x_, cost (), violation,
+				       vector_t ())))
+	      {
+		result_ = SolverError ("the qp solver has been stopped",
+				       lastState ());
+		return;
+	      }
+	  }
+
+	const size_type p = violatedSide (tolerance);
+	if (p == sides)
+	  {
+	    result_ = lastState ();
+	    return;
+	  }
+	if (iteration >= parameter (maxIterations_))
+	  {
+	    result_ = SolverError ("maximum number of iterations reached",
+				   lastState ());
+	    return;
+	  }
+
+	// Make the side p active, possibly dropping other constraints.
+	value_type multiplier = 0.;
+	value_type slack = slacks_[p];
+	while (true)
+	  {
+	    computeDirections (p);
+	    const size_type q = static_cast<size_type> (active_.size ());
+
+	    // Partial step: largest dual step keeping the multipliers
+	    // of the active inequalities non-negative.
+	    value_type t1 = infinity;
+	    size_type k = q;
+	    for (size_type j = 0; j < q; ++j)
+	      if (!sides_[active_[j]].equality && dual_[j] > 0.
+		  && u_[j] / dual_[j] < t1)
+		{
+		  t1 = u_[j] / dual_[j];
+		  k = j;
+		}
+
+	    // Full step: the side p becomes active.
+	    const value_type t2 = z_.norm () > epsilon * norms_[p]
+	      ? -slack / z_.dot (normals_.col (p)) : infinity;
+
+	    if (t1 == infinity && t2 == infinity)
+	      {
+		result_ = SolverError ("the quadratic program is infeasible",
+				       lastState ());
+		return;
+	      }
+
+	    // Dual step only, then drop the blocking constraint.
+	    if (t2 == infinity)
+	      {
+		u_.head (q) -= t1 * dual_.head (q);
+		multiplier += t1;
+		dropConstraint (k);
+		continue;
+	      }
+
+	    const value_type t = std::min (t1, t2);
+	    x_ += t * z_;
+	    u_.head (q) -= t * dual_.head (q);
+	    multiplier += t;
+
+	    if (t2 <= t1)
+	      {
+		u_[q] = multiplier;
+		if (!addConstraint (p))
+		  {
+		    result_ = SolverError
+		      ("the qp solver failed to update the active set",
+		       lastState ());
+		    return;
+		  }
+		break;
+	      }
+
+	    dropConstraint (k);
+	    slack = normals_.col (p).dot (x_) - bounds_[p];
+	  }
+      }
+  }
+
+  void
+  ActiveSetQpSolver::computeDirections (size_type p) throw ()
+  {
+    const size_type n = x_.size ();
+    const size_type q = static_cast<size_type> (active_.size ());
+
+    d_.noalias () = j_.transpose () * normals_.col (p);
+    z_.noalias () = j_.rightCols (n - q) * d_.tail (n - q);
+    dual_.head (q) = d_.head (q);
+    r_.topLeftCorner (q, q).triangularView<Eigen::Upper> ()
+      .solveInPlace (dual_.head (q));
+  }
+
+  bool
+  ActiveSetQpSolver::addConstraint (size_type p) throw ()
+  {
+    const size_type n = x_.size ();
+    const size_type q = static_cast<size_type> (active_.size ());
+
+    // Rotate J so that d = J^T n_p has zeros after its q + 1 first
+    // coefficients, d then becomes the new column of R.
+    for (size_type j = n - 1; j > q; --j)
+      {
+	Eigen::JacobiRotation<value_type> rotation;
+	rotation.makeGivens (d_[j - 1], d_[j], &d_[j - 1]);
+	d_[j] = 0.;
+	j_.applyOnTheRight (j - 1, j, rotation);
+      }
+    if (std::abs (d_[q])
+	<= std::numeric_limits<value_type>::epsilon () * norms_[p])
+      return false;
+
+    r_.col (q).head (q + 1) = d_.head (q + 1);
+    active_.push_back (p);
+    isActive_[static_cast<std::size_t> (p)] = true;
+    return true;
+  }
+
+  void
+  ActiveSetQpSolver::dropConstraint (size_type k) throw ()
+  {
+    const size_type q = static_cast<size_type> (active_.size ());
+
+    isActive_[static_cast<std::size_t> (active_[k])] = false;
+    for (size_type j = k; j + 1 < q; ++j)
+      {
+	active_[j] = active_[j + 1];
+	u_[j] = u_[j + 1];
+	r_.col (j).head (j + 2) = r_.col (j + 1).head (j + 2);
+      }
+    active_.pop_back ();
+
+    // R is now upper Hessenberg from the column k: restore it.
+    for (size_type j = k; j + 1 < q; ++j)
+      {
+	Eigen::JacobiRotation<value_type> rotation;
+	rotation.makeGivens (r_ (j, j), r_ (j + 1, j), &r_ (j, j));
+	r_ (j + 1, j) = 0.;
+	if (j + 2 < q)
+	  r_.block (j, j + 1, 2, q - j - 2)
+	    .applyOnTheLeft (0, 1, rotation.adjoint ());
+	j_.applyOnTheRight (j, j + 1, rotation);
+      }
+  }
+
+  ActiveSetQpSolver::size_type
+  ActiveSetQpSolver::violatedSide (value_type tolerance) const throw ()
+  {
+    const size_type sides = static_cast<size_type> (sides_.size ());
+    size_type best = sides;
+    value_type worst = -tolerance;
+    bool bestPreferred = false;
+
+    // Most violated side, the warm start sides first.
+    for (size_type s = 0; s < sides; ++s)
+      {
+	const std::size_t i = static_cast<std::size_t> (s);
+	if (isActive_[i])
+	  continue;
+	const value_type violation = slacks_[s] / norms_[s];
+	if (violation >= -tolerance)
+	  continue;
+	if ((preferred_[i] && !bestPreferred)
+	    || (preferred_[i] == bestPreferred && violation < worst))
+	  {
+	    best = s;
+	    worst = violation;
+	    bestPreferred = preferred_[i];
+	  }
+      }
+    return best;
+  }
+
+  ActiveSetQpSolver::value_type
+  ActiveSetQpSolver::cost () const throw ()
+  {
+    buffer_.noalias () = g_ * x_;
+    return .5 * x_.dot (buffer_) + a_.dot (x_) + c_;
+  }
+
+  Result
+  ActiveSetQpSolver::lastState () const throw ()
+  {
+    const size_type n = x_.size ();
+    Result res (n, 1);
+    res.x = x_;
+    res.value[0] = cost ();
+
+    res.constraints.resize (rows_ - n);
+    size_type row = 0;
+    for (std::size_t i = 0; i < problem ().constraints ().size (); ++i)
+      {
+	const boost::shared_ptr<LinearFunction>& constraint =
+	  boost::get<boost::shared_ptr<LinearFunction> >
+	  (problem ().constraints ()[i]);
+	res.constraints.segment (row, constraint->outputSize ()) =
+	  (*constraint) (x_);
+	row += constraint->outputSize ();
+      }
+
+    res.lambda.resize (rows_);
+    res.lambda.setZero ();
+    for (std::size_t j = 0; j < active_.size (); ++j)
+      {
+	const Side& side = sides_[static_cast<std::size_t> (active_[j])];
+	res.lambda[side.row] += side.sign * u_[static_cast<size_type> (j)];
+      }
+    return res;
+  }
+
+} // end of namespace roboptim
+
+// When plug-ins are linked statically, entry points are file-local
+// and registered by name.
+#ifdef ROBOPTIM_CORE_STATIC_PLUGINS
+namespace
+#else
+extern "C"
+#endif //! ROBOPTIM_CORE_STATIC_PLUGINS
+{
+  using namespace roboptim;
+  typedef ActiveSetQpSolver::parent_t solver_t;
+
+  ROBOPTIM_CORE_PLUGIN_API unsigned getSizeOfProblem ();
+  ROBOPTIM_CORE_PLUGIN_API solver_t* create
+    (const ActiveSetQpSolver::problem_t& pb);
+  ROBOPTIM_CORE_PLUGIN_API void destroy (solver_t* p);
+
+  ROBOPTIM_CORE_PLUGIN_API unsigned getSizeOfProblem ()
+  {
+    return sizeof (solver_t::problem_t);
+  }
+
+  ROBOPTIM_CORE_PLUGIN_API solver_t* create
+    (const ActiveSetQpSolver::problem_t& pb)
+  {
+    return new ActiveSetQpSolver (pb);
+  }
+
+  ROBOPTIM_CORE_PLUGIN_API void destroy (solver_t* p)
+  {
+    delete p;
+  }
+}
+
+#ifdef ROBOPTIM_CORE_STATIC_PLUGINS
+namespace
+{
+  StaticPluginRegistrar registrar
+  ("qp", &getSizeOfProblem, &create, &destroy);
+}
+#endif //! ROBOPTIM_CORE_STATIC_PLUGINS
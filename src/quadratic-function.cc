@@ -31,6 +31,12 @@ namespace roboptim
   {
   }
 
+  QuadraticFunction::structure_t
+  QuadraticFunction::structure () const throw ()
+  {
+    return QUADRATIC | CONSTANT_HESSIAN;
+  }
+
   std::ostream&
   QuadraticFunction::print (std::ostream& o) const throw ()
   {
@@ -0,0 +1,565 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "debug.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include <boost/cstdint.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "roboptim/core/result-with-warnings.hh"
+#include "roboptim/core/serialization.hh"
+
+namespace roboptim
+{
+  namespace
+  {
+    /// \brief Serialized record header.
+    ///
+    /// Followed by the x, value, constraints and lambda vectors, the
+    /// message and the warnings (length and characters), each field
+    /// being padded to 8 bytes.
+    struct RecordHeader
+    {
+      boost::uint32_t kind;
+      boost::uint32_t hasResult;
+      boost::uint64_t inputSize;
+      boost::uint64_t outputSize;
+      boost::uint64_t sizes[4];
+      boost::uint64_t messageLength;
+      boost::uint64_t warnings;
+    };
+
+    /// \brief Stream and archive header.
+    struct FileHeader
+    {
+      char magic[4];
+      boost::uint32_t version;
+    };
+
+    /// \brief Archive footer.
+    struct ArchiveFooter
+    {
+      boost::uint64_t count;
+      boost::uint64_t indexOffset;
+      FileHeader header;
+    };
+
+    const char resultMagic[4] = {'R', 'B', 'R', 'S'};
+    const char archiveMagic[4] = {'R', 'B', 'R', 'A'};
+
+    std::size_t padding (std::size_t size)
+    {
+      return (size + 7) & ~static_cast<std::size_t> (7);
+    }
+
+    FileHeader makeHeader (const char* magic)
+    {
+      FileHeader header;
+      std::memcpy (header.magic, magic, 4);
+      header.version = resultFormatVersion;
+      return header;
+    }
+
+    void checkHeader (const FileHeader& header, const char* magic)
+    {
+      if (std::memcmp (header.magic, magic, 4))
+	throw std::runtime_error ("invalid serialized data (bad magic)");
+      if (header.version != resultFormatVersion)
+	throw std::runtime_error
+	  ("unsupported serialization version or byte order");
+    }
+
+    void appendRaw (std::vector<char>& buffer, const void* data,
+		    std::size_t size)
+    {
+      const char* bytes = static_cast<const char*> (data);
+      buffer.insert (buffer.end (), bytes, bytes + size);
+      buffer.resize (padding (buffer.size ()), 0);
+    }
+
+    void appendString (std::vector<char>& buffer, const std::string& str)
+    {
+      boost::uint64_t length = str.size ();
+      appendRaw (buffer, &length, sizeof (length));
+      appendRaw (buffer, str.data (), str.size ());
+    }
+
+    /// \brief Serialize a solver outcome into a buffer.
+    void encode (std::vector<char>& buffer,
+		 const GenericSolver::result_t& result)
+    {
+      RecordHeader header;
+      std::memset (&header, 0, sizeof (header));
+      header.kind = result.which ();
+
+      const Result* res = 0;
+      std::string message;
+      const std::vector<SolverWarning>* warnings = 0;
+      switch (result.which ())
+	{
+	case GenericSolver::SOLVER_VALUE:
+	  res = &boost::get<Result> (result);
+	  break;
+	case GenericSolver::SOLVER_VALUE_WARNINGS:
+	  res = &boost::get<ResultWithWarnings> (result);
+	  warnings = &boost::get<ResultWithWarnings> (result).warnings;
+	  break;
+	case GenericSolver::SOLVER_ERROR:
+	  {
+	    const SolverError& error = boost::get<SolverError> (result);
+	    message = error.what ();
+	    if (error.lastState ())
+	      res = &*error.lastState ();
+	  }
+	  break;
+	default:
+	  break;
+	}
+
+      const Result::vector_t* vectors[4] = {0, 0, 0, 0};
+      if (res)
+	{
+	  header.hasResult = 1;
+	  header.inputSize = res->inputSize;
+	  header.outputSize = res->outputSize;
+	  vectors[0] = &res->x;
+	  vectors[1] = &res->value;
+	  vectors[2] = &res->constraints;
+	  vectors[3] = &res->lambda;
+	  for (std::size_t i = 0; i < 4; ++i)
+	    header.sizes[i] = vectors[i]->size ();
+	}
+      header.messageLength = message.size ();
+      header.warnings = warnings ? warnings->size () : 0;
+
+      buffer.clear ();
+      appendRaw (buffer, &header, sizeof (header));
+      for (std::size_t i = 0; i < 4; ++i)
+	if (vectors[i])
+	  appendRaw (buffer, vectors[i]->data (),
+		     vectors[i]->size () * sizeof (Function::value_type));
+      appendRaw (buffer, message.data (), message.size ());
+      if (warnings)
+	for (std::size_t i = 0; i < warnings->size (); ++i)
+	  appendString (buffer, (*warnings)[i].what ());
+    }
+
+    /// \brief Padded size of a serialized field.
+    ///
+    /// Sizes come from untrusted data: they are checked against the
+    /// remaining record bytes before any multiplication.
+    ///
+    /// \param count number of elements
+    /// \param elementSize size of an element
+    /// \param remaining number of record bytes left
+    std::size_t fieldSize (boost::uint64_t count, std::size_t elementSize,
+			   std::size_t remaining)
+    {
+      if (count > remaining / elementSize)
+	throw std::runtime_error ("invalid serialized result (truncated)");
+      const std::size_t size =
+	padding (static_cast<std::size_t> (count) * elementSize);
+      if (size > remaining)
+	throw std::runtime_error ("invalid serialized result (truncated)");
+      return size;
+    }
+  } // end of anonymous namespace.
+
+  void
+  writeResult (std::ostream& o, const GenericSolver::result_t& result)
+    throw (std::runtime_error)
+  {
+    std::vector<char> buffer;
+    encode (buffer, result);
+
+    FileHeader header = makeHeader (resultMagic);
+    boost::uint64_t size = buffer.size ();
+    o.write (reinterpret_cast<const char*> (&header), sizeof (header));
+    o.write (reinterpret_cast<const char*> (&size), sizeof (size));
+    if (!buffer.empty ())
+      o.write (&buffer[0], buffer.size ());
+    if (!o)
+      throw std::runtime_error ("failed to write result");
+  }
+
+  GenericSolver::result_t
+  readResult (std::istream& i) throw (std::runtime_error)
+  {
+    FileHeader header;
+    boost::uint64_t size = 0;
+    i.read (reinterpret_cast<char*> (&header), sizeof (header));
+    i.read (reinterpret_cast<char*> (&size), sizeof (size));
+    if (!i)
+      throw std::runtime_error ("failed to read result");
+    checkHeader (header, resultMagic);
+    if (size < sizeof (RecordHeader))
+      throw std::runtime_error ("invalid serialized result (truncated)");
+
+    // Use 8 bytes words to keep the vectors aligned. The size is not
+    // trusted: the buffer only grows as data are actually read.
+    const std::size_t chunk = 1 << 16;
+    std::vector<boost::uint64_t> buffer;
+    boost::uint64_t read = 0;
+    while (read < size)
+      {
+	const std::size_t length = static_cast<std::size_t>
+	  (std::min<boost::uint64_t> (size - read, chunk));
+	buffer.resize (static_cast<std::size_t> (read + length + 7) / 8);
+	i.read (reinterpret_cast<char*> (&buffer[0]) + read, length);
+	if (!i)
+	  throw std::runtime_error ("failed to read result");
+	read += length;
+      }
+    return ResultView (reinterpret_cast<const char*> (&buffer[0]),
+		       static_cast<std::size_t> (size)).result ();
+  }
+
+  ResultView::ResultView (const char* data, std::size_t size)
+    throw (std::runtime_error)
+    : data_ (data),
+      warnings_ ()
+  {
+    if (size < sizeof (RecordHeader))
+      throw std::runtime_error ("invalid serialized result (truncated)");
+    const RecordHeader& header =
+      *reinterpret_cast<const RecordHeader*> (data);
+    if (header.kind > GenericSolver::SOLVER_ERROR)
+      throw std::runtime_error ("invalid serialized result");
+    // Results are built from the sizes: they must match the vectors.
+    if (header.hasResult
+	&& (header.inputSize != header.sizes[0]
+	    || header.outputSize != header.sizes[1]))
+      throw std::runtime_error ("invalid serialized result");
+
+    // Each field has to fit in the remaining bytes.
+    std::size_t offset = padding (sizeof (RecordHeader));
+    for (std::size_t i = 0; i < 4; ++i)
+      {
+	offsets_[i] = offset;
+	offset += fieldSize
+	  (header.sizes[i], sizeof (Function::value_type), size - offset);
+      }
+    offsets_[4] = offset;
+    offset += fieldSize (header.messageLength, 1, size - offset);
+
+    for (boost::uint64_t i = 0; i < header.warnings; ++i)
+      {
+	if (size - offset < sizeof (boost::uint64_t))
+	  throw std::runtime_error ("invalid serialized result (truncated)");
+	warnings_.push_back (offset);
+	boost::uint64_t length =
+	  *reinterpret_cast<const boost::uint64_t*> (data + offset);
+	offset += sizeof (boost::uint64_t);
+	offset += fieldSize (length, 1, size - offset);
+      }
+  }
+
+  GenericSolver::solutions
+  ResultView::kind () const throw ()
+  {
+    return static_cast<GenericSolver::solutions>
+      (reinterpret_cast<const RecordHeader*> (data_)->kind);
+  }
+
+  bool
+  ResultView::hasResult () const throw ()
+  {
+    return reinterpret_cast<const RecordHeader*> (data_)->hasResult;
+  }
+
+  ResultView::size_type
+  ResultView::inputSize () const throw ()
+  {
+    return static_cast<size_type>
+      (reinterpret_cast<const RecordHeader*> (data_)->inputSize);
+  }
+
+  ResultView::size_type
+  ResultView::outputSize () const throw ()
+  {
+    return static_cast<size_type>
+      (reinterpret_cast<const RecordHeader*> (data_)->outputSize);
+  }
+
+  ResultView::vectorView_t
+  ResultView::vector (std::size_t i) const throw ()
+  {
+    const RecordHeader& header =
+      *reinterpret_cast<const RecordHeader*> (data_);
+    return vectorView_t
+      (reinterpret_cast<const value_type*> (data_ + offsets_[i]),
+       static_cast<size_type> (header.sizes[i]));
+  }
+
+  ResultView::vectorView_t
+  ResultView::x () const throw ()
+  {
+    return vector (0);
+  }
+
+  ResultView::vectorView_t
+  ResultView::value () const throw ()
+  {
+    return vector (1);
+  }
+
+  ResultView::vectorView_t
+  ResultView::constraints () const throw ()
+  {
+    return vector (2);
+  }
+
+  ResultView::vectorView_t
+  ResultView::lambda () const throw ()
+  {
+    return vector (3);
+  }
+
+  std::string
+  ResultView::message () const throw ()
+  {
+    const RecordHeader& header =
+      *reinterpret_cast<const RecordHeader*> (data_);
+    return std::string (data_ + offsets_[4], header.messageLength);
+  }
+
+  std::size_t
+  ResultView::warnings () const throw ()
+  {
+    return warnings_.size ();
+  }
+
+  std::string
+  ResultView::warning (std::size_t i) const throw ()
+  {
+    assert (i < warnings_.size ());
+    const char* data = data_ + warnings_[i];
+    boost::uint64_t length = *reinterpret_cast<const boost::uint64_t*> (data);
+    return std::string (data + sizeof (boost::uint64_t), length);
+  }
+
+  GenericSolver::result_t
+  ResultView::result () const throw ()
+  {
+    switch (kind ())
+      {
+      case GenericSolver::SOLVER_VALUE:
+	{
+	  Result res (inputSize (), outputSize ());
+	  res.x = x ();
+	  res.value = value ();
+	  res.constraints = constraints ();
+	  res.lambda = lambda ();
+	  return res;
+	}
+      case GenericSolver::SOLVER_VALUE_WARNINGS:
+	{
+	  ResultWithWarnings res (inputSize (), outputSize ());
+	  res.x = x ();
+	  res.value = value ();
+	  res.constraints = constraints ();
+	  res.lambda = lambda ();
+	  for (std::size_t i = 0; i < warnings (); ++i)
+	    res.warnings.push_back (SolverWarning (warning (i)));
+	  return res;
+	}
+      case GenericSolver::SOLVER_ERROR:
+	{
+	  if (!hasResult ())
+	    return SolverError (message ());
+	  Result res (inputSize (), outputSize ());
+	  res.x = x ();
+	  res.value = value ();
+	  res.constraints = constraints ();
+	  res.lambda = lambda ();
+	  return SolverError (message (), res);
+	}
+      default:
+	break;
+      }
+    return NoSolution ();
+  }
+
+  struct ResultArchiveWriter::Impl
+  {
+    std::ofstream file;
+    std::vector<boost::uint64_t> offsets;
+    std::vector<char> buffer;
+    boost::uint64_t offset;
+  };
+
+  ResultArchiveWriter::ResultArchiveWriter (const std::string& filename)
+    throw (std::runtime_error)
+    : impl_ (new Impl ())
+  {
+    impl_->file.open (filename.c_str (),
+		      std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!impl_->file)
+      throw std::runtime_error ("failed to create ``" + filename + "''");
+
+    FileHeader header = makeHeader (archiveMagic);
+    impl_->file.write (reinterpret_cast<const char*> (&header),
+		       sizeof (header));
+    impl_->offset = sizeof (header);
+  }
+
+  ResultArchiveWriter::~ResultArchiveWriter () throw ()
+  {
+    try
+      {
+	close ();
+      }
+    catch (...)
+      {
+      }
+  }
+
+  void
+  ResultArchiveWriter::append (const GenericSolver::result_t& result)
+    throw (std::runtime_error)
+  {
+    if (!impl_->file.is_open ())
+      throw std::runtime_error ("archive is closed");
+
+    encode (impl_->buffer, result);
+    impl_->file.write (&impl_->buffer[0], impl_->buffer.size ());
+    if (!impl_->file)
+      throw std::runtime_error ("failed to write result");
+
+    impl_->offsets.push_back (impl_->offset);
+    impl_->offset += impl_->buffer.size ();
+  }
+
+  std::size_t
+  ResultArchiveWriter::size () const throw ()
+  {
+    return impl_->offsets.size ();
+  }
+
+  void
+  ResultArchiveWriter::close () throw (std::runtime_error)
+  {
+    if (!impl_->file.is_open ())
+      return;
+
+    // Index: record offsets, followed by the end of the last record.
+    impl_->offsets.push_back (impl_->offset);
+    ArchiveFooter footer;
+    footer.count = impl_->offsets.size () - 1;
+    footer.indexOffset = impl_->offset;
+    footer.header = makeHeader (archiveMagic);
+
+    impl_->file.write
+      (reinterpret_cast<const char*> (&impl_->offsets[0]),
+       impl_->offsets.size () * sizeof (boost::uint64_t));
+    impl_->file.write (reinterpret_cast<const char*> (&footer),
+		       sizeof (footer));
+    impl_->file.close ();
+    if (!impl_->file)
+      throw std::runtime_error ("failed to write archive index");
+  }
+
+  struct ResultArchive::Impl
+  {
+    boost::interprocess::file_mapping file;
+    boost::interprocess::mapped_region region;
+    const char* data;
+    const boost::uint64_t* index;
+    std::size_t count;
+  };
+
+  ResultArchive::ResultArchive (const std::string& filename)
+    throw (std::runtime_error)
+    : impl_ (new Impl ())
+  {
+    using namespace boost::interprocess;
+    try
+      {
+	file_mapping (filename.c_str (), read_only).swap (impl_->file);
+	mapped_region (impl_->file, read_only).swap (impl_->region);
+      }
+    catch (const interprocess_exception& e)
+      {
+	throw std::runtime_error ("failed to map ``" + filename + "'': "
+				  + e.what ());
+      }
+
+    impl_->data = static_cast<const char*> (impl_->region.get_address ());
+    std::size_t size = impl_->region.get_size ();
+    if (size < sizeof (FileHeader) + sizeof (ArchiveFooter))
+      throw std::runtime_error ("invalid archive (truncated)");
+
+    checkHeader (*reinterpret_cast<const FileHeader*> (impl_->data),
+		 archiveMagic);
+    const ArchiveFooter& footer = *reinterpret_cast<const ArchiveFooter*>
+      (impl_->data + size - sizeof (ArchiveFooter));
+    checkHeader (footer.header, archiveMagic);
+
+    // The index (count + 1 offsets) lies between the records and the
+    // footer. Sizes are checked before any multiplication.
+    const std::size_t end = size - sizeof (ArchiveFooter);
+    if (footer.indexOffset < sizeof (FileHeader)
+	|| footer.indexOffset > end
+	|| footer.indexOffset % 8
+	|| footer.count >= (end - footer.indexOffset) / sizeof (boost::uint64_t)
+	|| footer.indexOffset
+	+ (footer.count + 1) * sizeof (boost::uint64_t) != end)
+      throw std::runtime_error ("invalid archive index");
+    impl_->index = reinterpret_cast<const boost::uint64_t*>
+      (impl_->data + footer.indexOffset);
+    impl_->count = static_cast<std::size_t> (footer.count);
+
+    // Records are aligned, non-empty, ordered and end at the index.
+    if (impl_->index[0] != sizeof (FileHeader)
+	|| impl_->index[impl_->count] != footer.indexOffset)
+      throw std::runtime_error ("invalid archive index");
+    for (std::size_t i = 0; i < impl_->count; ++i)
+      if (impl_->index[i] % 8
+	  || impl_->index[i + 1] > footer.indexOffset
+	  || impl_->index[i + 1] < impl_->index[i] + sizeof (RecordHeader))
+	throw std::runtime_error ("invalid archive index");
+  }
+
+  ResultArchive::~ResultArchive () throw ()
+  {
+  }
+
+  std::size_t
+  ResultArchive::size () const throw ()
+  {
+    return impl_->count;
+  }
+
+  ResultView
+  ResultArchive::operator[] (std::size_t i) const throw (std::runtime_error)
+  {
+    if (i >= impl_->count)
+      throw std::runtime_error ("invalid record index");
+    // The index has been validated when the archive was mapped.
+    const boost::uint64_t begin = impl_->index[i];
+    const boost::uint64_t end = impl_->index[i + 1];
+    return ResultView (impl_->data + begin,
+		       static_cast<std::size_t> (end - begin));
+  }
+
+} // end of namespace roboptim
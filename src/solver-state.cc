@@ -0,0 +1,73 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "debug.hh"
+
+#include <iostream>
+
+#include <roboptim/core/indent.hh>
+#include <roboptim/core/solver-state.hh>
+#include <roboptim/core/util.hh>
+
+namespace roboptim
+{
+  SolverState::SolverState (size_type iteration_,
+			    const value_type* x_,
+			    size_type inputSize,
+			    value_type cost_,
+			    value_type constraintViolation_,
+			    const value_type* lambda_,
+			    size_type lambdaSize) throw ()
+    : iteration (iteration_),
+      x (x_, inputSize),
+      cost (cost_),
+      constraintViolation (constraintViolation_),
+      lambda (lambda_, lambda_ ? lambdaSize : 0)
+  {
+  }
+
+  SolverState::SolverState (size_type iteration_,
+			    const vector_t& x_,
+			    value_type cost_,
+			    value_type constraintViolation_,
+			    const vector_t& lambda_) throw ()
+    : iteration (iteration_),
+      x (x_.data (), x_.size ()),
+      cost (cost_),
+      constraintViolation (constraintViolation_),
+      lambda (lambda_.data (), lambda_.size ())
+  {
+  }
+
+  std::ostream&
+  SolverState::print (std::ostream& o) const throw ()
+  {
+    return o << "Iteration " << iteration << ":" << incindent << iendl
+	     << "X: " << x << iendl
+	     << "Cost: " << cost << iendl
+	     << "Constraints violation: " << constraintViolation << iendl
+	     << "Lambda: " << lambda
+	     << decindent;
+  }
+
+  std::ostream& operator<< (std::ostream& o, const SolverState& state)
+  {
+    return state.print (o);
+  }
+
+} // end of namespace roboptim
@@ -0,0 +1,95 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "debug.hh"
+
+#include <roboptim/core/indent.hh>
+#include <roboptim/core/sparse-numeric-linear-function.hh>
+#include <roboptim/core/util.hh>
+
+namespace roboptim
+{
+  SparseNumericLinearFunction::SparseNumericLinearFunction
+  (const sparseMatrix_t& a, const vector_t& b) throw ()
+    : LinearFunction (a.cols (), a.rows (), "sparse numeric linear function"),
+      a_ (a),
+      b_ (b)
+  {
+    assert (b.size () == outputSize ());
+    a_.makeCompressed ();
+  }
+
+  SparseNumericLinearFunction::~SparseNumericLinearFunction () throw ()
+  {
+  }
+
+  const SparseNumericLinearFunction::sparseMatrix_t&
+  SparseNumericLinearFunction::A () const throw ()
+  {
+    return a_;
+  }
+
+  const SparseNumericLinearFunction::vector_t&
+  SparseNumericLinearFunction::b () const throw ()
+  {
+    return b_;
+  }
+
+  // A * x + b
+  void
+  SparseNumericLinearFunction::impl_compute (result_t& result,
+					     const argument_t& argument)
+    const throw ()
+  {
+    result.noalias () = a_ * argument;
+    result += b_;
+  }
+
+  // A
+  void
+  SparseNumericLinearFunction::impl_jacobian (jacobian_t& jacobian,
+					      const argument_t&) const throw ()
+  {
+    jacobian.setZero ();
+    for (sparseMatrix_t::Index i = 0; i < a_.outerSize (); ++i)
+      for (sparseMatrix_t::InnerIterator it (a_, i); it; ++it)
+	jacobian (it.row (), it.col ()) = it.value ();
+  }
+
+  // A(i)
+  void
+  SparseNumericLinearFunction::impl_gradient (gradient_t& gradient,
+					      const argument_t&,
+					      size_type idFunction)
+    const throw ()
+  {
+    gradient.setZero ();
+    for (sparseMatrix_t::InnerIterator it (a_, idFunction); it; ++it)
+      gradient[it.col ()] = it.value ();
+  }
+
+  std::ostream&
+  SparseNumericLinearFunction::print (std::ostream& o) const throw ()
+  {
+    return o << "Sparse numeric linear function" << incindent << iendl
+             << "A = " << a_.rows () << "x" << a_.cols ()
+             << " sparse matrix (" << a_.nonZeros () << " non-zeros)" << iendl
+             << "B = " << b_
+             << decindent;
+  }
+
+} // end of namespace roboptim
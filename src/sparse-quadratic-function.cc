@@ -0,0 +1,101 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "debug.hh"
+
+#include <roboptim/core/indent.hh>
+#include <roboptim/core/sparse-quadratic-function.hh>
+#include <roboptim/core/util.hh>
+
+namespace roboptim
+{
+  SparseQuadraticFunction::SparseQuadraticFunction (const sparseMatrix_t& a,
+						    const vector_t& b)
+    throw ()
+    : QuadraticFunction (a.rows (), 1, "sparse quadratic function"),
+      a_ (a),
+      b_ (b),
+      buffer_ (b.size ())
+  {
+    assert (a.rows () == a.cols () && a.cols () == b.size ());
+    a_.makeCompressed ();
+  }
+
+  SparseQuadraticFunction::~SparseQuadraticFunction () throw ()
+  {
+  }
+
+  const SparseQuadraticFunction::sparseMatrix_t&
+  SparseQuadraticFunction::A () const throw ()
+  {
+    return a_;
+  }
+
+  const SparseQuadraticFunction::vector_t&
+  SparseQuadraticFunction::b () const throw ()
+  {
+    return b_;
+  }
+
+  // 1/2 * x^T * A * x + b^T * x
+  void
+  SparseQuadraticFunction::impl_compute (result_t& result,
+					 const argument_t& argument)
+    const throw ()
+  {
+    buffer_.noalias () = a_.selfadjointView<Eigen::Lower> () * argument;
+    result (0) = .5 * argument.dot (buffer_) + b_.dot (argument);
+  }
+
+  // A * x + b
+  void
+  SparseQuadraticFunction::impl_gradient (gradient_t& gradient,
+					  const argument_t& x,
+					  size_type) const throw ()
+  {
+    gradient.noalias () = a_.selfadjointView<Eigen::Lower> () * x;
+    gradient += b_;
+  }
+
+  // A
+  void
+  SparseQuadraticFunction::impl_hessian (hessian_t& hessian,
+					 const argument_t&,
+					 size_type) const throw ()
+  {
+    hessian.setZero ();
+    for (sparseMatrix_t::Index k = 0; k < a_.outerSize (); ++k)
+      for (sparseMatrix_t::InnerIterator it (a_, k); it; ++it)
+	if (it.row () >= it.col ())
+	  {
+	    hessian (it.row (), it.col ()) = it.value ();
+	    hessian (it.col (), it.row ()) = it.value ();
+	  }
+  }
+
+  std::ostream&
+  SparseQuadraticFunction::print (std::ostream& o) const throw ()
+  {
+    return o << "Sparse quadratic function" << incindent << iendl
+             << "A = " << a_.rows () << "x" << a_.cols ()
+             << " sparse matrix (" << a_.nonZeros () << " non-zeros)" << iendl
+             << "B = " << b_
+             << decindent;
+  }
+
+} // end of namespace roboptim
@@ -25,21 +25,29 @@ namespace roboptim {
   SumOfC1Squares::SumOfC1Squares (const boost::shared_ptr<DifferentiableFunction>&
 				  function,
 				  const std::string& name) throw () :
-    DifferentiableFunction(function->inputSize(), 1, name),
+    TwiceDifferentiableFunction(function->inputSize(), 1, name),
     baseFunction_ (function)
   {
     value_.resize (function->outputSize());
-    gradient_.resize (function->inputSize());
     x_.resize (function->inputSize());
     x_.setZero ();
     (*baseFunction_) (value_, x_);
+    jacobianX_.resize (function->inputSize());
+    jacobianValid_ = false;
+    jacobian_.resize (function->outputSize(), function->inputSize());
+    // The hessian buffer is allocated by the first hessian request.
+    hessianValid_ = false;
   }
     
   SumOfC1Squares::SumOfC1Squares (const SumOfC1Squares& src) throw ():
-    DifferentiableFunction(src.inputSize(), 1, src.getName()),
+    TwiceDifferentiableFunction(src.inputSize(), 1, src.getName()),
     baseFunction_ (src.baseFunction_), x_ (src.x_),
     value_ (src.value_),
-    gradient_ (src.gradient_)
+    jacobianX_ (src.jacobianX_),
+    jacobianValid_ (src.jacobianValid_),
+    jacobian_ (src.jacobian_),
+    hessianValid_ (src.hessianValid_),
+    hessian_ (src.hessian_)
   {
   }
 
@@ -56,42 +64,65 @@ namespace roboptim {
   void SumOfC1Squares::
   impl_compute(result_t &result, const argument_t &x) const throw ()
   {
-#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
-      Eigen::internal::set_is_malloc_allowed (true);
-#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
-
     computeFunction (x);
-    value_t sumSquares = 0;
-    for (size_t i = 0; i < value_.size(); i++) {
-      value_t y = value_[i];
-      sumSquares += y*y;
-    }
-    result[0] = sumSquares;
+    result[0] = value_.squaredNorm ();
   }
 
   void SumOfC1Squares::
   impl_gradient(gradient_t& gradient, const argument_t& x,
 		size_type ROBOPTIM_DEBUG_ONLY (row)) const throw ()
   {
+    assert (row == 0);
+    computeFunction (x);
+    computeJacobian (x);
+    gradient.noalias () = 2. * jacobian_.transpose () * value_;
+  }
+
+  void SumOfC1Squares::
+  impl_hessian(hessian_t& hessian, const argument_t& x,
+	       size_type ROBOPTIM_DEBUG_ONLY (row)) const throw ()
+  {
+    assert (row == 0);
+    computeJacobian (x);
+    if (!hessianValid_) {
+      // The hessian buffer allocation and the rank update blocking
+      // workspace are the only allocations of this method.
 #ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      const bool mallocAllowed = Eigen::internal::is_malloc_allowed ();
       Eigen::internal::set_is_malloc_allowed (true);
 #endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      hessian_.resize (inputSize (), inputSize ());
 
-    assert (row == 0);
-    computeFunction (x);
-    gradient.setZero ();
-    for (size_t i = 0; i < value_.size(); i++) {
-      value_t y = value_[i];
-      baseFunction_->gradient(gradient_, x, i);
-      gradient += 2*y*gradient_;
+      // Only the lower triangular part is updated, then mirrored.
+      hessian_.setZero ();
+      hessian_.selfadjointView<Eigen::Lower> ()
+	.rankUpdate (jacobian_.transpose (), 2.);
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      Eigen::internal::set_is_malloc_allowed (mallocAllowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      for (size_type j = 1; j < hessian_.cols (); ++j)
+	for (size_type i = 0; i < j; ++i)
+	  hessian_ (i, j) = hessian_ (j, i);
+      hessianValid_ = true;
     }
+    hessian = hessian_;
   }
 
-  void SumOfC1Squares::computeFunction (const argument_t x) const
+  void SumOfC1Squares::computeFunction (const argument_t& x) const
   {
     if (x != x_) {
       x_ = x;
       (*baseFunction_) (value_, x_);
     }
   }
+
+  void SumOfC1Squares::computeJacobian (const argument_t& x) const
+  {
+    if (!jacobianValid_ || x != jacobianX_) {
+      jacobianX_ = x;
+      baseFunction_->jacobian (jacobian_, jacobianX_);
+      jacobianValid_ = true;
+      hessianValid_ = false;
+    }
+  }
 } // namespace roboptim
@@ -0,0 +1,366 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "debug.hh"
+
+#include <algorithm>
+#include <deque>
+
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+
+#include "roboptim/core/thread-pool.hh"
+
+namespace roboptim
+{
+  struct ThreadPool::Worker
+  {
+    /// \brief Queued task.
+    struct Item
+    {
+      Item (const task_t& t, const void* g)
+	: task (t),
+	  group (g)
+      {}
+
+      /// \brief Task.
+      task_t task;
+      /// \brief Group tag, null outside of a group.
+      const void* group;
+    };
+
+    Worker ()
+      : mutex (),
+	tasks ()
+    {}
+
+    /// \brief Protect the deque.
+    boost::mutex mutex;
+    /// \brief Queued tasks.
+    std::deque<Item> tasks;
+  };
+
+  ThreadPool::ThreadPool (std::size_t size) throw ()
+    : size_ (size),
+      workers_ (),
+      current_ (&ThreadPool::keepWorker),
+      threads_ (),
+      mutex_ (),
+      taskAvailable_ (),
+      tasksDone_ (),
+      submitted_ (0),
+      pending_ (0),
+      next_ (0),
+      stop_ (false)
+  {
+    if (!size_)
+      size_ = boost::thread::hardware_concurrency ();
+    if (!size_)
+      size_ = 1;
+
+    for (std::size_t i = 0; i < size_; ++i)
+      workers_.push_back (boost::make_shared<Worker> ());
+    for (std::size_t i = 0; i < size_; ++i)
+      threads_.create_thread (boost::bind (&ThreadPool::run, this, i));
+  }
+
+  ThreadPool::~ThreadPool () throw ()
+  {
+    wait ();
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      stop_ = true;
+    }
+    taskAvailable_.notify_all ();
+    threads_.join_all ();
+  }
+
+  std::size_t
+  ThreadPool::size () const throw ()
+  {
+    return size_;
+  }
+
+  void
+  ThreadPool::submit (const task_t& task) throw ()
+  {
+    push (task, 0);
+  }
+
+  void
+  ThreadPool::submit (const std::vector<task_t>& tasks) throw ()
+  {
+    push (tasks, 0);
+  }
+
+  void
+  ThreadPool::push (const task_t& task, const void* group) throw ()
+  {
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      // Workers keep their own tasks, for locality.
+      Worker* worker = current_.get ();
+      if (!worker)
+	{
+	  worker = workers_[next_].get ();
+	  next_ = (next_ + 1) % size_;
+	}
+      {
+	boost::mutex::scoped_lock workerLock (worker->mutex);
+	worker->tasks.push_back (Worker::Item (task, group));
+      }
+      ++submitted_;
+      ++pending_;
+    }
+    taskAvailable_.notify_one ();
+  }
+
+  void
+  ThreadPool::push (const std::vector<task_t>& tasks, const void* group)
+    throw ()
+  {
+    if (tasks.empty ())
+      return;
+
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      // Task k goes to deque (next_ + k) % size_. Owners execute the
+      // back of their deque first: the tasks are pushed from the last
+      // one so that the first tasks end up at the back.
+      for (std::size_t d = 0; d < std::min (size_, tasks.size ()); ++d)
+	{
+	  Worker& worker = *workers_[(next_ + d) % size_];
+	  boost::mutex::scoped_lock workerLock (worker.mutex);
+	  std::size_t k = d + (tasks.size () - 1 - d) / size_ * size_;
+	  while (true)
+	    {
+	      worker.tasks.push_back (Worker::Item (tasks[k], group));
+	      if (k < size_)
+		break;
+	      k -= size_;
+	    }
+	}
+      next_ = (next_ + tasks.size ()) % size_;
+      submitted_ += tasks.size ();
+      pending_ += tasks.size ();
+    }
+    taskAvailable_.notify_all ();
+  }
+
+  void
+  ThreadPool::wait () throw ()
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    while (pending_ > 0)
+      tasksDone_.wait (lock);
+  }
+
+  void
+  ThreadPool::keepWorker (Worker*) throw ()
+  {
+  }
+
+  bool
+  ThreadPool::pop (std::size_t index, task_t& task) throw ()
+  {
+    // Own deque first, most recent task first.
+    {
+      Worker& worker = *workers_[index];
+      boost::mutex::scoped_lock lock (worker.mutex);
+      if (!worker.tasks.empty ())
+	{
+	  task.swap (worker.tasks.back ().task);
+	  worker.tasks.pop_back ();
+	  return true;
+	}
+    }
+
+    // Steal the oldest task of another worker.
+    for (std::size_t i = 1; i < size_; ++i)
+      {
+	Worker& victim = *workers_[(index + i) % size_];
+	boost::mutex::scoped_lock lock (victim.mutex);
+	if (!victim.tasks.empty ())
+	  {
+	    task.swap (victim.tasks.front ().task);
+	    victim.tasks.pop_front ();
+	    return true;
+	  }
+      }
+    return false;
+  }
+
+  bool
+  ThreadPool::runGroupTask (const void* group) throw ()
+  {
+    task_t task;
+    for (std::size_t i = 0; i < size_ && task.empty (); ++i)
+      {
+	Worker& worker = *workers_[i];
+	boost::mutex::scoped_lock lock (worker.mutex);
+	for (std::deque<Worker::Item>::iterator it = worker.tasks.end ();
+	     it != worker.tasks.begin (); )
+	  if ((--it)->group == group)
+	    {
+	      task.swap (it->task);
+	      worker.tasks.erase (it);
+	      break;
+	    }
+      }
+    if (task.empty ())
+      return false;
+
+    task ();
+    task.clear ();
+
+    boost::mutex::scoped_lock lock (mutex_);
+    if (!--pending_)
+      tasksDone_.notify_all ();
+    return true;
+  }
+
+  void
+  ThreadPool::run (std::size_t index) throw ()
+  {
+    current_.reset (workers_[index].get ());
+
+    std::size_t seen;
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      seen = submitted_;
+    }
+
+    task_t task;
+    std::size_t done = 0;
+    while (true)
+      {
+	if (pop (index, task))
+	  {
+	    task ();
+	    task.clear ();
+	    ++done;
+	    continue;
+	  }
+
+	boost::mutex::scoped_lock lock (mutex_);
+	if (done)
+	  {
+	    pending_ -= done;
+	    done = 0;
+	    if (!pending_)
+	      tasksDone_.notify_all ();
+	  }
+
+	// Tasks submitted since the last snapshot may have been
+	// missed: look again before sleeping.
+	if (submitted_ != seen)
+	  {
+	    seen = submitted_;
+	    continue;
+	  }
+	while (submitted_ == seen && !stop_)
+	  taskAvailable_.wait (lock);
+	if (stop_)
+	  return;
+	seen = submitted_;
+      }
+  }
+
+  struct TaskGroup::State
+  {
+    State ()
+      : mutex (),
+	done (),
+	pending (0)
+    {}
+
+    /// \brief Protect the counter.
+    boost::mutex mutex;
+    /// \brief Signaled when all the group tasks have been executed.
+    boost::condition_variable done;
+    /// \brief Number of submitted tasks which are not done yet.
+    std::size_t pending;
+  };
+
+  TaskGroup::TaskGroup (ThreadPool& pool) throw ()
+    : pool_ (pool),
+      state_ (boost::make_shared<State> ())
+  {
+  }
+
+  TaskGroup::~TaskGroup () throw ()
+  {
+    wait ();
+  }
+
+  ThreadPool::task_t
+  TaskGroup::wrap (const ThreadPool::task_t& task) const throw ()
+  {
+    // The wrapper holds the state: it may be executed after the
+    // group has been destroyed.
+    return boost::bind (&TaskGroup::runTask, state_, task);
+  }
+
+  void
+  TaskGroup::submit (const ThreadPool::task_t& task) throw ()
+  {
+    {
+      boost::mutex::scoped_lock lock (state_->mutex);
+      ++state_->pending;
+    }
+    pool_.push (wrap (task), state_.get ());
+  }
+
+  void
+  TaskGroup::submit (const std::vector<ThreadPool::task_t>& tasks) throw ()
+  {
+    std::vector<ThreadPool::task_t> wrapped (tasks.size ());
+    for (std::size_t i = 0; i < tasks.size (); ++i)
+      wrapped[i] = wrap (tasks[i]);
+    {
+      boost::mutex::scoped_lock lock (state_->mutex);
+      state_->pending += tasks.size ();
+    }
+    pool_.push (wrapped, state_.get ());
+  }
+
+  void
+  TaskGroup::wait () throw ()
+  {
+    // Help with the group tasks only: tasks of other clients may
+    // block until this thread returns.
+    while (pool_.runGroupTask (state_.get ()))
+      continue;
+
+    // The remaining tasks are being executed by the workers.
+    boost::mutex::scoped_lock lock (state_->mutex);
+    while (state_->pending > 0)
+      state_->done.wait (lock);
+  }
+
+  void
+  TaskGroup::runTask (const boost::shared_ptr<State>& state,
+		      const ThreadPool::task_t& task) throw ()
+  {
+    task ();
+
+    boost::mutex::scoped_lock lock (state->mutex);
+    if (!--state->pending)
+      state->done.notify_all ();
+  }
+
+} // end of namespace roboptim
@@ -0,0 +1,72 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "debug.hh"
+
+#include <iostream>
+
+#include <roboptim/core/indent.hh>
+#include <roboptim/core/util.hh>
+#include <roboptim/core/warm-start.hh>
+
+namespace roboptim
+{
+  WarmStart::WarmStart (size_type inputSize_) throw ()
+    : inputSize (inputSize_),
+      x (inputSize_),
+      lambda (),
+      activeSet (),
+      hessian ()
+  {
+    x.setZero ();
+  }
+
+  WarmStart::WarmStart (const Result& result) throw ()
+    : inputSize (result.inputSize),
+      x (result.x),
+      lambda (result.lambda),
+      activeSet (),
+      hessian ()
+  {
+  }
+
+  WarmStart::~WarmStart () throw ()
+  {
+  }
+
+  std::ostream&
+  WarmStart::print (std::ostream& o) const throw ()
+  {
+    o << "Warm start:" << incindent << iendl
+      << "X: " << x << iendl
+      << "Lambda: " << lambda;
+
+    if (activeSet)
+      o << iendl << "Active set: " << *activeSet;
+    if (hessian)
+      o << iendl << "Hessian approximation: " << *hessian;
+
+    return o << decindent;
+  }
+
+  std::ostream& operator<< (std::ostream& o, const WarmStart& ws)
+  {
+    return ws.print (o);
+  }
+
+} // end of namespace roboptim
@@ -0,0 +1,165 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/differentiable-function.hh>
+#include <roboptim/core/finite-difference-gradient.hh>
+#include <roboptim/core/numeric-linear-function.hh>
+#include <roboptim/core/filter/algebra.hh>
+
+using namespace roboptim;
+
+// f(x) = (x0 * x1, x1^2)
+struct F : public DifferentiableFunction
+{
+  F () : DifferentiableFunction (2, 2, "f"),
+	 computations (0)
+  {}
+
+  void impl_compute (result_t& res, const argument_t& x) const throw ()
+  {
+    ++computations;
+    res[0] = x[0] * x[1];
+    res[1] = x[1] * x[1];
+  }
+
+  void impl_gradient (gradient_t& grad, const argument_t& x,
+		      size_type functionId) const throw ()
+  {
+    if (functionId == 0)
+      {
+	grad[0] = x[1];
+	grad[1] = x[0];
+      }
+    else
+      {
+	grad[0] = 0.;
+	grad[1] = 2. * x[1];
+      }
+  }
+
+  /// \brief Number of evaluations.
+  mutable int computations;
+};
+
+// g(x) = (x0 + x1)
+struct G : public Function
+{
+  G () : Function (2, 1, "g")
+  {}
+
+  void impl_compute (result_t& res, const argument_t& x) const throw ()
+  {
+    res[0] = x[0] + x[1];
+  }
+};
+
+template <typename T>
+void checkFunction (boost::shared_ptr<boost::test_tools::output_test_stream>
+		    output,
+		    const T& f, const Function::vector_t& x)
+{
+  Function::vector_t value = f (x);
+  (*output) << f.getName () << ":";
+  for (Function::size_type i = 0; i < value.size (); ++i)
+    (*output) << " " << value[i];
+  (*output) << std::endl;
+  for (Function::size_type i = 0; i < f.outputSize (); ++i)
+    BOOST_CHECK (checkGradient (f, i, x));
+
+  DifferentiableFunction::jacobian_t jacobian = f.jacobian (x);
+  for (Function::size_type i = 0; i < f.outputSize (); ++i)
+    BOOST_CHECK ((jacobian.row (i).transpose () - f.gradient (x, i))
+		 .cwiseAbs ().maxCoeff () < 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE (algebra)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("algebra");
+
+  boost::shared_ptr<F> f (new F ());
+
+  NumericLinearFunction::matrix_t a (2, 2);
+  a << 1., 2., 3., 4.;
+  NumericLinearFunction::vector_t b (2);
+  b << 5., 6.;
+  boost::shared_ptr<NumericLinearFunction> l
+    (new NumericLinearFunction (a, b));
+
+  Function::vector_t x (2);
+  x << 1., 3.;
+
+  checkFunction (output, *(f + l), x);
+  checkFunction (output, *(f - l), x);
+  checkFunction (output, *(2. * f), x);
+  checkFunction (output, *(f * 3.), x);
+  checkFunction (output, *(f * l), x);
+  checkFunction (output, *compose (f, l), x);
+  checkFunction (output, *concatenate (f, l), x);
+
+  // Nested expressions.
+  checkFunction (output, *(compose (f, f + l) - 2. * (f * l)), x);
+
+  // Linear combinations are evaluated by their root node, each term
+  // once.
+  boost::shared_ptr<DifferentiableFunction> combination =
+    (f + l) - 2. * (f - l);
+  checkFunction (output, *combination, x);
+  f->computations = 0;
+  (*combination) (x);
+  BOOST_CHECK_EQUAL (f->computations, 2);
+
+  // The expression type keeps the operands static types.
+  boost::shared_ptr<Plus<F, Scalar<NumericLinearFunction> > > minus = f - l;
+  BOOST_CHECK_EQUAL (minus->left (), f);
+  BOOST_CHECK_EQUAL (minus->right ()->scalar (), -1.);
+
+  // Operands values are evaluated once for all the gradients at a
+  // same point.
+  boost::shared_ptr<Product<F, F> > product = f * f;
+  boost::shared_ptr<Composition<NumericLinearFunction, F> > composition =
+    compose (l, f);
+  f->computations = 0;
+  for (Function::size_type i = 0; i < f->outputSize (); ++i)
+    {
+      product->gradient (x, i);
+      composition->gradient (x, i);
+    }
+  BOOST_CHECK_EQUAL (f->computations, 3);
+  x[0] = 2.;
+  product->gradient (x, 0);
+  composition->gradient (x, 0);
+  BOOST_CHECK_EQUAL (f->computations, 6);
+  BOOST_CHECK ((composition->gradient (x, 1)
+		- composition->jacobian (x).row (1).transpose ())
+	       .cwiseAbs ().maxCoeff () < 1e-12);
+  x[0] = 1.;
+
+  // Non-differentiable operands yield non-differentiable expressions.
+  boost::shared_ptr<G> g (new G ());
+  boost::shared_ptr<Function> sum = g + compose (g, f);
+  BOOST_CHECK (!boost::dynamic_pointer_cast<DifferentiableFunction> (sum));
+  (*output) << sum->getName () << ": " << (*sum) (x)[0] << std::endl;
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
@@ -0,0 +1,148 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/mpl/vector.hpp>
+
+#include <roboptim/core/batch-solver.hh>
+#include <roboptim/core/io.hh>
+
+using namespace roboptim;
+
+typedef Solver<Function, boost::mpl::vector<Function> > solver_t;
+typedef BatchSolver<solver_t> batchSolver_t;
+
+struct F : public Function
+{
+  F () : Function (1, 1, "x")
+  {}
+
+  void impl_compute (result_t& result, const argument_t& argument)
+    const throw ()
+  {
+    result (0) = argument[0];
+  }
+};
+
+bool stop (const SolverState&)
+{
+  return false;
+}
+
+// Stop the solvers of odd problems at their first iteration.
+void setup (solver_t& solver, std::size_t i)
+{
+  if (i % 2)
+    solver.setIterationCallback (&stop);
+}
+
+// Task blocking a pool worker until released.
+struct Blocker
+{
+  Blocker () : released (false)
+  {}
+
+  void block ()
+  {
+    boost::mutex::scoped_lock lock (mutex);
+    while (!released)
+      condition.wait (lock);
+  }
+
+  void release ()
+  {
+    boost::mutex::scoped_lock lock (mutex);
+    released = true;
+    condition.notify_all ();
+  }
+
+  boost::mutex mutex;
+  boost::condition_variable condition;
+  bool released;
+};
+
+void display (std::ostream& o, const batchSolver_t::results_t& results)
+{
+  for (std::size_t i = 0; i < 4; ++i)
+    o << i << ": " << boost::get<SolverError> (results[i]).what ()
+      << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE (batch_solver)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("batch-solver");
+
+  F f;
+  batchSolver_t::problems_t problems (1000, solver_t::problem_t (f));
+
+  // Sequential.
+  batchSolver_t sequential ("dummy-laststate");
+  sequential.setSetup (&setup);
+  batchSolver_t::results_t results = sequential.solve (problems);
+  BOOST_CHECK_EQUAL (results.size (), problems.size ());
+  display (*output, results);
+
+  // Parallel, results are in the same order.
+  batchSolver_t parallel ("dummy-laststate",
+			  boost::make_shared<ThreadPool> (4));
+  parallel.setSetup (&setup);
+  parallel.parameters ()["dummy-parameter"].value = 0.;
+  batchSolver_t::results_t parallelResults = parallel.solve (problems);
+  BOOST_REQUIRE_EQUAL (parallelResults.size (), problems.size ());
+  for (std::size_t i = 0; i < problems.size (); ++i)
+    BOOST_CHECK_EQUAL
+      (std::string (boost::get<SolverError> (results[i]).what ()),
+       std::string (boost::get<SolverError> (parallelResults[i]).what ()));
+  display (*output, parallelResults);
+
+  // The plug-in is released once the batch is done.
+  BOOST_CHECK_EQUAL
+    (PluginRegistry::instance ().references ("dummy-laststate"), 0);
+
+  // Loading errors are reported to the caller.
+  batchSolver_t invalid ("does-not-exist");
+  BOOST_CHECK_THROW (invalid.solve (problems), std::runtime_error);
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
+
+BOOST_AUTO_TEST_CASE (batch_solver_shared_pool)
+{
+  F f;
+  batchSolver_t::problems_t problems (100, solver_t::problem_t (f));
+
+  // An unrelated task keeps a worker busy: the batch only waits for
+  // its own tasks.
+  boost::shared_ptr<ThreadPool> pool = boost::make_shared<ThreadPool> (2);
+  Blocker blocker;
+  pool->submit (boost::bind (&Blocker::block, &blocker));
+
+  batchSolver_t batch ("dummy-laststate", pool);
+  batchSolver_t::results_t results = batch.solve (problems);
+  BOOST_CHECK_EQUAL (results.size (), problems.size ());
+
+  blocker.release ();
+  pool->wait ();
+}
@@ -0,0 +1,174 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/mpl/vector.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <roboptim/core/cancellation-token.hh>
+#include <roboptim/core/io.hh>
+#include <roboptim/core/plugin-registry.hh>
+#include <roboptim/core/solver-factory.hh>
+
+using namespace roboptim;
+using boost::posix_time::microsec_clock;
+using boost::posix_time::milliseconds;
+
+typedef Solver<Function, boost::mpl::vector<Function> > solver_t;
+
+struct F : public Function
+{
+  F () : Function (1, 1, "x")
+  {}
+
+  void impl_compute (result_t& result, const argument_t& argument)
+    const throw ()
+  {
+    result (0) = argument[0];
+  }
+};
+
+// Solver which never converges: it only stops when interrupted.
+struct RunawaySolver : public solver_t
+{
+  explicit RunawaySolver (const problem_t& pb) throw ()
+    : solver_t (pb)
+  {}
+
+  void solve () throw ()
+  {
+    Result res (1, 1);
+    vector_t lambda;
+    for (Function::size_type k = 0; ; ++k)
+      {
+	res.x[0] = static_cast<double> (k);
+	problem ().function () (res.value, res.x);
+	if (!iterate (SolverState (k, res.x, res.value[0], 0., lambda)))
+	  break;
+	boost::this_thread::sleep (milliseconds (1));
+      }
+    interrupt (res);
+  }
+};
+
+namespace
+{
+  unsigned getSizeOfProblem ()
+  {
+    return sizeof (solver_t::problem_t);
+  }
+
+  solver_t* create (const solver_t::problem_t& pb)
+  {
+    return new RunawaySolver (pb);
+  }
+
+  void destroy (solver_t* p)
+  {
+    delete p;
+  }
+
+  StaticPluginRegistrar registrar
+  ("runaway", &getSizeOfProblem, &create, &destroy);
+} // end of anonymous namespace.
+
+void cancelLater (boost::shared_ptr<CancellationToken> token)
+{
+  boost::this_thread::sleep (milliseconds (20));
+  token->cancel ();
+}
+
+BOOST_AUTO_TEST_CASE (cancellation)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("cancellation");
+
+  F f;
+  solver_t::problem_t pb (f);
+
+  // Token states.
+  CancellationToken token;
+  BOOST_CHECK (!token.stopRequested ());
+  BOOST_CHECK (token.deadline ().is_pos_infinity ());
+  token.setTimeout (milliseconds (-1));
+  BOOST_CHECK (token.expired ());
+
+  // Absolute UTC deadlines.
+  boost::posix_time::ptime deadline =
+    microsec_clock::universal_time () + boost::posix_time::hours (1);
+  token.setDeadline (deadline);
+  BOOST_CHECK (!token.expired ());
+  BOOST_CHECK (token.deadline () - deadline < milliseconds (100));
+  BOOST_CHECK (deadline - token.deadline () < milliseconds (100));
+  token.setDeadline (microsec_clock::universal_time () - milliseconds (1));
+  BOOST_CHECK (token.expired ());
+  token.cancel ();
+  (*output) << token.reason () << std::endl;
+  token.reset ();
+  BOOST_CHECK (!token.stopRequested ());
+
+  // A runaway solve returns within its time budget.
+  {
+    SolverFactory<solver_t> factory ("runaway", pb);
+    solver_t& solver = factory ();
+    solver.setCancellationToken
+      (boost::make_shared<CancellationToken> (milliseconds (50)));
+
+    boost::posix_time::ptime start = microsec_clock::universal_time ();
+    const SolverError& error = solver.getMinimum<SolverError> ();
+    BOOST_CHECK (microsec_clock::universal_time () - start
+		 < milliseconds (1000));
+    BOOST_CHECK (error.lastState ());
+    BOOST_CHECK (error.lastState ()->x[0] > 0.);
+    (*output) << error.what () << std::endl;
+  }
+
+  // Cancellation from another thread.
+  {
+    SolverFactory<solver_t> factory ("runaway", pb);
+    solver_t& solver = factory ();
+    boost::shared_ptr<CancellationToken> token =
+      boost::make_shared<CancellationToken> ();
+    solver.setCancellationToken (token);
+
+    boost::thread thread (&cancelLater, token);
+    (*output) << solver.getMinimum<SolverError> ().what () << std::endl;
+    thread.join ();
+  }
+
+  // Plug-ins poll the token before iterating.
+  {
+    SolverFactory<solver_t> factory ("dummy-laststate", pb);
+    solver_t& solver = factory ();
+    boost::shared_ptr<CancellationToken> token =
+      boost::make_shared<CancellationToken> ();
+    token->cancel ();
+    solver.setCancellationToken (token);
+    const SolverError& error = solver.getMinimum<SolverError> ();
+    (*output) << error.what () << std::endl
+	      << "Last x: " << error.lastState ()->x << std::endl;
+  }
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
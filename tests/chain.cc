@@ -0,0 +1,162 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "shared-tests/common.hh"
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include <boost/format.hpp>
+#include <boost/make_shared.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/differentiable-function.hh>
+#include <roboptim/core/finite-difference-gradient.hh>
+#include <roboptim/core/filter/chain.hh>
+
+using namespace roboptim;
+
+// f_i (x) = sum_j a_ij sin (x_j), a_ij = (i + 1) / (i + j + 2)
+struct Stage : public DifferentiableFunction
+{
+  Stage (size_type in, size_type out)
+    : DifferentiableFunction (in, out, (boost::format ("s%1%x%2%")
+					% out % in).str ()),
+      a_ (out, in),
+      computations (0)
+  {
+    for (size_type i = 0; i < out; ++i)
+      for (size_type j = 0; j < in; ++j)
+	a_ (i, j) = (value_type) (i + 1) / (value_type) (i + j + 2);
+  }
+
+  ~Stage () throw ()
+  {}
+
+  void impl_compute (result_t& res, const argument_t& x) const throw ()
+  {
+    ++computations;
+    res.setZero ();
+    for (size_type j = 0; j < inputSize (); ++j)
+      res += a_.col (j) * std::sin (x[j]);
+  }
+
+  void impl_gradient (gradient_t& grad, const argument_t& x,
+		      size_type functionId) const throw ()
+  {
+    for (size_type j = 0; j < inputSize (); ++j)
+      grad[j] = a_ (functionId, j) * std::cos (x[j]);
+  }
+
+  matrix_t a_;
+  /// \brief Number of evaluations.
+  mutable int computations;
+};
+
+void checkChain (boost::shared_ptr<boost::test_tools::output_test_stream>
+		 output,
+		 const Chain::stages_t& stages)
+{
+  Chain chain (stages);
+  (*output) << chain << std::endl;
+
+  Function::vector_t x (chain.inputSize ());
+  for (Function::size_type i = 0; i < x.size (); ++i)
+    x[i] = .1 * (double) (i + 1);
+
+  // Naive evaluation, stage by stage.
+  Function::vector_t y = x;
+  DifferentiableFunction::jacobian_t expected =
+    DifferentiableFunction::jacobian_t::Identity (x.size (), x.size ());
+  for (std::size_t k = 0; k < stages.size (); ++k)
+    {
+      expected = stages[k]->jacobian (y) * expected;
+      y = (*stages[k]) (y);
+    }
+
+  BOOST_CHECK ((chain (x) - y).cwiseAbs ().maxCoeff () < 1e-12);
+  DifferentiableFunction::jacobian_t jacobian = chain.jacobian (x);
+  BOOST_CHECK ((jacobian - expected).cwiseAbs ().maxCoeff () < 1e-12);
+
+  for (Function::size_type i = 0; i < chain.outputSize (); ++i)
+    {
+      BOOST_CHECK ((chain.gradient (x, i) - expected.row (i).transpose ())
+		   .cwiseAbs ().maxCoeff () < 1e-12);
+      BOOST_CHECK (checkGradient (chain, i, x));
+    }
+}
+
+BOOST_AUTO_TEST_CASE (chain)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("chain");
+
+  // One stage: the chain is the stage.
+  Chain::stages_t stages;
+  stages.push_back (boost::make_shared<Stage> (3, 2));
+  checkChain (output, stages);
+
+  // Narrowing chain (kinematic chain then projection): reverse order.
+  stages.clear ();
+  stages.push_back (boost::make_shared<Stage> (6, 12));
+  stages.push_back (boost::make_shared<Stage> (12, 12));
+  stages.push_back (boost::make_shared<Stage> (12, 12));
+  stages.push_back (boost::make_shared<Stage> (12, 2));
+  checkChain (output, stages);
+
+  // Widening chain: forward order.
+  stages.clear ();
+  stages.push_back (boost::make_shared<Stage> (1, 8));
+  stages.push_back (boost::make_shared<Stage> (8, 8));
+  stages.push_back (boost::make_shared<Stage> (8, 8));
+  checkChain (output, stages);
+
+  // Mixed chain.
+  stages.clear ();
+  stages.push_back (boost::make_shared<Stage> (10, 2));
+  stages.push_back (boost::make_shared<Stage> (2, 10));
+  stages.push_back (boost::make_shared<Stage> (10, 2));
+  stages.push_back (boost::make_shared<Stage> (2, 10));
+  checkChain (output, stages);
+
+  // Stages are evaluated once for all the gradients at a same point.
+  {
+    boost::shared_ptr<Stage> first = boost::make_shared<Stage> (4, 3);
+    stages.clear ();
+    stages.push_back (first);
+    stages.push_back (boost::make_shared<Stage> (3, 2));
+    Chain chain (stages);
+    Function::vector_t x = Function::vector_t::Constant (4, .5);
+    for (Function::size_type i = 0; i < chain.outputSize (); ++i)
+      chain.gradient (x, i);
+    BOOST_CHECK_EQUAL (first->computations, 1);
+    chain (x);
+    chain.gradient (x, 0);
+    BOOST_CHECK_EQUAL (first->computations, 3);
+  }
+
+  // Invalid chains are rejected.
+  BOOST_CHECK_THROW (Chain (Chain::stages_t ()), std::runtime_error);
+  stages.clear ();
+  stages.push_back (boost::make_shared<Stage> (4, 3));
+  stages.push_back (boost::make_shared<Stage> (2, 2));
+  BOOST_CHECK_THROW (Chain chain (stages), std::runtime_error);
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
@@ -0,0 +1,291 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+
+#include <boost/make_shared.hpp>
+#include <boost/mpl/vector.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/constraints-evaluator.hh>
+#include <roboptim/core/differentiable-function.hh>
+#include <roboptim/core/filter/split.hh>
+#include <roboptim/core/numeric-linear-function.hh>
+#include <roboptim/core/problem.hh>
+#include <roboptim/core/thread-pool.hh>
+#include <roboptim/core/util.hh>
+
+using namespace roboptim;
+
+typedef Problem<DifferentiableFunction,
+		boost::mpl::vector<LinearFunction, DifferentiableFunction> >
+problem_t;
+
+// f(x) = x0 * x1 * x2
+struct F : public DifferentiableFunction
+{
+  F () : DifferentiableFunction (3, 1, "x0 * x1 * x2")
+  {}
+
+  void impl_compute (result_t& res, const argument_t& x) const throw ()
+  {
+    res[0] = x[0] * x[1] * x[2];
+  }
+
+  void impl_gradient (gradient_t& grad, const argument_t& x,
+		      size_type) const throw ()
+  {
+    grad[0] = x[1] * x[2];
+    grad[1] = x[0] * x[2];
+    grad[2] = x[0] * x[1];
+  }
+};
+
+// g(x) = (x0^2, x2^2)
+struct G : public DifferentiableFunction
+{
+  G () : DifferentiableFunction (3, 2, "(x0^2, x2^2)")
+  {}
+
+  void impl_compute (result_t& res, const argument_t& x) const throw ()
+  {
+    res[0] = x[0] * x[0];
+    res[1] = x[2] * x[2];
+  }
+
+  void impl_gradient (gradient_t& grad, const argument_t& x,
+		      size_type functionId) const throw ()
+  {
+    grad.setZero ();
+    if (functionId == 0)
+      grad[0] = 2. * x[0];
+    else
+      grad[2] = 2. * x[2];
+  }
+};
+
+BOOST_AUTO_TEST_CASE (constraints_evaluator)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("constraints-evaluator");
+
+  F f;
+  problem_t pb (f);
+
+  NumericLinearFunction::matrix_t a (1, 3);
+  a << 1., 2., 3.;
+  NumericLinearFunction::vector_t b (1);
+  b << -1.;
+
+  boost::shared_ptr<LinearFunction> linear =
+    boost::make_shared<NumericLinearFunction> (a, b);
+  boost::shared_ptr<DifferentiableFunction> g = boost::make_shared<G> ();
+
+  pb.addConstraint (linear, Function::makeLowerInterval (0.));
+  problem_t::intervals_t bounds (2, Function::makeInterval (0., 1.));
+  problem_t::scales_t scales (2, 1.);
+  pb.addConstraint (g, bounds, scales);
+  pb.addConstraint (boost::make_shared<F> (), Function::makeInterval (0., 1.));
+
+  ConstraintsEvaluator<problem_t> evaluator (pb);
+  BOOST_CHECK_EQUAL (evaluator.inputSize (), 3);
+  BOOST_CHECK_EQUAL (evaluator.outputSize (), 4);
+  (*output) << "Offsets: " << evaluator.offsets () << std::endl;
+
+  Function::vector_t x (3);
+  x << 1., 2., 3.;
+
+  Function::vector_t values (evaluator.outputSize ());
+  evaluator.computeConstraints (values, x);
+  (*output) << "Values: " << values << std::endl;
+
+  DifferentiableFunction::jacobian_t jacobian
+    (evaluator.outputSize (), evaluator.inputSize ());
+  evaluator.computeJacobian (jacobian, x);
+
+  // Check against the constraints jacobians.
+  BOOST_CHECK (jacobian.row (0) == linear->jacobian (x));
+  BOOST_CHECK (jacobian.middleRows (1, 2) == g->jacobian (x));
+  BOOST_CHECK (jacobian.row (3) == f.jacobian (x));
+
+  // The dispatch table points directly to the constraints.
+  BOOST_CHECK_EQUAL (evaluator.dispatchTable ().size (), 3);
+  BOOST_CHECK_EQUAL (evaluator.dispatchTable ()[0].object, linear.get ());
+  BOOST_CHECK_EQUAL (evaluator.dispatchTable ()[1].object, g.get ());
+
+  // The linear constraint is merged in the linear block.
+  BOOST_CHECK_EQUAL (evaluator.linearConstraints ().size (), 1);
+  BOOST_CHECK_EQUAL (evaluator.linearConstraints ()[0], 0);
+  BOOST_CHECK (DifferentiableFunction::jacobian_t
+	       (evaluator.linearJacobian ()) == a);
+  BOOST_CHECK (evaluator.linearConstant () == b);
+
+  DifferentiableFunction::gradient_t gradient (evaluator.inputSize ());
+  evaluator.computeGradient (gradient, x, 1, 1);
+  BOOST_CHECK (gradient == g->gradient (x, 1));
+
+  ConstraintsEvaluator<problem_t>::sparseJacobian_t sparseJacobian;
+  evaluator.computeJacobian (sparseJacobian, x);
+  BOOST_CHECK (DifferentiableFunction::jacobian_t (sparseJacobian)
+	       == jacobian);
+  (*output) << "Non-zeros: " << sparseJacobian.nonZeros () << std::endl;
+
+  // Evaluate again at another point: the sparse structure changes.
+  x << 0., 2., 3.;
+  evaluator.computeConstraints (values, x);
+  (*output) << "Values: " << values << std::endl;
+  evaluator.computeJacobian (jacobian, x);
+  evaluator.computeJacobian (sparseJacobian, x);
+  BOOST_CHECK (DifferentiableFunction::jacobian_t (sparseJacobian)
+	       == jacobian);
+  (*output) << "Non-zeros: " << sparseJacobian.nonZeros () << std::endl;
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
+
+BOOST_AUTO_TEST_CASE (constraints_evaluator_linear_block)
+{
+  F f;
+  problem_t pb (f);
+
+  // Bound-like linear constraints mixed with a non-linear one.
+  std::vector<boost::shared_ptr<LinearFunction> > linears;
+  for (unsigned i = 0; i < 3; ++i)
+    {
+      NumericLinearFunction::matrix_t a (2, 3);
+      a.setZero ();
+      a (0, i) = 1.;
+      a (1, i) = -2.;
+      NumericLinearFunction::vector_t b (2);
+      b << i, 1.;
+      linears.push_back (boost::make_shared<NumericLinearFunction> (a, b));
+
+      problem_t::intervals_t bounds (2, Function::makeInterval (0., 1.));
+      problem_t::scales_t scales (2, 1.);
+      pb.addConstraint (linears.back (), bounds, scales);
+      if (i == 1)
+	pb.addConstraint (boost::make_shared<F> (),
+			  Function::makeInterval (0., 1.));
+    }
+
+  ConstraintsEvaluator<problem_t> evaluator (pb);
+  BOOST_CHECK_EQUAL (evaluator.linearConstraints ().size (), 3);
+  BOOST_CHECK_EQUAL (evaluator.linearConstraints ()[2], 3);
+  BOOST_CHECK_EQUAL (evaluator.linearJacobian ().rows (), 6);
+  BOOST_CHECK_EQUAL (evaluator.linearJacobian ().nonZeros (), 6);
+
+  Function::vector_t x (3);
+  x << 1., 2., 3.;
+  Function::vector_t values (evaluator.outputSize ());
+  evaluator.computeConstraints (values, x);
+  BOOST_CHECK (values.segment (0, 2) == (*linears[0]) (x));
+  BOOST_CHECK (values.segment (2, 2) == (*linears[1]) (x));
+  BOOST_CHECK_EQUAL (values[4], f (x)[0]);
+  BOOST_CHECK (values.segment (5, 2) == (*linears[2]) (x));
+
+  DifferentiableFunction::jacobian_t jacobian
+    (evaluator.outputSize (), evaluator.inputSize ());
+  evaluator.computeJacobian (jacobian, x);
+  BOOST_CHECK (jacobian.middleRows (2, 2) == linears[1]->jacobian (x));
+  BOOST_CHECK (jacobian.row (4) == f.jacobian (x));
+  BOOST_CHECK (jacobian.middleRows (5, 2) == linears[2]->jacobian (x));
+}
+
+BOOST_AUTO_TEST_CASE (constraints_evaluator_parallel)
+{
+  F f;
+  problem_t pb (f);
+
+  // More constraints than workers: the tasks are dealt over the
+  // workers deques in decreasing cost order (longest processing time
+  // first) and stolen by the idle workers.
+  for (unsigned i = 0; i < 20; ++i)
+    {
+      pb.addConstraint (boost::make_shared<F> (),
+			Function::makeInterval (0., 1.));
+      problem_t::intervals_t bounds (2, Function::makeInterval (0., 1.));
+      problem_t::scales_t scales (2, 1.);
+      pb.addConstraint
+	(boost::static_pointer_cast<DifferentiableFunction>
+	 (boost::make_shared<G> ()), bounds, scales);
+    }
+
+  // Splits sharing a non-concurrent context.
+  addNonScalarConstraint
+    (pb, boost::static_pointer_cast<DifferentiableFunction>
+     (boost::make_shared<G> ()),
+     problem_t::intervals_t (2, Function::makeInterval (0., 1.)));
+  const Split<DifferentiableFunction>& split =
+    dynamic_cast<const Split<DifferentiableFunction>&>
+    (*boost::get<boost::shared_ptr<DifferentiableFunction> >
+     (pb.constraints ().back ()));
+  BOOST_CHECK (!split.context ()->concurrent ());
+
+  ConstraintsEvaluator<problem_t> sequential (pb);
+  ConstraintsEvaluator<problem_t> parallel (pb);
+  parallel.setThreadPool (boost::make_shared<ThreadPool> (4));
+  BOOST_CHECK (!sequential.threadPool ());
+  BOOST_CHECK_EQUAL (parallel.threadPool ()->size (), 4);
+
+  // The evaluator serializes the accesses to the shared context.
+  BOOST_CHECK (split.context ()->concurrent ());
+
+  Function::vector_t x (3);
+  Function::vector_t expected (sequential.outputSize ());
+  Function::vector_t values (parallel.outputSize ());
+  DifferentiableFunction::jacobian_t expectedJacobian
+    (sequential.outputSize (), sequential.inputSize ());
+  DifferentiableFunction::jacobian_t jacobian
+    (parallel.outputSize (), parallel.inputSize ());
+  ConstraintsEvaluator<problem_t>::sparseJacobian_t expectedSparse;
+  ConstraintsEvaluator<problem_t>::sparseJacobian_t sparse;
+
+  for (unsigned i = 0; i < 10; ++i)
+    {
+      x << i, 2. - i, .5 * i;
+
+      sequential.computeConstraints (expected, x);
+      values.setZero ();
+      parallel.computeConstraints (values, x);
+      BOOST_CHECK (values == expected);
+
+      sequential.computeJacobian (expectedJacobian, x);
+      jacobian.setZero ();
+      parallel.computeJacobian (jacobian, x);
+      BOOST_CHECK (jacobian == expectedJacobian);
+
+      sequential.computeJacobian (expectedSparse, x);
+      parallel.computeJacobian (sparse, x);
+      BOOST_CHECK (DifferentiableFunction::jacobian_t (sparse)
+		   == DifferentiableFunction::jacobian_t (expectedSparse));
+    }
+
+  // Costs are only measured in parallel mode.
+  BOOST_CHECK_EQUAL (parallel.valueCosts ().size (), 42);
+  for (std::size_t i = 0; i < parallel.valueCosts ().size (); ++i)
+    {
+      BOOST_CHECK_EQUAL (sequential.valueSamples ()[i], 0);
+      BOOST_CHECK_EQUAL (sequential.valueCosts ()[i], 1.);
+      BOOST_CHECK (parallel.valueSamples ()[i] > 0);
+      BOOST_CHECK (parallel.jacobianSamples ()[i] > 0);
+      BOOST_CHECK (parallel.valueCosts ()[i] < 1.);
+      BOOST_CHECK (parallel.jacobianCosts ()[i] < 1.);
+    }
+}
@@ -0,0 +1,150 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+
+#include <boost/make_shared.hpp>
+#include <boost/mpl/vector.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/constant-function.hh>
+#include <roboptim/core/constraints-evaluator.hh>
+#include <roboptim/core/diagonal-quadratic-function.hh>
+#include <roboptim/core/identity-function.hh>
+#include <roboptim/core/numeric-linear-function.hh>
+#include <roboptim/core/numeric-quadratic-function.hh>
+#include <roboptim/core/problem.hh>
+#include <roboptim/core/filter/algebra.hh>
+#include <roboptim/core/filter/chain.hh>
+
+using namespace roboptim;
+
+typedef Problem<DifferentiableFunction,
+		boost::mpl::vector<LinearFunction, DifferentiableFunction> >
+problem_t;
+
+// f(x) = x0 * x1
+struct F : public DifferentiableFunction
+{
+  F () : DifferentiableFunction (2, 1, "x0 * x1")
+  {}
+
+  void impl_compute (result_t& res, const argument_t& x) const throw ()
+  {
+    res[0] = x[0] * x[1];
+  }
+
+  void impl_gradient (gradient_t& grad, const argument_t& x,
+		      size_type) const throw ()
+  {
+    grad[0] = x[1];
+    grad[1] = x[0];
+  }
+};
+
+void printStructure
+(boost::shared_ptr<boost::test_tools::output_test_stream> output,
+ const std::string& name, Function::structure_t flags)
+{
+  (*output) << name << ":";
+  if (flags & Function::CONSTANT_JACOBIAN)
+    (*output) << " constant-jacobian";
+  if (flags & Function::CONSTANT_HESSIAN)
+    (*output) << " constant-hessian";
+  if (flags & Function::LINEAR)
+    (*output) << " linear";
+  if (flags & Function::QUADRATIC)
+    (*output) << " quadratic";
+  if (flags & Function::SEPARABLE)
+    (*output) << " separable";
+  if (flags & Function::INDEPENDENT_ROWS)
+    (*output) << " independent-rows";
+  (*output) << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE (function_structure)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("function-structure");
+
+  Function::vector_t offset (2);
+  offset << 1., 2.;
+
+  NumericLinearFunction::matrix_t a (1, 2);
+  a << 1., 2.;
+  NumericLinearFunction::vector_t b (1);
+  b << 3.;
+
+  NumericQuadraticFunction::symmetric_t q (2, 2);
+  q << 2., 1., 1., 2.;
+
+  boost::shared_ptr<F> f = boost::make_shared<F> ();
+  boost::shared_ptr<NumericLinearFunction> l =
+    boost::make_shared<NumericLinearFunction> (a, b);
+  boost::shared_ptr<IdentityFunction> identity =
+    boost::make_shared<IdentityFunction> (offset);
+  boost::shared_ptr<NumericQuadraticFunction> quadratic =
+    boost::make_shared<NumericQuadraticFunction> (q, offset);
+
+  printStructure (output, "differentiable", f->structure ());
+  printStructure (output, "numeric linear", l->structure ());
+  printStructure (output, "identity", identity->structure ());
+  printStructure (output, "constant",
+		  ConstantFunction (offset).structure ());
+  printStructure (output, "numeric quadratic", quadratic->structure ());
+  printStructure (output, "diagonal quadratic",
+		  DiagonalQuadraticFunction (offset, offset).structure ());
+
+  BOOST_CHECK (identity->hasStructure (Function::LINEAR
+				       | Function::INDEPENDENT_ROWS));
+  BOOST_CHECK (!quadratic->hasStructure (Function::LINEAR
+					 | Function::QUADRATIC));
+
+  // Expressions propagate the structure of their operands.
+  printStructure (output, "linear + linear", (l + 2. * l)->structure ());
+  printStructure (output, "f + linear", (f + l)->structure ());
+  printStructure (output, "linear * linear", (l * l)->structure ());
+  printStructure (output, "quadratic (identity)",
+		  compose (quadratic, identity)->structure ());
+  printStructure (output, "identity; identity",
+		  concatenate (identity, identity)->structure ());
+
+  Chain::stages_t stages;
+  stages.push_back (identity);
+  stages.push_back (identity);
+  stages.push_back (l);
+  printStructure (output, "chain", Chain (stages).structure ());
+
+  // The evaluator merges any linear constraint in the linear block.
+  problem_t pb (*f);
+  pb.addConstraint
+    (boost::static_pointer_cast<DifferentiableFunction> (l - l * 2.),
+     Function::makeLowerInterval (0.));
+  pb.addConstraint (boost::static_pointer_cast<DifferentiableFunction> (f),
+		    Function::makeLowerInterval (0.));
+  ConstraintsEvaluator<problem_t> evaluator (pb);
+  BOOST_CHECK_EQUAL (evaluator.linearConstraints ().size (), 1);
+  BOOST_CHECK_EQUAL (evaluator.linearConstraints ()[0], 0);
+  BOOST_CHECK (DifferentiableFunction::jacobian_t
+	       (evaluator.linearJacobian ()) == -a);
+  BOOST_CHECK (evaluator.linearConstant () == -b);
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
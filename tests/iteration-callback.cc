@@ -0,0 +1,93 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+
+#include <boost/bind.hpp>
+#include <boost/mpl/vector.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/solver-factory.hh>
+#include <roboptim/core/solver-state.hh>
+
+using namespace roboptim;
+
+typedef Solver<Function, boost::mpl::vector<Function> > solver_t;
+
+struct F : public Function
+{
+  F () : Function (1, 1, "x")
+  {}
+
+  void impl_compute (result_t& result, const argument_t& argument)
+    const throw ()
+  {
+    result (0) = argument[0];
+  }
+};
+
+bool monitor (std::ostream* o, bool continue_, const SolverState& state)
+{
+  (*o) << state << std::endl;
+  return continue_;
+}
+
+BOOST_AUTO_TEST_CASE (iteration_callback)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("iteration-callback");
+
+  F f;
+  solver_t::problem_t pb (f);
+
+  SolverFactory<solver_t> factory ("dummy-laststate", pb);
+  solver_t& solver = factory ();
+  BOOST_CHECK (solver.iterationCallback ().empty ());
+
+  // Monitor the iterations.
+  solver.setIterationCallback
+    (boost::bind (&monitor, output.get (), true, _1));
+  (*output) << solver.getMinimum<SolverError> ().what () << std::endl;
+
+  // Stop at the first iteration.
+  solver.reset ();
+  solver.setIterationCallback
+    (boost::bind (&monitor, output.get (), false, _1));
+  (*output) << solver.getMinimum<SolverError> ().what () << std::endl;
+
+  // The state is a view on the solver buffers.
+  Function::vector_t x (2);
+  x << 1., 2.;
+  Function::vector_t lambda (1);
+  lambda << 3.;
+  SolverState state (1, x, 4., 0.5, lambda);
+  BOOST_CHECK_EQUAL (state.x.data (), x.data ());
+  BOOST_CHECK_EQUAL (state.lambda.data (), lambda.data ());
+  (*output) << state << std::endl;
+
+  SolverState raw (2, x.data (), 2, 4., 0.);
+  BOOST_CHECK_EQUAL (raw.lambda.size (), 0);
+
+  solver.setIterationCallback (solver_t::callback_t ());
+  BOOST_CHECK (solver.iterationCallback ().empty ());
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
@@ -0,0 +1,224 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "shared-tests/common.hh"
+
+#include <cmath>
+#include <iostream>
+
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/mpl/vector.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/multi-start.hh>
+#include <roboptim/core/plugin-registry.hh>
+
+using namespace roboptim;
+
+typedef Solver<Function, boost::mpl::vector<Function> > solver_t;
+
+// f(x) = (x - 1)^2
+struct F : public Function
+{
+  F () : Function (1, 1, "(x - 1)^2")
+  {}
+
+  void impl_compute (result_t& result, const argument_t& argument)
+    const throw ()
+  {
+    result (0) = (argument[0] - 1.) * (argument[0] - 1.);
+  }
+};
+
+// Local "solver" converging to the closest integer: each integer is
+// a local minimum whose basin is [n - 0.5, n + 0.5).
+struct RoundingSolver : public solver_t
+{
+  explicit RoundingSolver (const problem_t& pb) throw ()
+    : solver_t (pb)
+  {}
+
+  void solve () throw ()
+  {
+    const problem_t& pb = problem ();
+    vector_t x = *pb.startingPoint ();
+    vector_t target (x.size ());
+    for (Function::size_type i = 0; i < x.size (); ++i)
+      target[i] = std::floor (x[i] + .5);
+
+    vector_t cost (1);
+    vector_t lambda;
+    for (Function::size_type k = 0; k < 30; ++k)
+      {
+	x += .5 * (target - x);
+	pb.function () (cost, x);
+	if (hasIterationCallback ()
+	    && !iterate (SolverState (k, x, cost[0], 0., lambda)))
+	  {
+	    result_ = SolverError ("stopped");
+	    return;
+	  }
+      }
+
+    Result res (x.size (), 1);
+    res.x = target;
+    pb.function () (res.value, target);
+    result_ = res;
+  }
+};
+
+namespace
+{
+  unsigned getSizeOfProblem ()
+  {
+    return sizeof (solver_t::problem_t);
+  }
+
+  solver_t* create (const solver_t::problem_t& pb)
+  {
+    return new RoundingSolver (pb);
+  }
+
+  void destroy (solver_t* p)
+  {
+    delete p;
+  }
+
+  StaticPluginRegistrar registrar
+  ("rounding", &getSizeOfProblem, &create, &destroy);
+} // end of anonymous namespace.
+
+// Task blocking a pool worker until released.
+struct Blocker
+{
+  Blocker () : released (false)
+  {}
+
+  void block ()
+  {
+    boost::mutex::scoped_lock lock (mutex);
+    while (!released)
+      condition.wait (lock);
+  }
+
+  void release ()
+  {
+    boost::mutex::scoped_lock lock (mutex);
+    released = true;
+    condition.notify_all ();
+  }
+
+  boost::mutex mutex;
+  boost::condition_variable condition;
+  bool released;
+};
+
+BOOST_AUTO_TEST_CASE (multi_start)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("multi-start");
+
+  F f;
+  solver_t::problem_t pb (f);
+  pb.argumentBounds ()[0] = Function::makeInterval (-2.4, 2.4);
+
+  // Latin hypercube: one point per stratum.
+  MultiStart<solver_t> sequential ("rounding", pb);
+  sequential.starts () = 12;
+  MultiStart<solver_t>::starts_t starts = sequential.sample ();
+  BOOST_REQUIRE_EQUAL (starts.size (), 12);
+  std::vector<bool> strata (12, false);
+  for (std::size_t i = 0; i < starts.size (); ++i)
+    {
+      std::size_t stratum =
+	static_cast<std::size_t> ((starts[i][0] + 2.4) / 4.8 * 12.);
+      BOOST_CHECK (!strata[stratum]);
+      strata[stratum] = true;
+    }
+
+  // Sequential runs: the minima are found once, the other runs are
+  // cancelled as soon as they reach a known basin.
+  sequential.basinRadius () = .1;
+  sequential.solve ();
+  BOOST_REQUIRE (sequential.best ());
+  (*output) << sequential << std::endl
+	    << "Best: " << sequential.best ()->x << std::endl;
+
+  std::size_t hits = 0;
+  for (std::size_t i = 0; i < sequential.minima ().size (); ++i)
+    hits += sequential.minima ()[i].hits;
+  BOOST_CHECK_EQUAL (hits + sequential.cancelled (), 12);
+
+  // Parallel runs find the same minima.
+  MultiStart<solver_t> parallel ("rounding", pb,
+				 boost::make_shared<ThreadPool> (4));
+  parallel.starts () = 12;
+  parallel.basinRadius () = .1;
+  parallel.solve ();
+  BOOST_REQUIRE_EQUAL (parallel.minima ().size (),
+		       sequential.minima ().size ());
+  for (std::size_t i = 0; i < parallel.minima ().size (); ++i)
+    BOOST_CHECK_EQUAL (parallel.minima ()[i].result.x[0],
+		       sequential.minima ()[i].result.x[0]);
+  BOOST_CHECK_EQUAL (parallel.failed (), 0);
+
+  // Without early cancellation, all the runs converge.
+  MultiStart<solver_t> full ("rounding", pb);
+  full.starts () = 12;
+  full.basinRadius () = 0.;
+  full.solve ();
+  BOOST_CHECK_EQUAL (full.cancelled (), 0);
+  BOOST_CHECK_EQUAL (full.minima ().size (), sequential.minima ().size ());
+
+  // Infinite bounds are sampled around the starting point.
+  solver_t::problem_t unbounded (f);
+  unbounded.startingPoint () = Function::vector_t::Constant (1, 10.);
+  MultiStart<solver_t> sampler ("rounding", unbounded);
+  starts = sampler.sample ();
+  for (std::size_t i = 0; i < starts.size (); ++i)
+    BOOST_CHECK (starts[i][0] >= 9. && starts[i][0] <= 11.);
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
+
+BOOST_AUTO_TEST_CASE (multi_start_shared_pool)
+{
+  F f;
+  solver_t::problem_t pb (f);
+  pb.argumentBounds ()[0] = Function::makeInterval (-2.4, 2.4);
+
+  // Unrelated tasks keep the pool busy: the runs only wait for each
+  // other, and the calling thread never executes the blocking tasks.
+  boost::shared_ptr<ThreadPool> pool = boost::make_shared<ThreadPool> (2);
+  Blocker blocker;
+  for (std::size_t i = 0; i < 4; ++i)
+    pool->submit (boost::bind (&Blocker::block, &blocker));
+
+  MultiStart<solver_t> shared ("rounding", pb, pool);
+  shared.starts () = 12;
+  shared.basinRadius () = .1;
+  shared.solve ();
+  BOOST_REQUIRE (shared.best ());
+  BOOST_CHECK_EQUAL (shared.best ()->x[0], 1.);
+  BOOST_CHECK_EQUAL (shared.failed (), 0);
+
+  blocker.release ();
+  pool->wait ();
+}
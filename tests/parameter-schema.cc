@@ -0,0 +1,157 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+#include <sstream>
+
+#include <boost/mpl/vector.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/parameter-schema.hh>
+#include <roboptim/core/solver-factory.hh>
+
+using namespace roboptim;
+
+typedef Solver<Function, boost::mpl::vector<Function> > solver_t;
+
+struct F : public Function
+{
+  F () : Function (1, 1, "x")
+  {}
+
+  void impl_compute (result_t& result, const argument_t& argument)
+    const throw ()
+  {
+    result (0) = argument[0];
+  }
+};
+
+// Solver declaring its parameters once and reading them by index.
+struct TestSolver : public solver_t
+{
+  explicit TestSolver (const problem_t& pb) throw ()
+    : solver_t (pb),
+      tolerance_ (declareParameter ("tolerance", "tolerance", 1e-6)),
+      iterations_ (declareParameter ("max-iterations", "iterations", 100)),
+      method_ (declareParameter ("method", "method", std::string ("bfgs")))
+  {}
+
+  void solve () throw ()
+  {
+    try
+      {
+	bindParameters ();
+      }
+    catch (const std::runtime_error& e)
+      {
+	result_ = SolverError (e.what ());
+	return;
+      }
+
+    Result res (1, 1);
+    res.x[0] = parameter (tolerance_) * parameter (iterations_);
+    res.value[0] = static_cast<double> (parameter (method_).size ());
+    result_ = res;
+  }
+
+  ParameterKey<double> tolerance_;
+  ParameterKey<int> iterations_;
+  ParameterKey<std::string> method_;
+};
+
+BOOST_AUTO_TEST_CASE (parameter_schema)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("parameter-schema");
+
+  F f;
+  solver_t::problem_t pb (f);
+  TestSolver solver (pb);
+
+  // Declaration.
+  const ParameterSchema& schema = solver.parameterSchema ();
+  BOOST_CHECK_EQUAL (schema.size (), 3);
+  BOOST_CHECK_EQUAL (schema.index ("method"), 2);
+  BOOST_CHECK_THROW (schema.index ("unknown"), std::runtime_error);
+  BOOST_CHECK_EQUAL (solver.getParameter<int> ("max-iterations"), 100);
+  solver.validateParameters ();
+
+  // Typed access, integers are accepted for floating-point values.
+  solver.parameters ()["tolerance"].value = 1;
+  (*output) << solver.getMinimum<Result> ().x << std::endl;
+
+  // Bulk validation.
+  solver.parameters ()["max-iterations"].value = 1.5;
+  solver.parameters ()["typo"].value = 1;
+  try
+    {
+      solver.validateParameters ();
+      BOOST_ERROR ("invalid parameters not detected");
+    }
+  catch (const std::runtime_error& e)
+    {
+      (*output) << e.what () << std::endl;
+    }
+  solver.reset ();
+  (*output) << solver.getMinimum<SolverError> ().what () << std::endl;
+  solver.parameters ().erase ("typo");
+
+  // Loading from a stream.
+  std::stringstream ss;
+  ss << "# Parameters file" << std::endl
+     << std::endl
+     << "tolerance = 0.5" << std::endl
+     << "  max-iterations=4  " << std::endl
+     << "method = trust region" << std::endl;
+  ParameterSchema::parameters_t parameters;
+  schema.load (parameters, ss);
+  (*output) << parameters["tolerance"].value << " "
+	    << parameters["max-iterations"].value << " "
+	    << parameters["method"].value << std::endl;
+
+  std::stringstream invalid;
+  invalid << "tolerance = abc" << std::endl
+	  << "max-iterations" << std::endl
+	  << "typo = 1" << std::endl
+	  << "method = line search" << std::endl;
+  try
+    {
+      schema.load (parameters, invalid);
+      BOOST_ERROR ("invalid file not detected");
+    }
+  catch (const std::runtime_error& e)
+    {
+      (*output) << e.what () << std::endl;
+    }
+  // Invalid files leave the parameters untouched.
+  BOOST_CHECK_EQUAL
+    (boost::get<std::string> (parameters["method"].value), "trust region");
+  BOOST_CHECK_THROW (solver.loadParameters ("does-not-exist.txt"),
+		     std::runtime_error);
+
+  // Missing parameters are reported instead of dereferencing end ().
+  SolverFactory<solver_t> factory ("dummy", pb);
+  BOOST_CHECK_THROW (factory ().getParameter<int> ("unknown"),
+		     std::runtime_error);
+  BOOST_CHECK_EQUAL (factory ().parameterSchema ().size (), 3);
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
@@ -0,0 +1,223 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+
+#include <boost/mpl/vector.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/linear-function.hh>
+#include <roboptim/core/numeric-linear-function.hh>
+#include <roboptim/core/plugin/lm.hh>
+#include <roboptim/core/solver-factory.hh>
+#include <roboptim/core/sum-of-c1-squares.hh>
+#include <roboptim/core/util.hh>
+
+using namespace roboptim;
+
+typedef Solver<DifferentiableFunction,
+	       boost::mpl::vector<LinearFunction, DifferentiableFunction> >
+solver_t;
+
+// Extended Rosenbrock residuals:
+// r_{2i} = 10 (x_{2i+1} - x_{2i}^2), r_{2i+1} = 1 - x_{2i}.
+struct Rosenbrock : public DifferentiableFunction
+{
+  explicit Rosenbrock (size_type n)
+    : DifferentiableFunction (n, n, "extended Rosenbrock residuals")
+  {}
+
+  void impl_compute (result_t& result, const argument_t& x)
+    const throw ()
+  {
+    for (size_type i = 0; i < inputSize (); i += 2)
+      {
+	result[i] = 10. * (x[i + 1] - x[i] * x[i]);
+	result[i + 1] = 1. - x[i];
+      }
+  }
+
+  void impl_gradient (gradient_t& gradient, const argument_t& x,
+		      size_type i) const throw ()
+  {
+    gradient = jacobian (x).row (i);
+  }
+
+  void impl_jacobian (jacobian_t& jacobian, const argument_t& x)
+    const throw ()
+  {
+    jacobian.setZero ();
+    for (size_type i = 0; i < inputSize (); i += 2)
+      {
+	jacobian (i, i) = -20. * x[i];
+	jacobian (i, i + 1) = 10.;
+	jacobian (i + 1, i) = -1.;
+      }
+  }
+};
+
+// Plain quadratic objective, not a sum of squares.
+struct Quadratic : public DifferentiableFunction
+{
+  Quadratic ()
+    : DifferentiableFunction (2, 1, "x^T x")
+  {}
+
+  void impl_compute (result_t& result, const argument_t& x)
+    const throw ()
+  {
+    result[0] = x.squaredNorm ();
+  }
+
+  void impl_gradient (gradient_t& gradient, const argument_t& x,
+		      size_type) const throw ()
+  {
+    gradient = 2. * x;
+  }
+};
+
+namespace
+{
+  // Count the iterations.
+  struct Counter
+  {
+    explicit Counter (unsigned& count)
+      : count_ (count)
+    {}
+
+    bool operator () (const SolverState&) const
+    {
+      ++count_;
+      return true;
+    }
+
+    unsigned& count_;
+  };
+
+  Function::vector_t
+  solve (solver_t& solver, const std::string& linearSolver,
+	 double sparseThreshold)
+  {
+    solver.parameters ()["lm.linear-solver"].value = linearSolver;
+    solver.parameters ()["lm.sparse-threshold"].value = sparseThreshold;
+    solver.reset ();
+
+    solver_t::result_t res = solver.minimum ();
+    BOOST_REQUIRE_EQUAL (res.which (), solver_t::SOLVER_VALUE);
+    const Result& result = boost::get<Result> (res);
+    BOOST_CHECK_SMALL (result.value[0], 1e-12);
+    return result.x;
+  }
+} // end of anonymous namespace.
+
+BOOST_AUTO_TEST_CASE (plugin_lm)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("plugin-lm");
+
+  // Rosenbrock, from the usual starting point.
+  boost::shared_ptr<Rosenbrock> residuals (new Rosenbrock (2));
+  SumOfC1Squares cost (residuals, "Rosenbrock");
+  solver_t::problem_t pb (cost);
+  Function::vector_t x (2);
+  x << -1.2, 1.;
+  pb.startingPoint () = x;
+
+  SolverFactory<solver_t> factory ("lm", pb);
+  solver_t& solver = factory ();
+  unsigned iterations = 0;
+  solver.setIterationCallback (Counter (iterations));
+
+  Function::vector_t ones = Function::vector_t::Ones (2);
+  BOOST_CHECK_SMALL ((solve (solver, "cholesky", 0.) - ones).norm (), 1e-6);
+  BOOST_CHECK_SMALL ((solve (solver, "qr", 0.) - ones).norm (), 1e-6);
+  (*output) << solver.getMinimum<Result> ().x << std::endl;
+
+  // Warm start from the solution: converged at the first iteration.
+  BOOST_CHECK (solver.setWarmStart (solver.minimum ()));
+  iterations = 0;
+  solve (solver, "cholesky", 0.);
+  BOOST_CHECK_EQUAL (iterations, 1);
+  solver.resetWarmStart ();
+
+  // Larger problem: the sparse path gives the same solution.
+  boost::shared_ptr<Rosenbrock> large (new Rosenbrock (40));
+  SumOfC1Squares largeCost (large, "extended Rosenbrock");
+  solver_t::problem_t largePb (largeCost);
+  Function::vector_t largeX (40);
+  for (Function::size_type i = 0; i < 40; i += 2)
+    largeX.segment (i, 2) = x;
+  largePb.startingPoint () = largeX;
+
+  SolverFactory<solver_t> largeFactory ("lm", largePb);
+  solver_t& largeSolver = largeFactory ();
+  const LevenbergMarquardtSolver& lm =
+    static_cast<const LevenbergMarquardtSolver&> (largeSolver);
+  Function::vector_t dense = solve (largeSolver, "cholesky", 0.);
+  BOOST_CHECK (!lm.sparse ());
+  Function::vector_t sparse = solve (largeSolver, "cholesky", 1.);
+  BOOST_CHECK (lm.sparse ());
+  BOOST_CHECK_SMALL ((dense - Function::vector_t::Ones (40)).norm (), 1e-6);
+  BOOST_CHECK_SMALL ((sparse - dense).norm (), 1e-6);
+
+  // The QR path never uses the sparse matrices.
+  Function::vector_t qr = solve (largeSolver, "qr", 1.);
+  BOOST_CHECK (!lm.sparse ());
+  BOOST_CHECK_SMALL ((qr - dense).norm (), 1e-6);
+
+  // The starting point is on a bound the gradient pushes against:
+  // the jacobian pattern changes when the variable is released.
+  largePb.argumentBounds ()[1] = Function::makeInterval (-2., 1.);
+  SolverFactory<solver_t> boundedLargeFactory ("lm", largePb);
+  solver_t& boundedLargeSolver = boundedLargeFactory ();
+  dense = solve (boundedLargeSolver, "cholesky", 0.);
+  sparse = solve (boundedLargeSolver, "cholesky", 1.);
+  BOOST_CHECK (static_cast<const LevenbergMarquardtSolver&>
+	       (boundedLargeSolver).sparse ());
+  BOOST_CHECK_SMALL ((sparse - dense).norm (), 1e-6);
+
+  // Bounds are enforced: the solution is on the bound.
+  pb.argumentBounds ()[0] = Function::makeInterval (-2., 0.5);
+  SolverFactory<solver_t> boundedFactory ("lm", pb);
+  const Result& bounded = boundedFactory ().getMinimum<Result> ();
+  (*output) << bounded.x[0] << " " << bounded.x[1] << std::endl;
+
+  // Unsupported problems.
+  Quadratic quadratic;
+  solver_t::problem_t quadraticPb (quadratic);
+  SolverFactory<solver_t> quadraticFactory ("lm", quadraticPb);
+  (*output) << quadraticFactory ().getMinimum<SolverError> ().what ()
+	    << std::endl;
+
+  solver_t::problem_t constrainedPb (cost);
+  Function::matrix_t a (1, 2);
+  a << 1., 1.;
+  Function::vector_t b (1);
+  b << -1.;
+  constrainedPb.addConstraint
+    (boost::shared_ptr<LinearFunction> (new NumericLinearFunction (a, b)),
+     Function::makeInterval (0., 0.));
+  SolverFactory<solver_t> constrainedFactory ("lm", constrainedPb);
+  (*output) << constrainedFactory ().getMinimum<SolverError> ().what ()
+	    << std::endl;
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
@@ -0,0 +1,154 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+
+#include <boost/mpl/vector.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/numeric-linear-function.hh>
+#include <roboptim/core/numeric-quadratic-function.hh>
+#include <roboptim/core/solver-factory.hh>
+#include <roboptim/core/warm-start.hh>
+
+using namespace roboptim;
+
+typedef Solver<QuadraticFunction, boost::mpl::vector<LinearFunction> >
+solver_t;
+
+namespace
+{
+  // Count the iterations.
+  struct Counter
+  {
+    explicit Counter (unsigned& count)
+      : count_ (count)
+    {}
+
+    bool operator () (const SolverState&) const
+    {
+      ++count_;
+      return true;
+    }
+
+    unsigned& count_;
+  };
+
+  void
+  display (std::ostream& o, const Function::vector_t& v)
+  {
+    for (Function::size_type i = 0; i < v.size (); ++i)
+      o << (i ? " " : "") << v[i];
+    o << std::endl;
+  }
+} // end of anonymous namespace.
+
+BOOST_AUTO_TEST_CASE (plugin_qp)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("plugin-qp");
+
+  // min (x0 - 1)^2 + (x1 - 2.5)^2
+  // s.t. x0 - 2 x1 + 2 >= 0, -x0 - 2 x1 + 6 >= 0, -x0 + 2 x1 + 2 >= 0
+  //      x >= 0
+  // (Nocedal and Wright, example 16.3).
+  Function::matrix_t g (2, 2);
+  g << 2., 0., 0., 2.;
+  Function::vector_t a (2);
+  a << -2., -5.;
+  NumericQuadraticFunction cost (g, a);
+
+  Function::matrix_t c (3, 2);
+  c << 1., -2., -1., -2., -1., 2.;
+  Function::vector_t d (3);
+  d << 2., 6., 2.;
+  Function::intervals_t positive
+    (3, Function::makeLowerInterval (0.));
+
+  solver_t::problem_t pb (cost);
+  pb.addConstraint
+    (boost::shared_ptr<LinearFunction> (new NumericLinearFunction (c, d)),
+     positive, solver_t::problem_t::scales_t (3, 1.));
+  pb.argumentBounds ()[0] = Function::makeLowerInterval (0.);
+  pb.argumentBounds ()[1] = Function::makeLowerInterval (0.);
+
+  SolverFactory<solver_t> factory ("qp", pb);
+  solver_t& solver = factory ();
+  unsigned iterations = 0;
+  solver.setIterationCallback (Counter (iterations));
+
+  Result result = solver.getMinimum<Result> ();
+  display (*output, result.x);
+  display (*output, result.value);
+  display (*output, result.lambda);
+  BOOST_CHECK_SMALL (result.x[0] - 1.4, 1e-12);
+  BOOST_CHECK_SMALL (result.x[1] - 1.7, 1e-12);
+  const unsigned coldIterations = iterations;
+
+  // Warm start: the active constraint is added directly.
+  solver.setWarmStart (WarmStart (result));
+  solver.reset ();
+  iterations = 0;
+  Result warm = solver.getMinimum<Result> ();
+  BOOST_CHECK_SMALL ((warm.x - result.x).norm (), 1e-12);
+  BOOST_CHECK (iterations <= coldIterations);
+  BOOST_CHECK_EQUAL (iterations, 2);
+
+  // Equality constraint and upper bound:
+  // min 1/2 |x|^2 s.t. x0 + x1 + x2 = 3, x0 <= 0.5.
+  NumericQuadraticFunction norm (Function::matrix_t::Identity (3, 3),
+				 Function::vector_t::Zero (3));
+  solver_t::problem_t equalityPb (norm);
+  equalityPb.addConstraint
+    (boost::shared_ptr<LinearFunction>
+     (new NumericLinearFunction (Function::matrix_t::Ones (1, 3),
+				 Function::vector_t::Zero (1))),
+     Function::makeInterval (3., 3.));
+  equalityPb.argumentBounds ()[0] = Function::makeUpperInterval (0.5);
+
+  SolverFactory<solver_t> equalityFactory ("qp", equalityPb);
+  Result equality = equalityFactory ().getMinimum<Result> ();
+  display (*output, equality.x);
+  display (*output, equality.lambda);
+
+  // Infeasible problem: x0 >= 1 and x0 <= 0.
+  solver_t::problem_t infeasiblePb (norm);
+  Function::matrix_t e0 = Function::matrix_t::Zero (1, 3);
+  e0 (0, 0) = 1.;
+  infeasiblePb.addConstraint
+    (boost::shared_ptr<LinearFunction>
+     (new NumericLinearFunction (e0, Function::vector_t::Zero (1))),
+     Function::makeLowerInterval (1.));
+  infeasiblePb.argumentBounds ()[0] = Function::makeUpperInterval (0.);
+  SolverFactory<solver_t> infeasibleFactory ("qp", infeasiblePb);
+  (*output) << infeasibleFactory ().getMinimum<SolverError> ().what ()
+	    << std::endl;
+
+  // The hessian has to be positive definite.
+  NumericQuadraticFunction concave (-Function::matrix_t::Identity (2, 2),
+				    Function::vector_t::Zero (2));
+  solver_t::problem_t concavePb (concave);
+  SolverFactory<solver_t> concaveFactory ("qp", concavePb);
+  (*output) << concaveFactory ().getMinimum<SolverError> ().what ()
+	    << std::endl;
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
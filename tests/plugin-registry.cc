@@ -0,0 +1,96 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+
+#include <boost/bind.hpp>
+#include <boost/mpl/vector.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/plugin-registry.hh>
+#include <roboptim/core/solver-factory.hh>
+
+using namespace roboptim;
+
+typedef Solver<Function, boost::mpl::vector<Function> > solver_t;
+
+struct F : public Function
+{
+  F () : Function (1, 1, "x")
+  {}
+
+  void impl_compute (result_t& result, const argument_t& argument)
+    const throw ()
+  {
+    result (0) = argument[0];
+  }
+};
+
+void solve (const solver_t::problem_t* pb)
+{
+  for (unsigned i = 0; i < 10; ++i)
+    {
+      SolverFactory<solver_t> factory ("dummy", *pb);
+      factory ().solve ();
+    }
+}
+
+BOOST_AUTO_TEST_CASE (plugin_registry)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("plugin-registry");
+
+  PluginRegistry& registry = PluginRegistry::instance ();
+  BOOST_CHECK_EQUAL (&registry, &PluginRegistry::instance ());
+
+  registry.preload ("dummy");
+  (*output) << "Loaded: " << registry.isLoaded ("dummy") << std::endl
+	    << "References: " << registry.references ("dummy") << std::endl;
+
+  F f;
+  solver_t::problem_t pb (f);
+  {
+    SolverFactory<solver_t> factory ("dummy", pb);
+    SolverFactory<solver_t> factory2 ("dummy", pb);
+    (*output) << "References: " << registry.references ("dummy") << std::endl;
+
+    // A referenced plug-in cannot be unloaded.
+    BOOST_CHECK (!registry.unload ("dummy"));
+  }
+  (*output) << "References: " << registry.references ("dummy") << std::endl;
+
+  // Concurrent factories share the same module.
+  boost::thread_group threads;
+  for (unsigned i = 0; i < 4; ++i)
+    threads.create_thread (boost::bind (&solve, &pb));
+  threads.join_all ();
+  BOOST_CHECK_EQUAL (registry.references ("dummy"), 0);
+
+  BOOST_CHECK (registry.unload ("dummy"));
+  (*output) << "Loaded: " << registry.isLoaded ("dummy") << std::endl;
+
+  // Unknown plug-ins are reported.
+  BOOST_CHECK_THROW (registry.preload ("does-not-exist"),
+		     std::runtime_error);
+  BOOST_CHECK (!registry.isLoaded ("does-not-exist"));
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
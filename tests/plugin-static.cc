@@ -0,0 +1,79 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+#include <stdexcept>
+
+#include <boost/mpl/vector.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/plugin-registry.hh>
+#include <roboptim/core/solver-factory.hh>
+
+using namespace roboptim;
+
+typedef Solver<Function, boost::mpl::vector<Function> > solver_t;
+
+struct F : public Function
+{
+  F () : Function (1, 1, "x")
+  {}
+
+  void impl_compute (result_t& result, const argument_t& argument)
+    const throw ()
+  {
+    result (0) = argument[0];
+  }
+};
+
+BOOST_AUTO_TEST_CASE (plugin_static)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("plugin-static");
+
+  PluginRegistry& registry = PluginRegistry::instance ();
+
+  // Built-in plug-ins are registered before main is entered.
+  (*output) << "Static: " << registry.isStatic ("dummy") << std::endl
+	    << "Loaded: " << registry.isLoaded ("dummy") << std::endl;
+  BOOST_CHECK (registry.isStatic ("dummy-laststate"));
+
+  F f;
+  solver_t::problem_t pb (f);
+  {
+    SolverFactory<solver_t> factory ("dummy", pb);
+    (*output) << "References: " << registry.references ("dummy") << std::endl;
+    factory ().solve ();
+  }
+  (*output) << "References: " << registry.references ("dummy") << std::endl;
+
+  // Static plug-ins are never unloaded.
+  BOOST_CHECK (!registry.unload ("dummy"));
+  (*output) << "Loaded: " << registry.isLoaded ("dummy") << std::endl;
+
+  // Plug-ins which are neither registered nor installed cannot be
+  // found (without dynamic loading, nothing else can be found).
+  BOOST_CHECK_THROW (registry.preload ("no-such-plugin"),
+		     std::runtime_error);
+  BOOST_CHECK (!registry.isLoaded ("no-such-plugin"));
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
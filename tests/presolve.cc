@@ -0,0 +1,472 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+
+#include <boost/make_shared.hpp>
+#include <boost/mpl/vector.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/numeric-linear-function.hh>
+#include <roboptim/core/numeric-quadratic-function.hh>
+#include <roboptim/core/presolve.hh>
+#include <roboptim/core/problem.hh>
+#include <roboptim/core/result.hh>
+#include <roboptim/core/solver-factory.hh>
+#include <roboptim/core/sparse-numeric-linear-function.hh>
+#include <roboptim/core/util.hh>
+
+using namespace roboptim;
+
+typedef Problem<DifferentiableFunction,
+		boost::mpl::vector<LinearFunction, DifferentiableFunction> >
+problem_t;
+
+// f(x) = x0^2 + x1^2 + x2^2 + x3^2
+struct F : public DifferentiableFunction
+{
+  F () : DifferentiableFunction (4, 1, "x^T x")
+  {}
+
+  void impl_compute (result_t& res, const argument_t& x) const throw ()
+  {
+    res[0] = x.squaredNorm ();
+  }
+
+  void impl_gradient (gradient_t& grad, const argument_t& x,
+		      size_type) const throw ()
+  {
+    grad = 2. * x;
+  }
+};
+
+// g(x) = x0 * x1 * x2
+struct G : public DifferentiableFunction
+{
+  G () : DifferentiableFunction (4, 1, "x0 * x1 * x2")
+  {}
+
+  void impl_compute (result_t& res, const argument_t& x) const throw ()
+  {
+    res[0] = x[0] * x[1] * x[2];
+  }
+
+  void impl_gradient (gradient_t& grad, const argument_t& x,
+		      size_type) const throw ()
+  {
+    grad.setZero ();
+    grad[0] = x[1] * x[2];
+    grad[1] = x[0] * x[2];
+    grad[2] = x[0] * x[1];
+  }
+};
+
+boost::shared_ptr<LinearFunction>
+makeLinear (double a0, double a1, double a2, double a3, double b0)
+{
+  NumericLinearFunction::matrix_t a (1, 4);
+  a << a0, a1, a2, a3;
+  NumericLinearFunction::vector_t b (1);
+  b << b0;
+  return boost::make_shared<NumericLinearFunction> (a, b);
+}
+
+BOOST_AUTO_TEST_CASE (presolve)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("presolve");
+
+  F f;
+  problem_t pb (f);
+
+  // x1 is fixed.
+  pb.argumentBounds ()[1] = Function::makeInterval (2., 2.);
+
+  Function::vector_t x0 (4);
+  x0 << 1., 2., 3., 4.;
+  pb.startingPoint () = x0;
+
+  // x0 + x2 >= 1 and its duplicate x0 + x2 <= 5.
+  pb.addConstraint (makeLinear (1., 0., 1., 0., 0.),
+		    Function::makeLowerInterval (1.));
+  pb.addConstraint (makeLinear (1., 0., 1., 0., 0.),
+		    Function::makeUpperInterval (5.));
+  // x0 + x1 - x2 in [0, 10]: reduced to x0 - x2 + 2.
+  pb.addConstraint (makeLinear (1., 1., -1., 0., 0.),
+		    Function::makeInterval (0., 10.));
+  // 2 x3 - 4 in [0, 2] i.e. x3 in [2, 3].
+  pb.addConstraint (makeLinear (0., 0., 0., 2., -4.),
+		    Function::makeInterval (0., 2.));
+  // Unbounded constraint.
+  pb.addConstraint (boost::static_pointer_cast<DifferentiableFunction>
+		    (boost::make_shared<G> ()),
+		    Function::makeInfiniteInterval ());
+  // Non-linear constraint.
+  pb.addConstraint (boost::static_pointer_cast<DifferentiableFunction>
+		    (boost::make_shared<G> ()),
+		    Function::makeInterval (0., 10.));
+
+  Presolve<problem_t> presolve (pb);
+  (*output) << presolve << std::endl;
+
+  const problem_t& reduced = presolve.problem ();
+  BOOST_CHECK_EQUAL (reduced.function ().inputSize (), 3);
+  BOOST_CHECK_EQUAL (reduced.constraints ().size (), 3);
+  BOOST_CHECK (!presolve.infeasible ());
+
+  (*output) << "Free variables: " << presolve.freeVariables () << std::endl
+	    << "Constraints map: " << presolve.constraintsMap () << std::endl
+	    << "Argument bounds: " << reduced.argumentBounds () << std::endl
+	    << "Starting point: " << *reduced.startingPoint () << std::endl;
+
+  // Merged intervals.
+  BOOST_CHECK_EQUAL (reduced.boundsVector ()[0][0].first, 1.);
+  BOOST_CHECK_EQUAL (reduced.boundsVector ()[0][0].second, 5.);
+
+  // The reduced functions are the restrictions of the original ones.
+  Function::vector_t y (3);
+  y << 1., 3., 2.5;
+  Function::vector_t x = presolve.expand (y);
+  (*output) << "Expanded: " << x << std::endl;
+  BOOST_CHECK_EQUAL (reduced.function () (y)[0], f (x)[0]);
+
+  G g;
+  const DifferentiableFunction& gr =
+    *boost::get<boost::shared_ptr<DifferentiableFunction> >
+    (reduced.constraints ()[2]);
+  BOOST_CHECK_EQUAL (gr (y)[0], g (x)[0]);
+  BOOST_CHECK_EQUAL (gr.gradient (y)[1], g.gradient (x)[2]);
+  Function::matrix_t jacobian = gr.jacobian (y);
+  BOOST_CHECK_EQUAL (jacobian (0, 0), g.gradient (x)[0]);
+  BOOST_CHECK_EQUAL (jacobian (0, 1), g.gradient (x)[2]);
+  BOOST_CHECK_EQUAL (jacobian (0, 2), g.gradient (x)[3]);
+  const LinearFunction& linear =
+    *boost::get<boost::shared_ptr<LinearFunction> >
+    (reduced.constraints ()[1]);
+  BOOST_CHECK_EQUAL (linear (y)[0], 0.);
+
+  // Restricting a function keeps its structure.
+  std::vector<Function::size_type> free (presolve.freeVariables ());
+  Restriction<LinearFunction> restricted
+    (makeLinear (1., 1., -1., 0., 0.), x, free);
+  BOOST_CHECK (restricted.hasStructure (Function::LINEAR));
+
+  // Postsolve.
+  Result result (3, 1);
+  result.x = y;
+  result.value = reduced.function () (y);
+  result.lambda.resize (3);
+  result.lambda << 1., 2., 3.;
+  Result full = presolve.postsolve (result);
+  BOOST_CHECK_EQUAL (full.inputSize, 4);
+  (*output) << "Postsolved X: " << full.x << std::endl
+	    << "Postsolved constraints: " << full.constraints << std::endl
+	    << "Postsolved lambda: " << full.lambda << std::endl;
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
+
+BOOST_AUTO_TEST_CASE (presolve_infeasible)
+{
+  F f;
+  problem_t pb (f);
+  pb.argumentBounds ()[3] = Function::makeInterval (0., 1.);
+
+  // 2 x3 - 4 >= 0 contradicts x3 <= 1.
+  pb.addConstraint (makeLinear (0., 0., 0., 2., -4.),
+		    Function::makeLowerInterval (0.));
+
+  Presolve<problem_t> presolve (pb);
+  BOOST_CHECK (presolve.infeasible ());
+}
+
+boost::shared_ptr<LinearFunction>
+makeSparse (Function::size_type rows, const Function::matrix_t& dense,
+	    double b0)
+{
+  SparseNumericLinearFunction::sparseMatrix_t a = dense.sparseView ();
+  a.makeCompressed ();
+  return boost::make_shared<SparseNumericLinearFunction>
+    (a, Function::vector_t::Constant (rows, b0));
+}
+
+BOOST_AUTO_TEST_CASE (presolve_sparse)
+{
+  F f;
+  problem_t pb (f);
+
+  // x1 is fixed.
+  pb.argumentBounds ()[1] = Function::makeInterval (2., 2.);
+
+  // x0 + x1 + x3 <= 10 and its tighter duplicate x0 + x1 + x3 <= 8.
+  Function::matrix_t sum (1, 4);
+  sum << 1., 1., 0., 1.;
+  pb.addConstraint (makeSparse (1, sum, 0.),
+		    Function::makeUpperInterval (10.));
+  pb.addConstraint (makeSparse (1, sum, 0.),
+		    Function::makeUpperInterval (8.));
+  // 2 x1 + 4 x2 - 2 in [0, 8]: reduced to 4 x2 + 2, i.e. x2 in [-0.5, 1.5].
+  Function::matrix_t single (1, 4);
+  single << 0., 2., 4., 0.;
+  pb.addConstraint (makeSparse (1, single, -2.),
+		    Function::makeInterval (0., 8.));
+
+  Presolve<problem_t> presolve (pb);
+  const problem_t& reduced = presolve.problem ();
+  BOOST_CHECK (!presolve.infeasible ());
+  BOOST_REQUIRE_EQUAL (reduced.constraints ().size (), 1u);
+  BOOST_CHECK_EQUAL (reduced.boundsVector ()[0][0].second, 8.);
+  BOOST_CHECK_EQUAL (reduced.argumentBounds ()[1].first, -.5);
+  BOOST_CHECK_EQUAL (reduced.argumentBounds ()[1].second, 1.5);
+
+  // The reduced constraint is still sparse, the fixed variable moved
+  // into the constant term.
+  boost::shared_ptr<SparseNumericLinearFunction> sparse =
+    boost::dynamic_pointer_cast<SparseNumericLinearFunction>
+    (boost::get<boost::shared_ptr<LinearFunction> >
+     (reduced.constraints ()[0]));
+  BOOST_REQUIRE (sparse);
+  BOOST_CHECK_EQUAL (sparse->A ().cols (), 3);
+  BOOST_CHECK_EQUAL (sparse->A ().nonZeros (), 2);
+  BOOST_CHECK_EQUAL (sparse->b ()[0], 2.);
+
+  Function::vector_t y (3);
+  y << 1., 0.5, 3.;
+  BOOST_CHECK_EQUAL ((*sparse) (y)[0],
+		     (*makeSparse (1, sum, 0.)) (presolve.expand (y))[0]);
+}
+
+BOOST_AUTO_TEST_CASE (presolve_qp_multipliers)
+{
+  typedef Solver<QuadraticFunction, boost::mpl::vector<LinearFunction> >
+    solver_t;
+  typedef solver_t::problem_t qpProblem_t;
+
+  // min (x0 - 3)^2 + (x1 - 3)^2 + (x2 - 1)^2
+  Function::vector_t a (3);
+  a << -6., -6., -2.;
+  NumericQuadraticFunction cost (2. * Function::matrix_t::Identity (3, 3), a);
+  qpProblem_t pb (cost);
+
+  // x2 is fixed.
+  pb.argumentBounds ()[2] = Function::makeInterval (1., 1.);
+
+  // x0 + x1 <= 4 and its tighter duplicate x0 + x1 <= 3.
+  Function::matrix_t sum (1, 3);
+  sum << 1., 1., 0.;
+  pb.addConstraint
+    (boost::shared_ptr<LinearFunction>
+     (new NumericLinearFunction (sum, Function::vector_t::Zero (1))),
+     Function::makeUpperInterval (4.));
+  pb.addConstraint
+    (boost::shared_ptr<LinearFunction>
+     (new NumericLinearFunction (sum, Function::vector_t::Zero (1))),
+     Function::makeUpperInterval (3.));
+  // 2 x0 <= 2, turned into x0 <= 1.
+  Function::matrix_t twice (1, 3);
+  twice << 2., 0., 0.;
+  pb.addConstraint
+    (boost::shared_ptr<LinearFunction>
+     (new NumericLinearFunction (twice, Function::vector_t::Zero (1))),
+     Function::makeUpperInterval (2.));
+
+  Presolve<qpProblem_t> presolve (pb);
+  BOOST_CHECK_EQUAL (presolve.problem ().constraints ().size (), 1u);
+
+  // The qp plug-in returns the constraints multipliers followed by
+  // the argument bounds multipliers.
+  SolverFactory<solver_t> factory ("qp", presolve.problem ());
+  Result reduced = factory ().getMinimum<Result> ();
+  BOOST_CHECK_EQUAL (reduced.lambda.size (), 3);
+
+  Result full = presolve.postsolve (reduced);
+  BOOST_CHECK_SMALL (full.x[0] - 1., 1e-12);
+  BOOST_CHECK_SMALL (full.x[1] - 2., 1e-12);
+  BOOST_CHECK_EQUAL (full.x[2], 1.);
+
+  // Three constraint rows, then three argument bounds: the merged
+  // interval comes from the duplicate and the bound on x0 from the
+  // 2 x0 <= 2 row.
+  BOOST_REQUIRE_EQUAL (full.lambda.size (), 6);
+  BOOST_CHECK_EQUAL (full.lambda[0], 0.);
+  BOOST_CHECK_SMALL (full.lambda[1] + 2., 1e-12);
+  BOOST_CHECK_SMALL (full.lambda[2] + 1., 1e-12);
+  BOOST_CHECK_EQUAL (full.lambda[3], 0.);
+  BOOST_CHECK_EQUAL (full.lambda[4], 0.);
+  BOOST_CHECK_EQUAL (full.lambda[5], 0.);
+
+  // Multipliers in an unknown layout are dropped.
+  reduced.lambda.resize (2);
+  BOOST_CHECK_EQUAL (presolve.postsolve (reduced).lambda.size (), 0);
+}
+
+BOOST_AUTO_TEST_CASE (presolve_fixed_multipliers)
+{
+  typedef Solver<QuadraticFunction, boost::mpl::vector<LinearFunction> >
+    solver_t;
+  typedef solver_t::problem_t qpProblem_t;
+
+  // min (x0 - 3)^2 + (x1 - 3)^2 + (x2 - 1)^2
+  Function::vector_t a (3);
+  a << -6., -6., -2.;
+  NumericQuadraticFunction cost (2. * Function::matrix_t::Identity (3, 3), a);
+  qpProblem_t pb (cost);
+
+  // x2 is fixed away from its unconstrained optimum: its reduced cost
+  // is not zero.
+  pb.argumentBounds ()[2] = Function::makeInterval (2., 2.);
+
+  // x0 + x1 + x2 <= 4, reduced to x0 + x1 <= 2.
+  Function::matrix_t sum (1, 3);
+  sum << 1., 1., 1.;
+  pb.addConstraint
+    (boost::shared_ptr<LinearFunction>
+     (new NumericLinearFunction (sum, Function::vector_t::Zero (1))),
+     Function::makeUpperInterval (4.));
+
+  Presolve<qpProblem_t> presolve (pb);
+  SolverFactory<solver_t> factory ("qp", presolve.problem ());
+  Result full = presolve.postsolve (factory ().getMinimum<Result> ());
+  BOOST_REQUIRE_EQUAL (full.lambda.size (), 4);
+  BOOST_CHECK_SMALL (full.x[0] - 1., 1e-12);
+  BOOST_CHECK_SMALL (full.x[1] - 1., 1e-12);
+
+  // grad f (x) = (-4, -4, 2), the constraint multiplier is -4 and the
+  // fixed variable bound multiplier is 2 - (-4) = 6.
+  BOOST_CHECK_SMALL (full.lambda[0] + 4., 1e-12);
+  BOOST_CHECK_EQUAL (full.lambda[1], 0.);
+  BOOST_CHECK_EQUAL (full.lambda[2], 0.);
+  BOOST_CHECK_SMALL (full.lambda[3] - 6., 1e-12);
+
+  // Stationarity of the original problem.
+  Function::vector_t residual = cost.gradient (full.x, 0)
+    - sum.transpose () * full.lambda.head (1) - full.lambda.tail (3);
+  BOOST_CHECK_SMALL (residual.cwiseAbs ().maxCoeff (), 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE (presolve_duplicate_rows)
+{
+  F f;
+  problem_t pb (f);
+
+  // x0 + x2 <= 4 and 2 x0 + 2 x2 <= 6 in the same constraint.
+  Function::matrix_t a (2, 4);
+  a << 1., 0., 1., 0.,
+    2., 0., 2., 0.;
+  problem_t::intervals_t bounds;
+  bounds.push_back (Function::makeUpperInterval (4.));
+  bounds.push_back (Function::makeUpperInterval (6.));
+  pb.addConstraint
+    (boost::shared_ptr<LinearFunction>
+     (new NumericLinearFunction (a, Function::vector_t::Zero (2))),
+     bounds, problem_t::scales_t (2, 1.));
+  // -x0 - x2 <= -1, stored as a sparse constraint.
+  Function::matrix_t opposite (1, 4);
+  opposite << -1., 0., -1., 0.;
+  pb.addConstraint (makeSparse (1, opposite, 0.),
+		    Function::makeUpperInterval (-1.));
+  // x0 + x2 in [0, 10] (duplicate) and x0 - x3 in [0, 1] (kept).
+  Function::matrix_t c (2, 4);
+  c << 1., 0., 1., 0.,
+    1., 0., 0., -1.;
+  pb.addConstraint
+    (boost::shared_ptr<LinearFunction>
+     (new NumericLinearFunction (c, Function::vector_t::Zero (2))),
+     problem_t::intervals_t (2, Function::makeInterval (0., 10.)),
+     problem_t::scales_t (2, 1.));
+
+  Presolve<problem_t> presolve (pb);
+  const problem_t& reduced = presolve.problem ();
+  BOOST_CHECK (!presolve.infeasible ());
+
+  // x0 + x2 in [1, 3] and x0 - x3 in [0, 10].
+  BOOST_REQUIRE_EQUAL (reduced.constraints ().size (), 2u);
+  BOOST_REQUIRE_EQUAL (reduced.boundsVector ()[0].size (), 1u);
+  BOOST_CHECK_EQUAL (reduced.boundsVector ()[0][0].first, 1.);
+  BOOST_CHECK_EQUAL (reduced.boundsVector ()[0][0].second, 3.);
+  BOOST_REQUIRE_EQUAL (reduced.boundsVector ()[1].size (), 1u);
+  BOOST_CHECK_EQUAL (reduced.boundsVector ()[1][0].second, 10.);
+  BOOST_CHECK_EQUAL (presolve.constraintsMap ()[1], 2u);
+
+  const LinearFunction& kept =
+    *boost::get<boost::shared_ptr<LinearFunction> >
+    (reduced.constraints ()[1]);
+  Function::vector_t x (4);
+  x << 3., 1., 0., 2.;
+  BOOST_CHECK_EQUAL (kept (x)[0], 1.);
+
+  // Multipliers of the merged bounds move to the duplicates, divided
+  // by the ratio of the rows.
+  Result result (4, 1);
+  result.x = x;
+  result.value = f (x);
+  result.lambda.resize (2);
+  result.lambda << 1., 0.;
+  Result full = presolve.postsolve (result);
+  BOOST_REQUIRE_EQUAL (full.lambda.size (), 5);
+  BOOST_CHECK_EQUAL (full.lambda[1], .5);
+  BOOST_CHECK_EQUAL (full.lambda[2], 0.);
+
+  x << 1., 1., 0., 2.;
+  result.x = x;
+  full = presolve.postsolve (result);
+  BOOST_CHECK_EQUAL (full.lambda[1], 0.);
+  BOOST_CHECK_EQUAL (full.lambda[2], -1.);
+}
+
+BOOST_AUTO_TEST_CASE (presolve_duplicate_rows_tolerance)
+{
+  F f;
+  problem_t pb (f);
+
+  // Rows x0 + k/7 x1 <= 4, each followed by a scaled duplicate
+  // perturbed below the tolerance.
+  const Function::size_type n = 500;
+  Function::matrix_t a = Function::matrix_t::Zero (2 * n, 4);
+  for (Function::size_type k = 0; k < n; ++k)
+    {
+      const Function::value_type c = static_cast<Function::value_type> (k) / 7.;
+      a (2 * k, 0) = 1.;
+      a (2 * k, 1) = c;
+      a (2 * k + 1, 0) = 2.;
+      a (2 * k + 1, 1) = 2. * c + 1e-12;
+    }
+  pb.addConstraint
+    (boost::shared_ptr<LinearFunction>
+     (new NumericLinearFunction (a, Function::vector_t::Zero (2 * n))),
+     problem_t::intervals_t (2 * n, Function::makeUpperInterval (4.)),
+     problem_t::scales_t (2 * n, 1.));
+
+  // Exact comparison keeps the perturbed rows.
+  Presolve<problem_t> exact (pb);
+  BOOST_REQUIRE_EQUAL (exact.problem ().constraints ().size (), 1u);
+  BOOST_CHECK_EQUAL (exact.problem ().boundsVector ()[0].size (),
+		     static_cast<std::size_t> (2 * n));
+
+  // With a tolerance, each duplicate is merged into its row and its
+  // upper bound 4 / 2 is kept.
+  Presolve<problem_t> presolve (pb, 1e-9);
+  const problem_t& reduced = presolve.problem ();
+  BOOST_REQUIRE_EQUAL (reduced.constraints ().size (), 1u);
+  BOOST_REQUIRE_EQUAL (reduced.boundsVector ()[0].size (),
+		       static_cast<std::size_t> (n));
+  for (std::size_t r = 0; r < static_cast<std::size_t> (n); ++r)
+    BOOST_CHECK_EQUAL (reduced.boundsVector ()[0][r].second, 2.);
+}
@@ -0,0 +1,142 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+
+#include <boost/make_shared.hpp>
+#include <boost/mpl/vector.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/numeric-linear-function.hh>
+#include <roboptim/core/problem.hh>
+#include <roboptim/core/scaling.hh>
+#include <roboptim/core/util.hh>
+
+using namespace roboptim;
+
+typedef Problem<DifferentiableFunction,
+		boost::mpl::vector<LinearFunction, DifferentiableFunction> >
+problem_t;
+
+// f(x) = 1e-2 x0^2 + 1e2 x1^2
+struct F : public DifferentiableFunction
+{
+  F () : DifferentiableFunction (2, 1, "1e-2 x0^2 + 1e2 x1^2")
+  {}
+
+  void impl_compute (result_t& res, const argument_t& x) const throw ()
+  {
+    res[0] = 1e-2 * x[0] * x[0] + 1e2 * x[1] * x[1];
+  }
+
+  void impl_gradient (gradient_t& grad, const argument_t& x,
+		      size_type) const throw ()
+  {
+    grad[0] = 2e-2 * x[0];
+    grad[1] = 2e2 * x[1];
+  }
+};
+
+// g(x) = (1e4 x0 x1, 1e-4 x1^2)
+struct G : public DifferentiableFunction
+{
+  G () : DifferentiableFunction (2, 2, "(1e4 x0 x1, 1e-4 x1^2)")
+  {}
+
+  void impl_compute (result_t& res, const argument_t& x) const throw ()
+  {
+    res[0] = 1e4 * x[0] * x[1];
+    res[1] = 1e-4 * x[1] * x[1];
+  }
+
+  void impl_gradient (gradient_t& grad, const argument_t& x,
+		      size_type functionId) const throw ()
+  {
+    grad.setZero ();
+    if (functionId == 0)
+      {
+	grad[0] = 1e4 * x[1];
+	grad[1] = 1e4 * x[0];
+      }
+    else
+      grad[1] = 2e-4 * x[1];
+  }
+};
+
+BOOST_AUTO_TEST_CASE (scaling)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("scaling");
+
+  F f;
+  problem_t pb (f);
+  pb.argumentBounds ()[0] = Function::makeInterval (0., 2.);
+  pb.argumentBounds ()[1] = Function::makeLowerInterval (1.);
+
+  NumericLinearFunction::matrix_t a (1, 2);
+  a << 1e3, 1e-1;
+  NumericLinearFunction::vector_t b (1);
+  b << 0.;
+  pb.addConstraint (boost::static_pointer_cast<LinearFunction>
+		    (boost::make_shared<NumericLinearFunction> (a, b)),
+		    Function::makeLowerInterval (0.));
+
+  problem_t::intervals_t bounds (2, Function::makeLowerInterval (0.));
+  problem_t::scales_t scales (2, 1.);
+  pb.addConstraint (boost::static_pointer_cast<DifferentiableFunction>
+		    (boost::make_shared<G> ()), bounds, scales);
+
+  // No sample: the point (1, 1) is deduced from the bounds.
+  Scaling<problem_t> scaling (pb);
+  scaling.compute ();
+  (*output) << scaling << std::endl;
+
+  // The linear constraint row spans four orders of magnitude: the
+  // best achievable ratio is 1e4.
+  BOOST_CHECK_CLOSE (scaling.ratio ().first, 5e7, 1e-6);
+  BOOST_CHECK_CLOSE (scaling.ratio ().second, 1e4, 1e-6);
+
+  scaling.apply (pb);
+  BOOST_CHECK (pb.argumentScales () == scaling.argumentScales ());
+  BOOST_CHECK (pb.scalesVector () == scaling.scalesVector ());
+
+  // Scales are bounded.
+  Scaling<problem_t> bounded (pb);
+  Function::vector_t x (2);
+  x << 1., 1.;
+  bounded.addSample (x);
+  x << 2., 3.;
+  bounded.addSample (x);
+  bounded.compute (10, 1e-2, 1e2);
+  for (std::size_t i = 0; i < bounded.scalesVector ().size (); ++i)
+    for (std::size_t j = 0; j < bounded.scalesVector ()[i].size (); ++j)
+      {
+	BOOST_CHECK (bounded.scalesVector ()[i][j] >= 1e-2);
+	BOOST_CHECK (bounded.scalesVector ()[i][j] <= 1e2);
+      }
+
+  // The ratio is computed with the clamped scales.
+  Scaling<problem_t> unscaled (pb);
+  unscaled.compute (10, 1., 1.);
+  BOOST_CHECK_EQUAL (unscaled.costScale (), 1.);
+  BOOST_CHECK_EQUAL (unscaled.ratio ().second, unscaled.ratio ().first);
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
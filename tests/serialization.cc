@@ -0,0 +1,241 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "shared-tests/common.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+#include <boost/cstdint.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/result-with-warnings.hh>
+#include <roboptim/core/serialization.hh>
+
+using namespace roboptim;
+
+typedef GenericSolver::result_t result_t;
+
+std::vector<result_t> outcomes ()
+{
+  std::vector<result_t> results;
+
+  Result res (2, 1);
+  res.x << 1., 2.;
+  res.value << 3.;
+  res.constraints = Result::vector_t::Constant (3, 4.);
+  res.lambda = Result::vector_t::Constant (3, 5.);
+  results.push_back (res);
+
+  ResultWithWarnings warnings (2, 1);
+  warnings.x << 6., 7.;
+  warnings.value << 8.;
+  warnings.warnings.push_back (SolverWarning ("first warning"));
+  warnings.warnings.push_back (SolverWarning ("second, longer, warning"));
+  results.push_back (warnings);
+
+  results.push_back (SolverError ("no last state"));
+  results.push_back (SolverError ("with last state", res));
+  results.push_back (NoSolution ());
+  return results;
+}
+
+std::string readFile (const std::string& filename)
+{
+  std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+  return std::string (std::istreambuf_iterator<char> (file),
+		      std::istreambuf_iterator<char> ());
+}
+
+void writeFile (const std::string& filename, const std::string& data)
+{
+  std::ofstream file (filename.c_str (),
+		      std::ios::out | std::ios::binary | std::ios::trunc);
+  file.write (data.data (), static_cast<std::streamsize> (data.size ()));
+}
+
+void patch (std::string& data, std::size_t offset, boost::uint64_t value)
+{
+  std::memcpy (&data[offset], &value, sizeof (value));
+}
+
+BOOST_AUTO_TEST_CASE (serialization)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("serialization");
+
+  std::vector<result_t> results = outcomes ();
+
+  // Streams.
+  std::stringstream ss (std::ios::in | std::ios::out | std::ios::binary);
+  for (std::size_t i = 0; i < results.size (); ++i)
+    writeResult (ss, results[i]);
+  for (std::size_t i = 0; i < results.size (); ++i)
+    {
+      result_t result = readResult (ss);
+      BOOST_CHECK_EQUAL (result.which (), results[i].which ());
+      (*output) << result << std::endl;
+    }
+  BOOST_CHECK_THROW (readResult (ss), std::runtime_error);
+
+  std::stringstream garbage ("not a serialized result");
+  BOOST_CHECK_THROW (readResult (garbage), std::runtime_error);
+
+  // Memory-mapped archive.
+  const std::string filename = "serialization.bin";
+  {
+    ResultArchiveWriter writer (filename);
+    for (std::size_t i = 0; i < results.size (); ++i)
+      writer.append (results[i]);
+    BOOST_CHECK_EQUAL (writer.size (), results.size ());
+  }
+  {
+    ResultArchive archive (filename);
+    BOOST_REQUIRE_EQUAL (archive.size (), results.size ());
+
+    ResultView view = archive[0];
+    BOOST_CHECK_EQUAL (view.kind (), GenericSolver::SOLVER_VALUE);
+    BOOST_CHECK_EQUAL (view.x ()[1], 2.);
+    BOOST_CHECK_EQUAL (view.lambda ().size (), 3);
+    BOOST_CHECK_EQUAL
+      (reinterpret_cast<std::size_t> (view.x ().data ()) % 8, 0);
+
+    view = archive[1];
+    BOOST_CHECK_EQUAL (view.warnings (), 2);
+    BOOST_CHECK_EQUAL (view.warning (1), "second, longer, warning");
+
+    view = archive[2];
+    BOOST_CHECK (!view.hasResult ());
+    BOOST_CHECK_EQUAL (view.message (), "no last state");
+
+    view = archive[3];
+    BOOST_CHECK (view.hasResult ());
+    BOOST_CHECK_EQUAL (view.value ()[0], 3.);
+
+    (*output) << archive[3].result () << std::endl;
+    BOOST_CHECK_THROW (archive[5], std::runtime_error);
+  }
+  std::remove (filename.c_str ());
+
+  BOOST_CHECK_THROW (ResultArchive ("does-not-exist.bin"),
+		     std::runtime_error);
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
+
+BOOST_AUTO_TEST_CASE (serialization_invalid)
+{
+  std::vector<result_t> results = outcomes ();
+
+  std::stringstream ss (std::ios::in | std::ios::out | std::ios::binary);
+  writeResult (ss, results[1]);
+  const std::string data = ss.str ();
+
+  // Stream layout: file header (8 bytes), record size (8 bytes),
+  // then the record header.
+  const std::size_t sizeOffset = 8;
+  const std::size_t recordOffset = 16;
+
+  // Truncated stream.
+  {
+    std::stringstream truncated
+      (data.substr (0, data.size () / 2),
+       std::ios::in | std::ios::out | std::ios::binary);
+    BOOST_CHECK_THROW (readResult (truncated), std::runtime_error);
+  }
+
+  // Empty record.
+  {
+    std::string empty = data.substr (0, recordOffset);
+    patch (empty, sizeOffset, 0);
+    std::stringstream stream (empty, std::ios::in | std::ios::binary);
+    BOOST_CHECK_THROW (readResult (stream), std::runtime_error);
+  }
+
+  // Huge record size.
+  {
+    std::string huge = data;
+    patch (huge, sizeOffset, ~static_cast<boost::uint64_t> (0));
+    std::stringstream stream (huge, std::ios::in | std::ios::binary);
+    BOOST_CHECK_THROW (readResult (stream), std::runtime_error);
+  }
+
+  // Vector size whose byte size overflows.
+  {
+    std::string overflow = data;
+    patch (overflow, recordOffset + 24,
+	   (~static_cast<boost::uint64_t> (0) >> 3) + 2);
+    std::stringstream stream (overflow, std::ios::in | std::ios::binary);
+    BOOST_CHECK_THROW (readResult (stream), std::runtime_error);
+  }
+
+  // Warning length larger than the record.
+  {
+    std::string corrupted = data;
+    const std::size_t lastWarning = data.size () - 24 - 8;
+    patch (corrupted, lastWarning, ~static_cast<boost::uint64_t> (0) - 3);
+    std::stringstream stream (corrupted, std::ios::in | std::ios::binary);
+    BOOST_CHECK_THROW (readResult (stream), std::runtime_error);
+  }
+
+  const std::string filename = "serialization-invalid.bin";
+  {
+    ResultArchiveWriter writer (filename);
+    for (std::size_t i = 0; i < results.size (); ++i)
+      writer.append (results[i]);
+  }
+  const std::string archive = readFile (filename);
+
+  // Truncated archive.
+  writeFile (filename, archive.substr (0, archive.size () / 2));
+  BOOST_CHECK_THROW (ResultArchive (filename.c_str ()), std::runtime_error);
+
+  // Index entry pointing outside of the file. The footer holds the
+  // count, the index offset and the file header (24 bytes), it is
+  // preceded by count + 1 offsets.
+  const std::size_t index = archive.size () - 24 - (results.size () + 1) * 8;
+  std::string corrupted = archive;
+  patch (corrupted, index + 8, ~static_cast<boost::uint64_t> (0) - 7);
+  writeFile (filename, corrupted);
+  BOOST_CHECK_THROW (ResultArchive (filename.c_str ()), std::runtime_error);
+
+  // Huge record count.
+  corrupted = archive;
+  patch (corrupted, archive.size () - 24, ~static_cast<boost::uint64_t> (0));
+  writeFile (filename, corrupted);
+  BOOST_CHECK_THROW (ResultArchive (filename.c_str ()), std::runtime_error);
+
+  // Empty record.
+  corrupted = archive;
+  patch (corrupted, index + 8, 8);
+  writeFile (filename, corrupted);
+  BOOST_CHECK_THROW (ResultArchive (filename.c_str ()), std::runtime_error);
+
+  // The untouched archive is still valid.
+  writeFile (filename, archive);
+  ResultArchive valid (filename);
+  BOOST_CHECK_EQUAL (valid.size (), results.size ());
+  BOOST_CHECK_EQUAL (valid[1].warning (1), "second, longer, warning");
+
+  std::remove (filename.c_str ());
+}
@@ -0,0 +1,190 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+#include <boost/mpl/vector.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/constraints-evaluator.hh>
+#include <roboptim/core/numeric-linear-function.hh>
+#include <roboptim/core/problem.hh>
+#include <roboptim/core/sparse-numeric-linear-function.hh>
+
+using namespace roboptim;
+
+typedef Problem<LinearFunction, boost::mpl::vector<LinearFunction> >
+problem_t;
+
+typedef SparseNumericLinearFunction::sparseMatrix_t sparseMatrix_t;
+typedef Eigen::Triplet<Function::value_type> triplet_t;
+
+BOOST_AUTO_TEST_CASE (sparse_numeric_linear_function)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("sparse-numeric-linear-function");
+
+  NumericLinearFunction::matrix_t a (3, 5);
+  a <<
+    1., 0., 2., 0., 0.,
+    0., 0., 0., 0., 3.,
+    4., 5., 0., 0., 6.;
+  NumericLinearFunction::vector_t b (3);
+  b << 11., 2., 3.;
+
+  sparseMatrix_t sparseA = a.sparseView ();
+  NumericLinearFunction dense (a, b);
+  SparseNumericLinearFunction f (sparseA, b);
+
+  (*output) << f << std::endl;
+
+  Function::vector_t x (5);
+  x << 1., 2., 3., 4., 5.;
+
+  (*output) << "f(x) = " << f (x) << std::endl;
+  BOOST_CHECK (f (x) == dense (x));
+
+  for (Function::size_type i = 0; i < f.outputSize (); ++i)
+    {
+      (*output) << "G" << i << "(x) = " << f.gradient (x, i) << std::endl;
+      BOOST_CHECK (f.gradient (x, i) == dense.gradient (x, i));
+    }
+  BOOST_CHECK (f.jacobian (x) == dense.jacobian (x));
+  BOOST_CHECK_EQUAL (f.A ().nonZeros (), 6);
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
+
+// A large problem cannot be instantiated densely: only the value,
+// the gradients and the evaluator sparse jacobian are used.
+BOOST_AUTO_TEST_CASE (sparse_numeric_linear_function_large)
+{
+  const Function::size_type n = 100000;
+
+  // Second-order differences: x_{i-1} - 2 x_i + x_{i+1}.
+  std::vector<triplet_t> triplets;
+  for (Function::size_type i = 0; i < n; ++i)
+    {
+      if (i > 0)
+	triplets.push_back (triplet_t (i, i - 1, 1.));
+      triplets.push_back (triplet_t (i, i, -2.));
+      if (i < n - 1)
+	triplets.push_back (triplet_t (i, i + 1, 1.));
+    }
+  sparseMatrix_t a (n, n);
+  a.setFromTriplets (triplets.begin (), triplets.end ());
+  Function::vector_t b (n);
+  b.setConstant (1.);
+
+  boost::shared_ptr<SparseNumericLinearFunction> f =
+    boost::make_shared<SparseNumericLinearFunction> (a, b);
+
+  Function::vector_t x (n);
+  for (Function::size_type i = 0; i < n; ++i)
+    x[i] = static_cast<Function::value_type> (i);
+
+  // Linear x: inner differences vanish.
+  Function::vector_t value = (*f) (x);
+  BOOST_CHECK_EQUAL (value[0], 2.);
+  BOOST_CHECK_EQUAL (value[n / 2], 1.);
+  BOOST_CHECK_EQUAL (value[n - 1], 1. - static_cast<double> (n));
+
+  DifferentiableFunction::gradient_t gradient = f->gradient (x, n / 2);
+  BOOST_CHECK_EQUAL (gradient.sum (), 0.);
+  BOOST_CHECK_EQUAL (gradient[n / 2 - 1], 1.);
+  BOOST_CHECK_EQUAL (gradient[n / 2], -2.);
+  BOOST_CHECK_EQUAL (gradient[n / 2 + 1], 1.);
+
+  // The evaluator uses the sparse matrix directly.
+  problem_t pb (*f);
+  problem_t::intervals_t bounds (static_cast<std::size_t> (n),
+				 Function::makeLowerInterval (0.));
+  problem_t::scales_t scales (static_cast<std::size_t> (n), 1.);
+  pb.addConstraint (boost::static_pointer_cast<LinearFunction> (f),
+		    bounds, scales);
+
+  ConstraintsEvaluator<problem_t> evaluator (pb);
+  BOOST_CHECK_EQUAL (evaluator.outputSize (), n);
+  BOOST_CHECK_EQUAL (evaluator.linearJacobian ().nonZeros (), 3 * n - 2);
+
+  Function::vector_t values (n);
+  evaluator.computeConstraints (values, x);
+  BOOST_CHECK (values == value);
+
+  ConstraintsEvaluator<problem_t>::sparseJacobian_t jacobian;
+  evaluator.computeJacobian (jacobian, x);
+  BOOST_CHECK_EQUAL (jacobian.nonZeros (), 3 * n - 2);
+  BOOST_CHECK (jacobian.isApprox (evaluator.linearJacobian ()));
+}
+
+// Mixing sparse and dense linear constraints.
+BOOST_AUTO_TEST_CASE (sparse_numeric_linear_function_evaluator)
+{
+  NumericLinearFunction::matrix_t a (2, 3);
+  a <<
+    1., 0., 2.,
+    0., 3., 0.;
+  NumericLinearFunction::vector_t b (2);
+  b << 1., 2.;
+
+  boost::shared_ptr<LinearFunction> dense =
+    boost::make_shared<NumericLinearFunction> (a, b);
+  sparseMatrix_t sparseA = a.sparseView ();
+  boost::shared_ptr<LinearFunction> sparse =
+    boost::make_shared<SparseNumericLinearFunction> (sparseA, b);
+
+  NumericLinearFunction::matrix_t c (1, 3);
+  c << 0., 0., 0.;
+  NumericLinearFunction::vector_t d (1);
+  d << 0.;
+  problem_t pb (NumericLinearFunction (c, d));
+
+  problem_t::intervals_t bounds (2, Function::makeLowerInterval (0.));
+  problem_t::scales_t scales (2, 1.);
+  pb.addConstraint (sparse, bounds, scales);
+  pb.addConstraint (dense, bounds, scales);
+  pb.addConstraint (sparse, bounds, scales);
+
+  ConstraintsEvaluator<problem_t> evaluator (pb);
+
+  Function::vector_t x (3);
+  x << 1., 2., 3.;
+
+  DifferentiableFunction::jacobian_t jacobian (6, 3);
+  evaluator.computeJacobian (jacobian, x);
+  for (Function::size_type i = 0; i < 3; ++i)
+    BOOST_CHECK (jacobian.middleRows (2 * i, 2) == a);
+
+  ConstraintsEvaluator<problem_t>::sparseJacobian_t sparseJacobian;
+  evaluator.computeJacobian (sparseJacobian, x);
+  BOOST_CHECK (DifferentiableFunction::jacobian_t (sparseJacobian)
+	       == jacobian);
+
+  Function::vector_t values (6);
+  evaluator.computeConstraints (values, x);
+  for (Function::size_type i = 0; i < 3; ++i)
+    BOOST_CHECK (values.segment (2 * i, 2) == dense->operator () (x));
+
+  DifferentiableFunction::gradient_t gradient (3);
+  evaluator.computeGradient (gradient, x, 2, 0);
+  BOOST_CHECK (gradient == a.row (0).transpose ());
+}
@@ -24,6 +24,7 @@
 #include <roboptim/core/io.hh>
 #include <roboptim/core/differentiable-function.hh>
 #include <roboptim/core/util.hh>
+#include <roboptim/core/problem.hh>
 #include <roboptim/core/filter/split.hh>
 
 using namespace roboptim;
@@ -77,3 +78,86 @@ BOOST_AUTO_TEST_CASE (split)
   std::cout << output->str () << std::endl;
   BOOST_CHECK (output->match_pattern ());
 }
+
+struct G : public DifferentiableFunction
+{
+  G () : DifferentiableFunction (1, 10, "g_n (x) = n * x"),
+	 evaluations (0),
+	 jacobians (0)
+  {}
+
+  void impl_compute (result_t& res, const argument_t& argument) const throw ()
+  {
+    ++evaluations;
+    for (size_type i = 0; i < outputSize (); ++i)
+      res[i] = (value_type)i * argument[0];
+  }
+
+  void impl_jacobian (jacobian_t& jac, const argument_t&) const throw ()
+  {
+    ++jacobians;
+    for (size_type i = 0; i < outputSize (); ++i)
+      jac (i, 0) = (value_type)i;
+  }
+
+  void impl_gradient (gradient_t& grad, const argument_t&,
+		      size_type functionId) const throw ()
+  {
+    grad[0] = (value_type)functionId;
+  }
+
+  mutable int evaluations;
+  mutable int jacobians;
+};
+
+BOOST_AUTO_TEST_CASE (split_shared_context)
+{
+  typedef Problem<DifferentiableFunction,
+		  boost::mpl::vector<DifferentiableFunction> > problem_t;
+
+  boost::shared_ptr<G> g (new G ());
+  problem_t pb (*g);
+
+  std::vector<Function::interval_t> intervals
+    (10, Function::makeInfiniteInterval ());
+  addNonScalarConstraint
+    (pb, boost::static_pointer_cast<DifferentiableFunction> (g), intervals);
+  BOOST_CHECK_EQUAL (pb.constraints ().size (), 10u);
+
+  Function::vector_t x (1);
+  Function::vector_t gradient (1);
+  for (double i = 0.; i < 5.; i += 1.)
+    {
+      x[0] = i;
+      for (std::size_t id = 0; id < pb.constraints ().size (); ++id)
+	{
+	  boost::shared_ptr<DifferentiableFunction> c =
+	    boost::get<boost::shared_ptr<DifferentiableFunction> >
+	    (pb.constraints ()[id]);
+	  BOOST_CHECK_EQUAL ((*c) (x)[0], (double)id * i);
+	  c->gradient (gradient, x);
+	  BOOST_CHECK_EQUAL (gradient[0], (double)id);
+	}
+    }
+
+  // The constraint is evaluated once per point, not once per split.
+  BOOST_CHECK_EQUAL (g->evaluations, 5);
+  BOOST_CHECK_EQUAL (g->jacobians, 5);
+
+  // A standalone split does not compute the whole jacobian.
+  Split<DifferentiableFunction> split (g, 3);
+  split.gradient (gradient, x);
+  BOOST_CHECK_EQUAL (gradient[0], 3.);
+  BOOST_CHECK_EQUAL (g->jacobians, 5);
+
+  // A concurrent context behaves the same way.
+  boost::shared_ptr<SplitContext<DifferentiableFunction> > context
+    (new SplitContext<DifferentiableFunction> (g, true));
+  Split<DifferentiableFunction> concurrentSplit (context, 2);
+  x[0] = 7.;
+  BOOST_CHECK_EQUAL (concurrentSplit (x)[0], 14.);
+  concurrentSplit.gradient (gradient, x);
+  BOOST_CHECK_EQUAL (gradient[0], 2.);
+  BOOST_CHECK_EQUAL (g->evaluations, 6);
+  BOOST_CHECK_EQUAL (g->jacobians, 6);
+}
@@ -0,0 +1,131 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/banded-quadratic-function.hh>
+#include <roboptim/core/diagonal-quadratic-function.hh>
+#include <roboptim/core/low-rank-quadratic-function.hh>
+#include <roboptim/core/numeric-quadratic-function.hh>
+#include <roboptim/core/sparse-quadratic-function.hh>
+
+using namespace roboptim;
+
+typedef QuadraticFunction::matrix_t matrix_t;
+typedef QuadraticFunction::vector_t vector_t;
+
+namespace
+{
+  // Check a structured function against its dense counterpart.
+  void
+  checkAgainstDense (const QuadraticFunction& f, const matrix_t& a,
+		     const vector_t& b)
+  {
+    NumericQuadraticFunction dense (a, b);
+    for (int i = 0; i < 5; ++i)
+      {
+	vector_t x (b.size ());
+	for (QuadraticFunction::size_type j = 0; j < x.size (); ++j)
+	  x[j] = std::cos (1. + i + 3. * j);
+
+	BOOST_CHECK_SMALL (f (x)[0] - dense (x)[0], 1e-12);
+	BOOST_CHECK_SMALL ((f.gradient (x) - dense.gradient (x)).norm (),
+			   1e-12);
+	BOOST_CHECK_SMALL ((f.hessian (x) - dense.hessian (x)).norm (),
+			   1e-12);
+      }
+  }
+} // end of anonymous namespace.
+
+BOOST_AUTO_TEST_CASE (structured_quadratic_function)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("structured-quadratic-function");
+
+  const QuadraticFunction::size_type n = 6;
+  vector_t b (n);
+  b << 1., 2., 3., 4., 5., 6.;
+  vector_t d (n);
+  d << 2., 3., 4., 5., 6., 7.;
+  vector_t x = vector_t::Ones (n);
+
+  // Diagonal.
+  DiagonalQuadraticFunction diagonal (d, b);
+  matrix_t a = d.asDiagonal ();
+  checkAgainstDense (diagonal, a, b);
+  (*output) << diagonal << std::endl
+	    << "f(x) = " << diagonal (x) << std::endl;
+
+  // Banded (tridiagonal plus second sub-diagonal).
+  matrix_t bands (n, 3);
+  bands.col (0) = d;
+  bands.col (1) << -1., -.5, .5, 1., 1.5, 0.;
+  bands.col (2) << .25, .5, .75, 1., 0., 0.;
+  BandedQuadraticFunction banded (bands, b);
+  a.setZero ();
+  a.diagonal () = d;
+  a.diagonal (-1) = a.diagonal (1) = bands.col (1).head (n - 1);
+  a.diagonal (-2) = a.diagonal (2) = bands.col (2).head (n - 2);
+  checkAgainstDense (banded, a, b);
+  BOOST_CHECK_EQUAL (banded.bandwidth (), 2);
+  (*output) << "f(x) = " << banded (x) << std::endl;
+
+  // Sparse, only the lower part is read.
+  SparseQuadraticFunction::sparseMatrix_t sparse (n, n);
+  matrix_t lower = a.triangularView<Eigen::Lower> ();
+  sparse = lower.sparseView ();
+  SparseQuadraticFunction sparseFunction (sparse, b);
+  checkAgainstDense (sparseFunction, a, b);
+  (*output) << sparseFunction << std::endl
+	    << "f(x) = " << sparseFunction (x) << std::endl;
+
+  // Diagonal plus low-rank.
+  matrix_t u (n, 2);
+  u << 1., 0., 0., 1., 1., 1., -1., 0., 0., -1., .5, .5;
+  LowRankQuadraticFunction lowRank (d, u, b);
+  a = u * u.transpose ();
+  a.diagonal () += d;
+  checkAgainstDense (lowRank, a, b);
+  (*output) << "f(x) = " << lowRank (x) << std::endl;
+
+  // Dense: only the lower part is read too, and mirrored.
+  matrix_t lowerPart = a.triangularView<Eigen::Lower> ();
+  NumericQuadraticFunction dense (lowerPart, b);
+  BOOST_CHECK_SMALL (dense (x)[0] - lowRank (x)[0], 1e-12);
+  BOOST_CHECK (dense.A () == a);
+  BOOST_CHECK (dense.hessian (x) == a);
+
+  // Large banded function, no dense matrix is ever formed.
+  const QuadraticFunction::size_type large = 10000;
+  matrix_t largeBands = matrix_t::Zero (large, 2);
+  largeBands.col (0).setConstant (2.);
+  largeBands.col (1).setConstant (-1.);
+  BandedQuadraticFunction laplacian (largeBands, vector_t::Zero (large));
+  vector_t ones = vector_t::Ones (large);
+  // x^T A x = 2 n - 2 (n - 1) = 2 for the discrete Laplacian.
+  BOOST_CHECK_SMALL (laplacian (ones)[0] - 1., 1e-9);
+  vector_t gradient = laplacian.gradient (ones);
+  BOOST_CHECK_SMALL (gradient.segment (1, large - 2).norm (), 1e-12);
+  BOOST_CHECK_SMALL (gradient[0] - 1., 1e-12);
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
@@ -0,0 +1,141 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "shared-tests/common.hh"
+
+#include <cmath>
+#include <iostream>
+
+#include <roboptim/core/finite-difference-gradient.hh>
+#include <roboptim/core/io.hh>
+#include <roboptim/core/numeric-linear-function.hh>
+#include <roboptim/core/sum-of-c1-squares.hh>
+#include <roboptim/core/util.hh>
+
+using namespace roboptim;
+
+// r(x) = (x0^2 - x1, sin (x0) x1, x0 + 2 x1)
+struct Residuals : public DifferentiableFunction
+{
+  Residuals ()
+    : DifferentiableFunction (2, 3, "residuals"),
+      gradients (0),
+      jacobians (0)
+  {}
+
+  void impl_compute (result_t& result, const argument_t& x)
+    const throw ()
+  {
+    result[0] = x[0] * x[0] - x[1];
+    result[1] = std::sin (x[0]) * x[1];
+    result[2] = x[0] + 2. * x[1];
+  }
+
+  void impl_gradient (gradient_t& gradient, const argument_t& x,
+		      size_type i) const throw ()
+  {
+    ++gradients;
+    gradient = jacobian (x).row (i);
+  }
+
+  void impl_jacobian (jacobian_t& jacobian, const argument_t& x)
+    const throw ()
+  {
+    ++jacobians;
+    jacobian << 2. * x[0], -1.,
+      std::cos (x[0]) * x[1], std::sin (x[0]),
+      1., 2.;
+  }
+
+  mutable unsigned gradients;
+  mutable unsigned jacobians;
+};
+
+BOOST_AUTO_TEST_CASE (sum_of_c1_squares)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("sum-of-c1-squares");
+
+  boost::shared_ptr<Residuals> residuals (new Residuals ());
+  SumOfC1Squares f (residuals, "sum of squares");
+
+  Function::vector_t x (2);
+  x << 1., 2.;
+
+  Function::vector_t value = f (x);
+  Function::vector_t gradient = f.gradient (x);
+  (*output) << "Value: " << value << std::endl
+	    << "Gradient: " << gradient << std::endl;
+
+  // One jacobian evaluation, no gradient evaluation.
+  BOOST_CHECK_EQUAL (residuals->gradients, 0);
+  BOOST_CHECK_EQUAL (residuals->jacobians, 1);
+
+  // The jacobian is cached.
+  f.gradient (x);
+  BOOST_CHECK_EQUAL (residuals->jacobians, 1);
+
+  // Gradient is 2 J^T r.
+  Function::vector_t r = (*residuals) (x);
+  DifferentiableFunction::jacobian_t jacobian = residuals->jacobian (x);
+  Function::vector_t expected = 2. * jacobian.transpose () * r;
+  BOOST_CHECK_SMALL ((f.gradient (x) - expected).norm (), 1e-12);
+
+  // Gauss-Newton hessian is 2 J^T J, computed from the cached jacobian.
+  TwiceDifferentiableFunction::hessian_t hessian = f.hessian (x);
+  BOOST_CHECK_EQUAL (residuals->jacobians, 2);
+  TwiceDifferentiableFunction::hessian_t expectedHessian =
+    2. * jacobian.transpose () * jacobian;
+  BOOST_CHECK_SMALL ((hessian - expectedHessian).norm (), 1e-12);
+  BOOST_CHECK_SMALL ((hessian - hessian.transpose ()).norm (), 1e-12);
+  (*output) << "Hessian: " << hessian << std::endl;
+
+  // The hessian is cached as well.
+  f.hessian (x);
+  BOOST_CHECK_EQUAL (residuals->jacobians, 2);
+
+  for (unsigned i = 0; i < 10; ++i)
+    {
+      x << std::cos (i), std::sin (2. * i);
+      BOOST_CHECK (checkGradient (f, 0, x));
+    }
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}
+
+BOOST_AUTO_TEST_CASE (sum_of_c1_squares_large)
+{
+  // Large enough for the rank update to use a heap workspace.
+  NumericLinearFunction::matrix_t a =
+    NumericLinearFunction::matrix_t::Random (300, 100);
+  NumericLinearFunction::vector_t b =
+    NumericLinearFunction::vector_t::Random (300);
+  boost::shared_ptr<NumericLinearFunction> residuals
+    (new NumericLinearFunction (a, b));
+  SumOfC1Squares f (residuals, "sum of squares");
+
+  Function::vector_t x = Function::vector_t::Random (100);
+  Function::vector_t gradient (100);
+  TwiceDifferentiableFunction::hessian_t hessian (100, 100);
+
+  // The hessian is computed from the jacobian cached by the gradient.
+  f.gradient (gradient, x, 0);
+  f.hessian (hessian, x, 0);
+  BOOST_CHECK_SMALL ((hessian - 2. * a.transpose () * a).norm (), 1e-9);
+}
@@ -0,0 +1,114 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "shared-tests/common.hh"
+
+#include <vector>
+
+#include <boost/bind.hpp>
+
+#include <roboptim/core/thread-pool.hh>
+
+using namespace roboptim;
+
+// Sum the values in [begin, end) by recursive splitting: the halves
+// are submitted from the workers, on their own deques, and stolen by
+// the idle ones.
+void sum (ThreadPool* pool, const std::vector<int>* values,
+	  std::size_t begin, std::size_t end, long* result)
+{
+  if (end - begin <= 16)
+    {
+      *result = 0;
+      for (std::size_t i = begin; i < end; ++i)
+	*result += (*values)[i];
+      return;
+    }
+
+  const std::size_t middle = begin + (end - begin) / 2;
+  long left = 0;
+  long right = 0;
+  TaskGroup group (*pool);
+  group.submit (boost::bind (&sum, pool, values, begin, middle, &left));
+  group.submit (boost::bind (&sum, pool, values, middle, end, &right));
+  group.wait ();
+  *result = left + right;
+}
+
+void increment (boost::mutex* mutex, int* counter)
+{
+  boost::mutex::scoped_lock lock (*mutex);
+  ++*counter;
+}
+
+void record (boost::mutex* mutex, std::vector<int>* order, int i)
+{
+  boost::mutex::scoped_lock lock (*mutex);
+  order->push_back (i);
+}
+
+BOOST_AUTO_TEST_CASE (thread_pool)
+{
+  ThreadPool pool (4);
+  BOOST_CHECK_EQUAL (pool.size (), 4);
+
+  // Tasks submitted from outside are spread over the workers.
+  boost::mutex mutex;
+  int counter = 0;
+  for (int i = 0; i < 1000; ++i)
+    pool.submit (boost::bind (&increment, &mutex, &counter));
+  pool.wait ();
+  BOOST_CHECK_EQUAL (counter, 1000);
+
+  // Nested groups, submitted from the workers.
+  std::vector<int> values (10000);
+  for (std::size_t i = 0; i < values.size (); ++i)
+    values[i] = static_cast<int> (i);
+  long result = 0;
+  TaskGroup group (pool);
+  group.submit
+    (boost::bind (&sum, &pool, &values, 0, values.size (), &result));
+  group.wait ();
+  BOOST_CHECK_EQUAL (result, 10000L * 9999L / 2L);
+
+  // Batches are dealt over the workers.
+  std::vector<ThreadPool::task_t> batch
+    (1000, boost::bind (&increment, &mutex, &counter));
+  counter = 0;
+  TaskGroup batchGroup (pool);
+  batchGroup.submit (batch);
+  batchGroup.wait ();
+  BOOST_CHECK_EQUAL (counter, 1000);
+}
+
+BOOST_AUTO_TEST_CASE (thread_pool_batch_order)
+{
+  // A single worker executes a batch in order.
+  ThreadPool pool (1);
+  boost::mutex mutex;
+  std::vector<int> order;
+  std::vector<ThreadPool::task_t> batch;
+  for (int i = 0; i < 10; ++i)
+    batch.push_back (boost::bind (&record, &mutex, &order, i));
+  pool.submit (batch);
+  pool.wait ();
+
+  BOOST_REQUIRE_EQUAL (order.size (), 10);
+  for (int i = 0; i < 10; ++i)
+    BOOST_CHECK_EQUAL (order[i], i);
+}
@@ -0,0 +1,86 @@
+// Copyright (C) 2013 by Thomas Moulard, AIST, CNRS, INRIA.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "shared-tests/common.hh"
+
+#include <iostream>
+
+#include <boost/mpl/vector.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/solver-factory.hh>
+#include <roboptim/core/warm-start.hh>
+
+using namespace roboptim;
+
+typedef Solver<Function, boost::mpl::vector<Function> > solver_t;
+
+struct F : public Function
+{
+  F () : Function (1, 1, "x")
+  {}
+
+  void impl_compute (result_t& result, const argument_t& argument)
+    const throw ()
+  {
+    result (0) = argument[0];
+  }
+};
+
+BOOST_AUTO_TEST_CASE (warm_start)
+{
+  boost::shared_ptr<boost::test_tools::output_test_stream>
+    output = retrievePattern ("warm-start");
+
+  F f;
+  solver_t::problem_t pb (f);
+
+  SolverFactory<solver_t> factory ("dummy-laststate", pb);
+  solver_t& solver = factory ();
+  BOOST_CHECK (!solver.warmStart ());
+
+  // The solver fails but its last state can be reused.
+  BOOST_CHECK (solver.setWarmStart (solver.minimum ()));
+  BOOST_CHECK (solver.warmStart ());
+  (*output) << *solver.warmStart () << std::endl;
+
+  // The warm start survives a reset.
+  solver.reset ();
+  BOOST_CHECK (solver.warmStart ());
+
+  // Without solution, there is nothing to start from.
+  solver_t::result_t noSolution = NoSolution ();
+  BOOST_CHECK (!solver.setWarmStart (noSolution));
+
+  // Optional data.
+  WarmStart warmStart (2);
+  warmStart.x[0] = 1.;
+  warmStart.lambda = WarmStart::vector_t::Ones (3);
+  warmStart.activeSet = WarmStart::activeSet_t ();
+  warmStart.activeSet->push_back (0);
+  warmStart.activeSet->push_back (2);
+  warmStart.hessian = WarmStart::matrix_t::Identity (2, 2);
+  solver.setWarmStart (warmStart);
+  (*output) << *solver.warmStart () << std::endl;
+
+  solver.resetWarmStart ();
+  BOOST_CHECK (!solver.warmStart ());
+
+  std::cout << output->str () << std::endl;
+  BOOST_CHECK (output->match_pattern ());
+}